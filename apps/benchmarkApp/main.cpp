@@ -0,0 +1,379 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//
+// Microbenchmarks for the faux RTOS queue variants and the
+// HwLockCtrlService event path. Each result is printed as one
+// JSON object per line, for example:
+//
+//   {"benchmark":"queue_1to1","mode":"spsc","threads":2,"ops":200000,
+//    "seconds":0.0312,"ops_per_sec":6410256,"p50_ns":...,"max_ns":...}
+//
+// usage: benchmarkApp [operations] [name filter]
+// note: configure with -DCMAKE_BUILD_TYPE=Release for meaningful numbers.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "fauxQueue.h"
+#include "fauxScheduler.h"
+#include "fauxTrace.h"
+#include "hwLockCtrlService.h"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchEvent
+{
+    uint64_t sentNs;
+    uint32_t signal;
+    uint32_t producer;
+};
+
+struct ModeInfo
+{
+    QueueModeT mode;
+    const char* name;
+};
+
+constexpr ModeInfo AllModes[] = {
+  { QUEUE_MODE_STANDARD, "standard" },
+  { QUEUE_MODE_SPSC, "spsc" },
+  { QUEUE_MODE_MPSC, "mpsc" }
+};
+
+constexpr ModeInfo MultiProducerModes[] = {
+  { QUEUE_MODE_STANDARD, "standard" },
+  { QUEUE_MODE_MPSC, "mpsc" }
+};
+
+constexpr size_t BenchQueueDepth = 256;
+constexpr size_t BatchSize = 32;
+constexpr uint32_t ProducerCount = 4;
+constexpr uint32_t UrgentInterval = 4;
+constexpr uint32_t HlcsRoundTripDivisor = 10;
+
+size_t s_operations = 200000;
+std::string s_filter;
+
+uint64_t NowNs()
+{
+    return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+}
+
+bool Selected(const char* benchmark)
+{
+    return s_filter.empty() || (std::string(benchmark).find(s_filter) != std::string::npos);
+}
+
+uint64_t Percentile(const std::vector<uint64_t>& sorted, double percentile)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+
+    auto index = static_cast<size_t>((percentile / 100.0) * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+
+void Report(const char* benchmark, const char* mode, uint32_t threads, double seconds,
+            std::vector<uint64_t>& latencies)
+{
+    std::sort(latencies.begin(), latencies.end());
+    size_t ops = latencies.size();
+    double opsPerSec = (seconds > 0.0) ? (static_cast<double>(ops) / seconds) : 0.0;
+
+    printf("{\"benchmark\":\"%s\",\"mode\":\"%s\",\"threads\":%" PRIu32 ",\"ops\":%zu,"
+           "\"seconds\":%.6f,\"ops_per_sec\":%.0f,"
+           "\"p50_ns\":%" PRIu64 ",\"p90_ns\":%" PRIu64 ",\"p99_ns\":%" PRIu64 ","
+           "\"p999_ns\":%" PRIu64 ",\"max_ns\":%" PRIu64 "}\n",
+           benchmark, mode, threads, ops, seconds, opsPerSec,
+           Percentile(latencies, 50.0), Percentile(latencies, 90.0), Percentile(latencies, 99.0),
+           Percentile(latencies, 99.9), latencies.empty() ? 0 : latencies.back());
+    fflush(stdout);
+}
+
+void Send(QueueHandle_t queue, uint32_t signal, uint32_t producer, bool urgent)
+{
+    BenchEvent event = { NowNs(), signal, producer };
+    bool ok = urgent ? xQueueSendToFrontTimed(queue, &event, portMAX_DELAY) :
+                       xQueueSendToBackTimed(queue, &event, portMAX_DELAY);
+    if (!ok)
+    {
+        fprintf(stderr, "benchmark send failed\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * @brief send to receive latency and throughput. Each of the
+ *        producers sends operations / producers events, the
+ *        calling thread receives, optionally in batches.
+ */
+void RunStream(const char* benchmark, const ModeInfo& mode, uint32_t producers, bool batch, bool urgentMix)
+{
+    QueueHandle_t queue = xQueueCreateWithMode(BenchQueueDepth, sizeof(BenchEvent), mode.mode);
+    size_t perProducer = s_operations / producers;
+    size_t total = perProducer * producers;
+    std::vector<uint64_t> latencies;
+    latencies.reserve(total);
+
+    auto start = Clock::now();
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([=]() {
+            for (size_t i = 0; i < perProducer; ++i)
+            {
+                bool urgent = urgentMix && ((i % UrgentInterval) == 0);
+                Send(queue, static_cast<uint32_t>(i), p, urgent);
+            }
+        });
+    }
+
+    BenchEvent events[BatchSize];
+    while (latencies.size() < total)
+    {
+        size_t received = 0;
+        if (batch)
+        {
+            xQueueReceiveBatch(queue, events, BatchSize, &received);
+        }
+        else
+        {
+            received = xQueueReceive(queue, &events[0]) ? 1 : 0;
+        }
+
+        uint64_t now = NowNs();
+        for (size_t i = 0; i < received; ++i)
+        {
+            latencies.push_back(now - events[i].sentNs);
+        }
+    }
+    auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    vQueueDelete(queue);
+    Report(benchmark, mode.name, producers + 1, seconds, latencies);
+}
+
+/**
+ * @brief round trip latency between two threads, each
+ *        owning the receive side of one queue.
+ */
+void RunPingPong(const ModeInfo& mode)
+{
+    QueueHandle_t ping = xQueueCreateWithMode(BenchQueueDepth, sizeof(BenchEvent), mode.mode);
+    QueueHandle_t pong = xQueueCreateWithMode(BenchQueueDepth, sizeof(BenchEvent), mode.mode);
+    std::vector<uint64_t> latencies;
+    latencies.reserve(s_operations);
+
+    std::thread echo([=]() {
+        BenchEvent event;
+        for (size_t i = 0; i < s_operations; ++i)
+        {
+            xQueueReceive(ping, &event);
+            xQueueSendToBackTimed(pong, &event, portMAX_DELAY);
+        }
+    });
+
+    auto start = Clock::now();
+    BenchEvent event;
+    for (size_t i = 0; i < s_operations; ++i)
+    {
+        Send(ping, static_cast<uint32_t>(i), 0, false);
+        xQueueReceive(pong, &event);
+        latencies.push_back(NowNs() - event.sentNs);
+    }
+    auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    echo.join();
+    vQueueDelete(ping);
+    vQueueDelete(pong);
+    Report("queue_ping_pong", mode.name, 2, seconds, latencies);
+}
+
+std::atomic<uint32_t> s_hlcsCallbacks(0);
+
+void HlcsStateChanged(HLCS_LockStateT state)
+{
+    (void)state;
+    s_hlcsCallbacks.fetch_add(1, std::memory_order_release);
+}
+
+void WaitForHlcsCallbacks(uint32_t expected)
+{
+    while (s_hlcsCallbacks.load(std::memory_order_acquire) < expected)
+    {
+        std::this_thread::yield();
+    }
+}
+
+/**
+ * @brief HLCS_RequestLockedAsync() or HLCS_RequestUnlockedAsync()
+ *        to state changed callback latency, using a no-op driver.
+ */
+void RunHlcsEndToEnd(ExecutionOptionT option, const char* modeName)
+{
+    size_t roundTrips = std::max<size_t>(s_operations / HlcsRoundTripDivisor, 1);
+    std::vector<uint64_t> latencies;
+    latencies.reserve(roundTrips);
+
+    if (option == EXECUTION_OPTION_SHARED_SCHEDULER)
+    {
+        xSchedulerStart(1, nullptr);
+    }
+
+    s_hlcsCallbacks = 0;
+    HLCS_Init();
+    HLCS_RegisterChangeStateCallback(HlcsStateChanged);
+    HLCS_Start(option);
+
+    //the initial transition reports the locked state
+    WaitForHlcsCallbacks(1);
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < roundTrips; ++i)
+    {
+        uint64_t sent = NowNs();
+        if ((i % 2) == 0)
+        {
+            HLCS_RequestUnlockedAsync();
+        }
+        else
+        {
+            HLCS_RequestLockedAsync();
+        }
+        WaitForHlcsCallbacks(static_cast<uint32_t>(i + 2));
+        latencies.push_back(NowNs() - sent);
+    }
+    auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    HLCS_Destroy();
+    if (option == EXECUTION_OPTION_SHARED_SCHEDULER)
+    {
+        vSchedulerStop();
+    }
+
+    Report("hlcs_end_to_end", modeName, 2, seconds, latencies);
+}
+
+/**
+ * @brief RunTraceRecord - the cost of a single trace point, too short
+ *        to time individually, so only the average is reported.
+ */
+void RunTraceRecord(bool enabled)
+{
+    vTraceEnable(enabled);
+    auto start = Clock::now();
+    for (size_t i = 0; i < s_operations; ++i)
+    {
+        vTraceRecord(TRACE_EVENT_USER, nullptr, static_cast<uint32_t>(i), 0, 0);
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    vTraceEnable(false);
+    vTraceClear();
+
+    printf("{\"benchmark\":\"trace_record\",\"mode\":\"%s\",\"threads\":1,\"ops\":%zu,"
+           "\"seconds\":%.6f,\"ops_per_sec\":%.0f,\"mean_ns\":%.2f}\n",
+           enabled ? "enabled" : "disabled", s_operations, seconds,
+           static_cast<double>(s_operations) / seconds, (seconds * 1e9) / static_cast<double>(s_operations));
+    fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1)
+    {
+        s_operations = std::max<size_t>(strtoul(argv[1], nullptr, 10), ProducerCount);
+    }
+
+    if (argc > 2)
+    {
+        s_filter = argv[2];
+    }
+
+    for (const auto& mode : AllModes)
+    {
+        if (Selected("queue_1to1"))
+        {
+            RunStream("queue_1to1", mode, 1, false, false);
+        }
+
+        if (Selected("queue_1to1_batch"))
+        {
+            RunStream("queue_1to1_batch", mode, 1, true, false);
+        }
+
+        if (Selected("queue_ping_pong"))
+        {
+            RunPingPong(mode);
+        }
+    }
+
+    for (const auto& mode : MultiProducerModes)
+    {
+        if (Selected("queue_nto1"))
+        {
+            RunStream("queue_nto1", mode, ProducerCount, false, false);
+        }
+    }
+
+    //only the standard queue supports urgent (front) insertion
+    if (Selected("queue_urgent_mix"))
+    {
+        RunStream("queue_urgent_mix", AllModes[0], 1, false, true);
+    }
+
+    if (Selected("hlcs_end_to_end"))
+    {
+        RunHlcsEndToEnd(EXECUTION_OPTION_NORMAL, "thread");
+        RunHlcsEndToEnd(EXECUTION_OPTION_SHARED_SCHEDULER, "scheduler");
+    }
+
+    if (Selected("trace_record"))
+    {
+        RunTraceRecord(false);
+        RunTraceRecord(true);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,102 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//
+// A no-op hwLockCtrl driver, so the benchmark measures only
+// the service's event path, not the driver's console output.
+//
+
+#include "hwLockCtrl.h"
+#include <stddef.h>
+
+bool HwLockCtrlInit()
+{
+    return HwLockCtrlInitById(HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+}
+
+bool HwLockCtrlLock()
+{
+    return HwLockCtrlLockById(HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+}
+
+bool HwLockCtrlUnlock()
+{
+    return HwLockCtrlUnlockById(HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+}
+
+bool HwLockCtrlSelfTest(HwLockCtrlSelfTestResultT* outResult)
+{
+    return HwLockCtrlSelfTestById(HW_LOCK_CTRL_DEFAULT_LOCK_ID, outResult);
+}
+
+bool HwLockCtrlInitById(HwLockIdT lockId)
+{
+    (void)lockId;
+    return true;
+}
+
+bool HwLockCtrlLockById(HwLockIdT lockId)
+{
+    (void)lockId;
+    return true;
+}
+
+bool HwLockCtrlUnlockById(HwLockIdT lockId)
+{
+    (void)lockId;
+    return true;
+}
+
+bool HwLockCtrlSelfTestById(HwLockIdT lockId, HwLockCtrlSelfTestResultT* outResult)
+{
+    (void)lockId;
+    if (outResult == NULL)
+    {
+        return false;
+    }
+
+    *outResult = HW_LOCK_CTRL_SELF_TEST_PASSED;
+    return true;
+}
+
+bool HwLockCtrlLockAsync(HwLockIdT lockId, HwLockCtrlCompletionCallback callback, void* context)
+{
+    HwLockCtrlCompletionT completion = { lockId, HW_LOCK_CTRL_OPERATION_LOCK, true, HW_LOCK_CTRL_SELF_TEST_PASSED };
+    callback(context, &completion);
+    return true;
+}
+
+bool HwLockCtrlUnlockAsync(HwLockIdT lockId, HwLockCtrlCompletionCallback callback, void* context)
+{
+    HwLockCtrlCompletionT completion = { lockId, HW_LOCK_CTRL_OPERATION_UNLOCK, true, HW_LOCK_CTRL_SELF_TEST_PASSED };
+    callback(context, &completion);
+    return true;
+}
+
+bool HwLockCtrlSelfTestAsync(HwLockIdT lockId, HwLockCtrlCompletionCallback callback, void* context)
+{
+    HwLockCtrlCompletionT completion = { lockId, HW_LOCK_CTRL_OPERATION_SELF_TEST, true, HW_LOCK_CTRL_SELF_TEST_PASSED };
+    callback(context, &completion);
+    return true;
+}
@@ -1,5 +1,7 @@
 #include <iostream>
 #include "hwLockCtrlService.h"
+#include "fauxTrace.h"
+#include "fauxTimer.h"
 #include <string>
 
 static HLCS_LockStateT s_lastState = HLCS_LOCK_STATE_UNKNOWN;
@@ -68,11 +70,27 @@ DesiredAction GetUserAction()
     }
 }
 
-int main()
+/**
+ * usage: demoPcApp [trace file]
+ *        with a trace file, tracing is enabled and the binary trace
+ *        is written on exit, see traceDumpApp to view it.
+ */
+int main(int argc, char* argv[])
 {
+    const char* tracePath = (argc > 1) ? argv[1] : nullptr;
+    if (tracePath != nullptr)
+    {
+        vTraceEnable(true);
+    }
+
+    //bounds each driver operation, see HLCS_ConfigT operationTimeoutMs
+    xTimerServiceStart(TIMER_CLOCK_REAL);
     HLCS_Init();
     HLCS_RegisterChangeStateCallback(LockStateChangeCallback);
     HLCS_RegisterSelfTestResultCallback(SelfTestResultCallback);
+
+    //the callbacks block on console output, keep them off the service thread
+    HLCS_SetCallbackDelivery(HLCS_DELIVERY_DISPATCHER);
     HLCS_Start(EXECUTION_OPTION_NORMAL);
 
     while (true)
@@ -90,6 +108,12 @@ int main()
             break;
         default:
             HLCS_Destroy();
+            vTimerServiceStop();
+            if ((tracePath != nullptr) && !xTraceWriteFile(tracePath))
+            {
+                std::cout << "Failed to write trace file: " << tracePath << std::endl;
+                return 1;
+            }
             return 0;
         }
     }
@@ -0,0 +1,335 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//
+// Open loop load test of a HwLockCtrlService instance driving the
+// simulated hwLockCtrl driver. Requests are posted at a fixed interval,
+// whatever the driver's latency, alternating unlock and lock requests,
+// with a self test request every SelfTestInterval requests. Each
+// scenario is printed as one JSON object per line, for example:
+//
+//   {"scenario":"slow","requests":2000,"interval_us":500,"state_changes":...,
+//    "superseded":...,"p50_us":...,"max_us":...,"queue_high_water":...}
+//
+// End to end latency runs from the first request for a state, not yet
+// reached, to the state changed callback reporting that state. A
+// request for the opposite state supersedes it, and is not measured.
+//
+// usage: loadTestApp [requests] [interval us] [scenario filter]
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "fauxQueue.h"
+#include "fauxTimer.h"
+#include "hwLockCtrlService.h"
+#include "hwLockCtrlSim.h"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t LoadTestLockId = 1;
+constexpr size_t SelfTestInterval = 16;
+constexpr auto DrainTimeout = std::chrono::seconds(10);
+constexpr uint64_t Seed = 2021;
+
+struct Scenario
+{
+    const char* name;
+    HwLockCtrlSimProfileT lockProfile;    //lock and unlock
+    HwLockCtrlSimProfileT selfTestProfile;
+    double powerFailureRate;
+    double motorFailureRate;
+};
+
+constexpr Scenario Scenarios[] = {
+  { "ideal",
+    { HW_LOCK_CTRL_SIM_LATENCY_FIXED, 0, 0, 0, 0.0 },
+    { HW_LOCK_CTRL_SIM_LATENCY_FIXED, 0, 0, 0, 0.0 },
+    0.0, 0.0 },
+  { "slow",
+    { HW_LOCK_CTRL_SIM_LATENCY_EXPONENTIAL, 500, 1500, 20000, 0.0 },
+    { HW_LOCK_CTRL_SIM_LATENCY_FIXED, 20000, 0, 0, 0.0 },
+    0.0, 0.0 },
+  { "flaky",
+    { HW_LOCK_CTRL_SIM_LATENCY_UNIFORM, 200, 0, 2000, 0.05 },
+    { HW_LOCK_CTRL_SIM_LATENCY_UNIFORM, 5000, 0, 30000, 0.02 },
+    0.05, 0.05 }
+};
+
+size_t s_requests = 2000;
+uint32_t s_intervalUs = 500;
+std::string s_filter;
+
+uint64_t NowNs()
+{
+    return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+}
+
+uint64_t Percentile(const std::vector<uint64_t>& sorted, double percentile)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+
+    auto index = static_cast<size_t>((percentile / 100.0) * static_cast<double>(sorted.size() - 1));
+    return sorted[index];
+}
+
+/**
+ * @brief LoadObserver - the service callbacks, on the service thread,
+ *        matched against the requests posted by the load thread.
+ */
+struct LoadObserver
+{
+    //send time of the oldest unsatisfied request, per HLCS_LockStateT, 0: none
+    std::atomic<uint64_t> pendingSinceNs[HLCS_LOCK_STATE_UNLOCKED + 1] = {};
+    std::atomic<uint64_t> selfTestPendingSinceNs{0};
+    std::atomic<uint64_t> stateChanges{0};
+    std::atomic<uint64_t> stateFailures{0};   //changes to HLCS_LOCK_STATE_UNKNOWN
+    std::atomic<uint64_t> selfTestResults{0};
+    std::atomic<uint64_t> selfTestFailures{0};
+    uint64_t superseded = 0; //load thread only
+    std::vector<uint64_t> latencies;          //service thread only, until deleted
+    std::vector<uint64_t> selfTestLatencies;  //service thread only, until deleted
+};
+
+void OnStateChanged(void* context, HLCS_Handle handle, HLCS_LockStateT state)
+{
+    (void)handle;
+    auto observer = static_cast<LoadObserver*>(context);
+    if (state == HLCS_LOCK_STATE_UNKNOWN)
+    {
+        //a failed operation answers the outstanding requests, unmeasured
+        observer->pendingSinceNs[HLCS_LOCK_STATE_LOCKED].store(0, std::memory_order_release);
+        observer->pendingSinceNs[HLCS_LOCK_STATE_UNLOCKED].store(0, std::memory_order_release);
+        observer->stateFailures.fetch_add(1, std::memory_order_relaxed);
+    }
+    uint64_t since = observer->pendingSinceNs[state].exchange(0, std::memory_order_acq_rel);
+    if (since != 0)
+    {
+        observer->latencies.push_back(NowNs() - since);
+    }
+    observer->stateChanges.fetch_add(1, std::memory_order_release);
+}
+
+void OnSelfTestResult(void* context, HLCS_Handle handle, HLCS_SelfTestResultT result)
+{
+    (void)handle;
+    auto observer = static_cast<LoadObserver*>(context);
+    uint64_t since = observer->selfTestPendingSinceNs.exchange(0, std::memory_order_acq_rel);
+    if (since != 0)
+    {
+        observer->selfTestLatencies.push_back(NowNs() - since);
+    }
+    if (result != HLCS_SELF_TEST_RESULT_PASS)
+    {
+        observer->selfTestFailures.fetch_add(1, std::memory_order_relaxed);
+    }
+    observer->selfTestResults.fetch_add(1, std::memory_order_release);
+}
+
+void RequestState(HLCS_Handle handle, LoadObserver& observer, HLCS_LockStateT state)
+{
+    HLCS_LockStateT opposite = (state == HLCS_LOCK_STATE_LOCKED) ? HLCS_LOCK_STATE_UNLOCKED : HLCS_LOCK_STATE_LOCKED;
+    uint64_t none = 0;
+    observer.pendingSinceNs[state].compare_exchange_strong(none, NowNs(), std::memory_order_acq_rel);
+    if (observer.pendingSinceNs[opposite].exchange(0, std::memory_order_acq_rel) != 0)
+    {
+        ++observer.superseded;
+    }
+
+    if (state == HLCS_LOCK_STATE_LOCKED)
+    {
+        HLCS_InstanceRequestLockedAsync(handle);
+    }
+    else
+    {
+        HLCS_InstanceRequestUnlockedAsync(handle);
+    }
+}
+
+void RequestSelfTest(HLCS_Handle handle, LoadObserver& observer)
+{
+    uint64_t none = 0;
+    observer.selfTestPendingSinceNs.compare_exchange_strong(none, NowNs(), std::memory_order_acq_rel);
+    HLCS_InstanceRequestSelfTestAsync(handle);
+}
+
+bool Unsatisfied(const LoadObserver& observer)
+{
+    return (observer.pendingSinceNs[HLCS_LOCK_STATE_LOCKED].load(std::memory_order_acquire) != 0) ||
+           (observer.pendingSinceNs[HLCS_LOCK_STATE_UNLOCKED].load(std::memory_order_acquire) != 0) ||
+           (observer.selfTestPendingSinceNs.load(std::memory_order_acquire) != 0);
+}
+
+void RunScenario(const Scenario& scenario)
+{
+    HwLockCtrlSimReset();
+    HwLockCtrlSimSeed(Seed);
+    bool configured = HwLockCtrlSimSetProfile(HW_LOCK_CTRL_OPERATION_LOCK, &scenario.lockProfile) &&
+                      HwLockCtrlSimSetProfile(HW_LOCK_CTRL_OPERATION_UNLOCK, &scenario.lockProfile) &&
+                      HwLockCtrlSimSetProfile(HW_LOCK_CTRL_OPERATION_SELF_TEST, &scenario.selfTestProfile) &&
+                      HwLockCtrlSimSetSelfTestFailureRates(scenario.powerFailureRate, scenario.motorFailureRate);
+    if (!configured)
+    {
+        fprintf(stderr, "scenario %s: bad simulator settings\n", scenario.name);
+        return;
+    }
+
+    LoadObserver observer;
+    observer.latencies.reserve(s_requests);
+    observer.selfTestLatencies.reserve(s_requests / SelfTestInterval + 1);
+
+    HLCS_ConfigT config = {};
+    config.lockId = LoadTestLockId;
+    config.name = "HLCS-load";
+    config.changeStateCallback = OnStateChanged;
+    config.selfTestResultCallback = OnSelfTestResult;
+    config.callbackContext = &observer;
+    HLCS_Handle handle = HLCS_Create(&config);
+    if (handle == nullptr)
+    {
+        fprintf(stderr, "scenario %s: HLCS_Create failed\n", scenario.name);
+        return;
+    }
+
+    //the initial transition locks, so the load starts from a known state
+    HLCS_InstanceStart(handle, EXECUTION_OPTION_NORMAL);
+    while (observer.stateChanges.load(std::memory_order_acquire) == 0)
+    {
+        std::this_thread::yield();
+    }
+
+    auto start = Clock::now();
+    size_t maxDepth = 0;
+    for (size_t i = 0; i < s_requests; ++i)
+    {
+        std::this_thread::sleep_until(start + std::chrono::microseconds(s_intervalUs) * i);
+        if ((i % SelfTestInterval) == (SelfTestInterval - 1))
+        {
+            RequestSelfTest(handle, observer);
+        }
+        else
+        {
+            RequestState(handle, observer, ((i % 2) == 0) ? HLCS_LOCK_STATE_UNLOCKED : HLCS_LOCK_STATE_LOCKED);
+        }
+
+        QueueStatsT queueStats;
+        if (HLCS_InstanceGetQueueStats(handle, &queueStats))
+        {
+            maxDepth = std::max(maxDepth, queueStats.currentDepth);
+        }
+    }
+
+    auto deadline = Clock::now() + DrainTimeout;
+    while (Unsatisfied(observer) && (Clock::now() < deadline))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    bool drained = !Unsatisfied(observer);
+
+    QueueStatsT queueStats = {};
+    HLCS_InstanceGetQueueStats(handle, &queueStats);
+    HLCS_Delete(handle);
+
+    HwLockCtrlSimStatsT simStats = {};
+    HwLockCtrlSimGetStats(&simStats);
+
+    std::vector<uint64_t>& latencies = observer.latencies;
+    std::sort(latencies.begin(), latencies.end());
+    std::sort(observer.selfTestLatencies.begin(), observer.selfTestLatencies.end());
+    uint64_t driverOps = 0;
+    uint64_t driverFailures = 0;
+    for (size_t op = 0; op <= HW_LOCK_CTRL_OPERATION_SELF_TEST; ++op)
+    {
+        driverOps += simStats.started[op];
+        driverFailures += simStats.failed[op];
+    }
+
+    printf("{\"scenario\":\"%s\",\"requests\":%zu,\"interval_us\":%" PRIu32 ",\"seconds\":%.3f,"
+           "\"drained\":%s,\"state_changes\":%" PRIu64 ",\"state_failures\":%" PRIu64 ",\"superseded\":%" PRIu64 ",\"measured\":%zu,"
+           "\"p50_us\":%.1f,\"p90_us\":%.1f,\"p99_us\":%.1f,\"max_us\":%.1f,"
+           "\"self_tests\":%" PRIu64 ",\"self_test_failures\":%" PRIu64 ",\"self_test_p99_us\":%.1f,"
+           "\"queue_high_water\":%zu,\"queue_max_depth_sampled\":%zu,\"queue_coalesced\":%" PRIu64 ","
+           "\"queue_full_rejections\":%" PRIu64 ",\"queue_p99_us\":%.1f,"
+           "\"driver_ops\":%" PRIu64 ",\"driver_failures\":%" PRIu64 ",\"driver_max_pending\":%zu,"
+           "\"power_failures\":%" PRIu64 ",\"motor_failures\":%" PRIu64 "}\n",
+           scenario.name, s_requests, s_intervalUs, seconds, drained ? "true" : "false",
+           observer.stateChanges.load(), observer.stateFailures.load(), observer.superseded, latencies.size(),
+           Percentile(latencies, 50.0) / 1000.0, Percentile(latencies, 90.0) / 1000.0,
+           Percentile(latencies, 99.0) / 1000.0, latencies.empty() ? 0.0 : latencies.back() / 1000.0,
+           observer.selfTestResults.load(), observer.selfTestFailures.load(),
+           Percentile(observer.selfTestLatencies, 99.0) / 1000.0,
+           queueStats.highWaterMark, maxDepth, queueStats.coalescedPosts, queueStats.fullRejections,
+           uxQueueStatsLatencyPercentileNs(&queueStats, 99.0) / 1000.0,
+           driverOps, driverFailures, simStats.maxPending,
+           simStats.selfTestPowerFailures, simStats.selfTestMotorFailures);
+    fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1)
+    {
+        s_requests = std::max<size_t>(strtoul(argv[1], nullptr, 10), 1);
+    }
+
+    if (argc > 2)
+    {
+        s_intervalUs = static_cast<uint32_t>(strtoul(argv[2], nullptr, 10));
+    }
+
+    if (argc > 3)
+    {
+        s_filter = argv[3];
+    }
+
+    //bounds each driver operation, see HLCS_ConfigT operationTimeoutMs
+    xTimerServiceStart(TIMER_CLOCK_REAL);
+    for (const auto& scenario : Scenarios)
+    {
+        if (s_filter.empty() || (std::string(scenario.name).find(s_filter) != std::string::npos))
+        {
+            RunScenario(scenario);
+        }
+    }
+    vTimerServiceStop();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,50 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//
+// Converts a binary faux RTOS trace file, as written by xTraceWriteFile(),
+// to the Chrome trace event JSON format. Open the result in
+// https://ui.perfetto.dev or chrome://tracing.
+//
+// usage: traceDumpApp <trace file> <json file>
+//
+#include <iostream>
+#include "fauxTrace.h"
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::cerr << "usage: traceDumpApp <trace file> <json file>" << std::endl;
+        return 2;
+    }
+
+    if (!xTraceConvertToChromeJson(argv[1], argv[2]))
+    {
+        std::cerr << "Failed to convert " << argv[1] << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,107 @@
+//
+// A buffered, asynchronous text log for the faux RTOS and its users.
+// Each thread formats messages into its own lock-free ring buffer,
+// and a background thread writes them out in batches, so logging
+// never blocks on, or serializes threads through, console I/O.
+//
+
+#ifndef FAUXLOG_H
+#define FAUXLOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOG_LEVEL_NONE    0
+#define LOG_LEVEL_ERROR   1
+#define LOG_LEVEL_WARNING 2
+#define LOG_LEVEL_INFO    3
+#define LOG_LEVEL_DEBUG   4
+
+/**
+ * @brief FAUX_LOG_LEVEL - the most verbose level compiled in. Messages
+ *        of a higher level compile to nothing, and their arguments are
+ *        never evaluated. Override with, for example, -DFAUX_LOG_LEVEL=1.
+ */
+#ifndef FAUX_LOG_LEVEL
+#define FAUX_LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+/**
+ * @brief LOG_RING_MESSAGES - messages buffered per thread. Once a thread's
+ *        ring is full, its further messages are dropped, and counted,
+ *        until the flush thread catches up.
+ */
+#define LOG_RING_MESSAGES 256
+
+/**
+ * @brief LOG_MESSAGE_MAX - longer messages are truncated, including the
+ *        terminating newline, which is always appended.
+ */
+#define LOG_MESSAGE_MAX 192
+
+/**
+ * @brief LOG_FLUSH_INTERVAL_MS - the flush thread writes out whatever has
+ *        been logged at this interval, or sooner once a ring is half full.
+ */
+#define LOG_FLUSH_INTERVAL_MS 10
+
+#define FAUX_LOG_AT(level, ...)                 \
+    do                                          \
+    {                                           \
+        if ((level) <= FAUX_LOG_LEVEL)          \
+        {                                       \
+            vLogPrintf((level), __VA_ARGS__);   \
+        }                                       \
+    } while (0)
+
+#define FAUX_LOG_ERROR(...)   FAUX_LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define FAUX_LOG_WARNING(...) FAUX_LOG_AT(LOG_LEVEL_WARNING, __VA_ARGS__)
+#define FAUX_LOG_INFO(...)    FAUX_LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define FAUX_LOG_DEBUG(...)   FAUX_LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+/**
+ * @brief vLogPrintf() - format a message into the calling thread's ring.
+ *        Prefer the FAUX_LOG_* macros, which filter at compile time. The
+ *        first message starts the flush thread. Never blocks: when the
+ *        ring is full, the message is dropped.
+ */
+void vLogPrintf(int level, const char* pcFormat, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+/**
+ * @brief LogSinkFunction - receives a batch of complete, newline terminated
+ *        messages, oldest first, from the flush thread or vLogFlush().
+ */
+typedef void (*LogSinkFunction)(void* pvContext, const char* pcText, size_t uxLength);
+
+/**
+ * @brief vLogSetSink() - where batches are written, NULL restores the
+ *        default, stderr. Messages already buffered go to the new sink.
+ */
+void vLogSetSink(LogSinkFunction pxSink, void* pvContext);
+
+/**
+ * @brief vLogFlush() - write out all messages logged before the call,
+ *        from the calling thread, before returning. For example, before
+ *        an assert, or at exit.
+ */
+void vLogFlush(void);
+
+/**
+ * @brief uxLogGetDroppedCount() - messages dropped, by all threads, since
+ *        the program started. Drops are also reported in the log itself.
+ */
+uint64_t uxLogGetDroppedCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //FAUXLOG_H
@@ -9,6 +9,8 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include "fauxTypes.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -16,13 +18,209 @@ extern "C" {
 
 typedef void* QueueHandle_t;
 
+typedef enum QueueMode
+{
+    QUEUE_MODE_STANDARD, //mutex + condition variable, supports xQueueSendToFront()
+    QUEUE_MODE_SPSC,     //wait-free, exactly one producer thread and one consumer thread
+    QUEUE_MODE_MPSC      //lock-free, any number of producer threads and one consumer thread
+} QueueModeT;
+
 QueueHandle_t xQueueCreate(size_t uxQueueLength, size_t uxItemSize);
+
+/**
+ * @brief xQueueCreateWithMode() - create a queue with a specific
+ *        concurrency mode. xQueueCreate() creates a QUEUE_MODE_STANDARD queue.
+ *
+ * @note: the lock-free modes only block the consumer when the queue is
+ *        empty, producers never block. xQueueSendToFront() is not supported
+ *        by the lock-free modes and always returns false.
+ */
+QueueHandle_t xQueueCreateWithMode(size_t uxQueueLength, size_t uxItemSize, QueueModeT mode);
+
+/**
+ * @brief priority lanes of a xQueueCreateWithLanes() queue.
+ */
+#define QUEUE_MAX_LANES 32
+
+/**
+ * @brief xQueueCreateWithLanes() - create a QUEUE_MODE_STANDARD queue with
+ *        uxLaneCount priority lanes. Lane 0 has the lowest priority, and
+ *        each lane holds up to puxLaneDepths[lane] items. A receive always
+ *        takes the oldest item of the highest priority lane with items,
+ *        found in O(1). Items are FIFO within a lane.
+ *
+ * @note: xQueueSendToBack*() sends to lane 0. xQueueSendToFront*() sends
+ *        to the tail of the highest lane, so several urgent items keep
+ *        their order, unlike a single lane queue, where each urgent item
+ *        is placed at the head.
+ *
+ * @return NULL: bad arguments, no lanes, or a lane of depth 0.
+ */
+QueueHandle_t xQueueCreateWithLanes(size_t uxLaneCount, const size_t* puxLaneDepths, size_t uxItemSize);
+
 void vQueueDelete( QueueHandle_t xQueue );
 bool xQueueSendToBack(QueueHandle_t xQueue, const void* pvItemToQueue);
 bool xQueueSendToFront(QueueHandle_t xQueue, const void* pvItemToQueue);
 bool xQueueReceive(QueueHandle_t xQueue, void *pvBuffer);
+
+/**
+ * @brief timed variants of the above, modeled after the FreeRTOS
+ *        xTicksToWait argument. A full queue blocks the sender, an
+ *        empty queue blocks the receiver, for up to xTicksToWait ticks.
+ *        0 never blocks, portMAX_DELAY blocks forever.
+ *
+ * @note: xQueueSendToBack() and xQueueSendToFront() never block,
+ *        xQueueReceive() blocks forever.
+ *
+ * @return true: the item was sent or received.
+ *         false: the timeout expired.
+ */
+bool xQueueSendToBackTimed(QueueHandle_t xQueue, const void* pvItemToQueue, TickType_t xTicksToWait);
+bool xQueueSendToFrontTimed(QueueHandle_t xQueue, const void* pvItemToQueue, TickType_t xTicksToWait);
+bool xQueueReceiveTimed(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait);
+
+/**
+ * @brief xQueueReceiveBatch() - block until at least one item is available,
+ *        then move up to uxMaxItems pending items, in queue order, into
+ *        pvBuffer. pvBuffer must hold uxMaxItems items. The standard queue
+ *        drains the whole batch under a single lock acquisition.
+ *
+ * @param puxReceived: [out] the number of items received.
+ *
+ * @return true: at least one item was received.
+ *         false: the timeout expired (timed variant) or bad arguments.
+ */
+bool xQueueReceiveBatch(QueueHandle_t xQueue, void *pvBuffer, size_t uxMaxItems, size_t* puxReceived);
+bool xQueueReceiveBatchTimed(QueueHandle_t xQueue, void *pvBuffer, size_t uxMaxItems, size_t* puxReceived,
+                             TickType_t xTicksToWait);
+
+/**
+ * @brief uxQueueMessagesWaiting() - items waiting, in all lanes. Wait free,
+ *        never takes the queue lock, so the count may lag a concurrent send.
+ */
 size_t uxQueueMessagesWaiting(const QueueHandle_t xQueue);
 
+/**
+ * @brief xQueueSendToLane() - send to the tail of a lane of a
+ *        xQueueCreateWithLanes() queue. A full lane fails the send,
+ *        or blocks the sender, even when other lanes have space.
+ * @return false: the lane is full (timeout expired), or does not exist.
+ */
+bool xQueueSendToLane(QueueHandle_t xQueue, const void* pvItemToQueue, size_t uxLane);
+bool xQueueSendToLaneTimed(QueueHandle_t xQueue, const void* pvItemToQueue, size_t uxLane,
+                           TickType_t xTicksToWait);
+
+/**
+ * @brief uxQueueLaneMessagesWaiting() - items waiting in a single lane.
+ *        Queues created without lanes have a single lane 0.
+ */
+size_t uxQueueLaneMessagesWaiting(const QueueHandle_t xQueue, size_t uxLane);
+
+/**
+ * @brief xQueueHasItemsAboveLane() - true if any lane of higher priority
+ *        than uxLane has items waiting. Wait free, as uxQueueMessagesWaiting().
+ */
+bool xQueueHasItemsAboveLane(const QueueHandle_t xQueue, size_t uxLane);
+
+typedef enum QueueCoalesce
+{
+    QUEUE_COALESCE_NONE,            //every send is queued, the default
+    QUEUE_COALESCE_DROP_IF_PENDING, //drop the send if an identical item of the class is pending
+    QUEUE_COALESCE_LAST_VALUE_WINS  //overwrite the pending item of the class, in place
+} QueueCoalesceT;
+
+/**
+ * @brief signals 0 to QUEUE_COALESCE_MAX_SIGNALS - 1 may be coalesced,
+ *        into up to QUEUE_COALESCE_MAX_CLASSES classes.
+ */
+#define QUEUE_COALESCE_MAX_SIGNALS 64
+#define QUEUE_COALESCE_MAX_CLASSES 64
+
+/**
+ * @brief xQueueSetCoalescing() - coalesce idempotent requests. Items are
+ *        keyed by their leading uint32_t signal. Signals sharing ucClass
+ *        share a single pending item per lane: while it waits in the queue,
+ *        further xQueueSendToBack*() or xQueueSendToLane*() sends of the
+ *        class to the same lane either replace it or are dropped, as per
+ *        mode, never needing a free slot. Once received, the next send of
+ *        the class is queued as usual. A pending class is found in O(1),
+ *        with a bitmap, while holding the queue lock.
+ *
+ *        Coalescing never crosses lanes: a send to a lane is queued in
+ *        that lane, even while an item of its class waits in another lane,
+ *        which is left untouched. Lanes keep their priority order.
+ *
+ * @note: QUEUE_COALESCE_LAST_VALUE_WINS moves the later request ahead of
+ *        any item sent after the replaced one, so use it only for requests
+ *        where the final value is all that matters. xQueueSendToFront*()
+ *        sends are never coalesced. QUEUE_MODE_STANDARD queues only, with
+ *        items of at least 4 bytes.
+ *
+ * @return false: bad arguments or unsupported queue mode.
+ */
+bool xQueueSetCoalescing(QueueHandle_t xQueue, uint32_t ulSignal, QueueCoalesceT mode, uint8_t ucClass);
+
+typedef void (*QueuePostCallback_t)(void* pvContext);
+
+/**
+ * @brief vQueueSetPostCallback() - register a callback executed, in the
+ *        sender's context, after every successful send to the queue.
+ *        Used by the faux scheduler to learn that an active object has
+ *        work. NULL removes the callback; this call then waits for any
+ *        callback still executing on another thread.
+ */
+void vQueueSetPostCallback(QueueHandle_t xQueue, QueuePostCallback_t pxCallback, void* pvContext);
+
+/**
+ * @brief latency histogram buckets. Each power of two is split into four
+ *        linear sub-buckets, so a bucket is within ~25% of the true value.
+ *        The last bucket also collects every latency above ~8.6 seconds.
+ */
+#define QUEUE_STATS_LATENCY_BUCKETS 128
+
+typedef struct QueueStats
+{
+    uint64_t normalPosts;      //successful xQueueSendToBack*() calls
+    uint64_t urgentPosts;      //successful xQueueSendToFront*() calls
+    uint64_t fullRejections;   //sends which failed due to a full queue
+    uint64_t coalescedPosts;   //sends dropped or merged into a pending item, see xQueueSetCoalescing()
+    uint64_t receives;
+    size_t highWaterMark;      //maximum depth observed after a send
+    size_t currentDepth;
+    uint64_t latencyHistogram[QUEUE_STATS_LATENCY_BUCKETS]; //send to receive, nanoseconds
+} QueueStatsT;
+
+/**
+ * @brief vQueueEnableStats() - statistics are disabled by default. Once
+ *        enabled, each send and receive updates a few relaxed atomic
+ *        counters and each event is timestamped, cheap enough to be
+ *        left enabled in production. Events sent while disabled are
+ *        counted when received, but do not contribute a latency sample.
+ */
+void vQueueEnableStats(QueueHandle_t xQueue, bool xEnable);
+
+/**
+ * @brief xQueueGetStats() - copy a snapshot of the queue statistics.
+ *        Counters are read individually, so a snapshot taken while
+ *        the queue is in use may be slightly inconsistent.
+ * @return false: bad arguments.
+ */
+bool xQueueGetStats(const QueueHandle_t xQueue, QueueStatsT* pxStats);
+void vQueueResetStats(QueueHandle_t xQueue);
+
+/**
+ * @brief uxQueueStatsBucketLowerBoundNs() - the smallest latency,
+ *        in nanoseconds, counted by latencyHistogram[uxBucket].
+ */
+uint64_t uxQueueStatsBucketLowerBoundNs(size_t uxBucket);
+
+/**
+ * @brief uxQueueStatsLatencyPercentileNs() - latency, in nanoseconds, at or
+ *        below which dPercentile (0.0 to 100.0) of the samples fall. Reported
+ *        as the upper bound of the matching bucket, 0 if no samples exist.
+ */
+uint64_t uxQueueStatsLatencyPercentileNs(const QueueStatsT* pxStats, double dPercentile);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,64 @@
+//
+// A 'faux' RTOS scheduler, multiplexing many active objects onto
+// a small pool of worker threads (M:N execution), in place of a
+// dedicated thread per active object.
+//
+
+#ifndef FAUXSCHEDULER_H
+#define FAUXSCHEDULER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "fauxQueue.h"
+#include "fauxThread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief SchedulerDispatchFunction_t - process at most one event from the
+ *        active object's queue, without blocking.
+ * @return true: an event was processed.
+ *         false: the queue was empty, or the active object is finished.
+ */
+typedef bool (*SchedulerDispatchFunction_t)(void* pvContext);
+typedef void* ScheduledObjectHandle_t;
+
+/**
+ * @brief xSchedulerStart() - create the worker pool.
+ * @param uxWorkerCount: number of worker threads, 0 selects one per CPU.
+ * @param pxWorkerOptions: optional priority/affinity of each worker, may be NULL.
+ */
+bool xSchedulerStart(size_t uxWorkerCount, const TaskOptionsT* pxWorkerOptions);
+
+/**
+ * @brief vSchedulerStop() - stop and join the worker pool. All active
+ *        objects must have been unregistered.
+ */
+void vSchedulerStop(void);
+
+bool xSchedulerIsRunning(void);
+
+/**
+ * @brief xSchedulerRegister() - run an active object on the worker pool.
+ *        Whenever its queue receives an event, a worker calls pxDispatch,
+ *        never concurrently for the same active object (run to completion).
+ * @return NULL if the scheduler is not running.
+ */
+ScheduledObjectHandle_t xSchedulerRegister(QueueHandle_t xQueue,
+                                           SchedulerDispatchFunction_t pxDispatch,
+                                           void* pvContext);
+
+/**
+ * @brief vSchedulerUnregister() - stop scheduling the active object. Waits
+ *        for a dispatch in progress to complete. Must not be called from
+ *        the active object's own dispatch.
+ */
+void vSchedulerUnregister(ScheduledObjectHandle_t xObject);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //FAUXSCHEDULER_H
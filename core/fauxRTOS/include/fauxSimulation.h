@@ -0,0 +1,65 @@
+//
+// Deterministic simulation of the faux RTOS. All active objects
+// registered with the faux scheduler, and all timers, run on the
+// calling thread, in a reproducible interleaving, on a virtual clock.
+//
+
+#ifndef FAUXSIMULATION_H
+#define FAUXSIMULATION_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "fauxTypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief xSimulationStart() - start the faux scheduler without any worker
+ *        threads, and the timer service with TIMER_CLOCK_VIRTUAL. Active
+ *        objects then register with xSchedulerRegister(), as usual, and
+ *        are only dispatched by the functions below.
+ * @param ulSeed: seeds the choice of the next active object to dispatch.
+ *        The same seed, with the same inputs, replays the same interleaving.
+ * @return false if the scheduler or the timer service is already running.
+ */
+bool xSimulationStart(uint32_t ulSeed);
+
+/**
+ * @brief vSimulationStop() - stop the simulated scheduler and the timer
+ *        service. All active objects must have been unregistered.
+ */
+void vSimulationStop(void);
+
+bool xSimulationIsRunning(void);
+
+/**
+ * @brief xSimulationStep() - dispatch one event of an active object chosen
+ *        at random among those with pending events. Never blocks, and
+ *        never advances the virtual clock.
+ * @return false: no active object had pending events.
+ */
+bool xSimulationStep(void);
+
+/**
+ * @brief uxSimulationRunUntilIdle() - step until no active object has
+ *        pending events, or uxMaxSteps events were dispatched.
+ * @return the number of events dispatched.
+ */
+size_t uxSimulationRunUntilIdle(size_t uxMaxSteps);
+
+/**
+ * @brief uxSimulationRunFor() - run xTicks of virtual time as fast as
+ *        possible: step until idle, then jump the virtual clock to the
+ *        next timer expiry, and repeat.
+ * @return the number of events dispatched.
+ */
+size_t uxSimulationRunFor(TickType_t xTicks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //FAUXSIMULATION_H
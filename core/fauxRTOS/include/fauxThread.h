@@ -1,24 +1,90 @@
 //
 // Created by Matthew Eshleman on 4/10/21.
 // A 'faux' RTOS Thread/Task, modeled after FreeRTOS,
-// internally using standard portable C++11 components.
+// internally using POSIX threads.
 
 #ifndef FAUXTHREAD_H
 #define FAUXTHREAD_H
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include "fauxTypes.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 typedef void (*TaskFunction_t)(void);
+typedef void (*TaskParameterFunction_t)(void* pvParameters);
 typedef void* TaskHandle_t;
+typedef uintptr_t StackType_t;
 
+typedef enum TaskSchedPolicy
+{
+    TASK_SCHED_NORMAL,  //SCHED_OTHER, priority is mapped to a nice value
+    TASK_SCHED_REALTIME //SCHED_FIFO, priority is the real time priority
+} TaskSchedPolicyT;
+
+/**
+ * @brief TaskOptions - optional real time attributes of a task.
+ *        priority: as with FreeRTOS, a higher value is a higher priority.
+ *                  TASK_SCHED_NORMAL: nice value = -priority, clamped to -20..19.
+ *                  TASK_SCHED_REALTIME: the SCHED_FIFO priority, clamped to
+ *                  the range supported by the platform.
+ *        cpuAffinityMask: bit N allows the task to run on CPU N.
+ *                         0 leaves the task unpinned. Linux only.
+ */
+typedef struct TaskOptions
+{
+    TaskSchedPolicyT policy;
+    int priority;
+    uint64_t cpuAffinityMask;
+} TaskOptionsT;
+
+/**
+ * @brief xTaskCreate() - create a task with default scheduling options.
+ * @param pcName: applied as the thread name, truncated to 15 characters.
+ * @param usStackDepth: stack size in words (StackType_t), as with FreeRTOS.
+ *                      0 selects the platform default. Small values are
+ *                      raised to the platform minimum.
+ */
 bool xTaskCreate(TaskFunction_t pxTaskCode, const char* pcName, size_t usStackDepth, TaskHandle_t* pxCreatedTask);
+
+/**
+ * @brief xTaskCreateWithOptions() - as xTaskCreate(), with real time attributes.
+ * @return false: the task could not be created, for example, when
+ *                TASK_SCHED_REALTIME, or a TASK_SCHED_NORMAL priority above 0,
+ *                is requested without sufficient privileges.
+ */
+bool xTaskCreateWithOptions(TaskFunction_t pxTaskCode, const char* pcName, size_t usStackDepth,
+                            const TaskOptionsT* pxOptions, TaskHandle_t* pxCreatedTask);
+
+/**
+ * @brief xTaskCreateWithParameters() - as xTaskCreateWithOptions(), for a task
+ *        function taking a parameter, as with FreeRTOS pvParameters. Lets one
+ *        task function serve many instances of an active object.
+ * @param pxOptions: NULL selects the default scheduling options.
+ */
+bool xTaskCreateWithParameters(TaskParameterFunction_t pxTaskCode, const char* pcName, size_t usStackDepth,
+                               void* pvParameters, const TaskOptionsT* pxOptions, TaskHandle_t* pxCreatedTask);
+
+/**
+ * @brief vTaskDelete() - wait for the task function to return, then release the task.
+ */
 void vTaskDelete(TaskHandle_t handle);
 
+/**
+ * @brief vTaskYield() - as FreeRTOS taskYIELD(), let another ready thread run.
+ */
+void vTaskYield(void);
+
+/**
+ * @brief vTaskDelay() - as FreeRTOS vTaskDelay(), block the calling
+ *        thread for at least xTicksToDelay ticks of the steady clock.
+ */
+void vTaskDelay(TickType_t xTicksToDelay);
+
 #ifdef __cplusplus
 }
 #endif
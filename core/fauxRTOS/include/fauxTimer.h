@@ -0,0 +1,118 @@
+//
+// A 'faux' RTOS software timer service, modeled after FreeRTOS timers.
+// Instead of executing a callback, an expired timer posts a copy of its
+// event into an active object's queue.
+//
+
+#ifndef FAUXTIMER_H
+#define FAUXTIMER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "fauxQueue.h"
+#include "fauxTypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void* TimerHandle_t;
+
+typedef enum TimerClock
+{
+    TIMER_CLOCK_REAL,    //a single timer thread follows the steady clock
+    TIMER_CLOCK_VIRTUAL  //no thread, time only moves with vTimerAdvanceTicks()
+} TimerClockT;
+
+/**
+ * @brief xTimerServiceStart() - start the timer service, at tick 0.
+ *        All timers of the service share a single hierarchical timing
+ *        wheel, so an armed timer costs neither a thread nor a heap
+ *        allocation.
+ * @return false if already running, or the timer thread failed to start.
+ */
+bool xTimerServiceStart(TimerClockT clock);
+
+/**
+ * @brief vTimerServiceStop() - stop the service, joining the timer
+ *        thread. Timers not yet deleted are released, their handles
+ *        are no longer valid.
+ */
+void vTimerServiceStop(void);
+
+bool xTimerServiceIsRunning(void);
+
+/**
+ * @brief xTimerGetTickCount() - ticks elapsed since xTimerServiceStart().
+ */
+TickType_t xTimerGetTickCount(void);
+
+/**
+ * @brief vTimerAdvanceTicks() - TIMER_CLOCK_VIRTUAL only, move time
+ *        forward tick by tick. Expired timers post their events from
+ *        the calling thread, before this returns.
+ */
+void vTimerAdvanceTicks(TickType_t xTicks);
+
+/**
+ * @brief xTimerAdvanceToNextExpiry() - TIMER_CLOCK_VIRTUAL only, as
+ *        vTimerAdvanceTicks(), but stop at the first tick which expired
+ *        a timer, skipping idle time in one step.
+ * @return the ticks advanced, xMaxTicks if no timer expired.
+ */
+TickType_t xTimerAdvanceToNextExpiry(TickType_t xMaxTicks);
+
+/**
+ * @brief xTimerCreate() - create a dormant timer.
+ * @param xTimerPeriod: the timer period, at least one tick.
+ * @param xAutoReload: true - periodic, false - one shot.
+ * @param xQueue: the active object queue receiving the timer event.
+ * @param pvEvent: the event posted, copied into the timer.
+ * @param uxEventSize: must equal the item size of xQueue.
+ * @return NULL if the service is not running, or bad arguments.
+ *
+ * @note: the timer posts with xQueueSendToBack(), never blocking the timer
+ *        thread. When the queue is full, that expiry is dropped. A queue
+ *        post callback must not call back into the timer API.
+ */
+TimerHandle_t xTimerCreate(const char* pcTimerName, TickType_t xTimerPeriod, bool xAutoReload,
+                           QueueHandle_t xQueue, const void* pvEvent, size_t uxEventSize);
+
+/**
+ * @brief xTimerSetQueueLane() - post the event with xQueueSendToLane(),
+ *        rather than xQueueSendToBack(), for example to a lane which
+ *        overtakes pending requests. See xQueueCreateWithLanes().
+ * @return false: bad arguments, the lane is checked when posting.
+ */
+bool xTimerSetQueueLane(TimerHandle_t xTimer, size_t uxLane);
+
+/**
+ * @brief vTimerDelete() - stop and release the timer. Once this returns,
+ *        the timer will post no further events.
+ */
+void vTimerDelete(TimerHandle_t xTimer);
+
+/**
+ * @brief xTimerStart() - (re)arm the timer, to expire xTimerPeriod ticks
+ *        from now. A running timer restarts, as with FreeRTOS xTimerReset().
+ */
+bool xTimerStart(TimerHandle_t xTimer);
+bool xTimerStop(TimerHandle_t xTimer);
+
+/**
+ * @brief xTimerChangePeriod() - change the period, and (re)start the timer.
+ */
+bool xTimerChangePeriod(TimerHandle_t xTimer, TickType_t xNewPeriod);
+
+bool xTimerIsTimerActive(TimerHandle_t xTimer);
+
+/**
+ * @brief uxTimerGetDroppedCount() - expiries not posted, the queue was full.
+ */
+size_t uxTimerGetDroppedCount(TimerHandle_t xTimer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //FAUXTIMER_H
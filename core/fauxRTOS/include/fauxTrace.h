@@ -0,0 +1,102 @@
+//
+// A low overhead binary event trace for the faux RTOS and its
+// active objects. Each thread records fixed size records into its
+// own lock-free ring buffer, which keeps the most recent records.
+//
+
+#ifndef FAUXTRACE_H
+#define FAUXTRACE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief records per thread ring, the oldest records are overwritten.
+ *        Up to TRACE_RING_RECORDS - 1 of them are collected.
+ */
+#define TRACE_RING_RECORDS 4096
+
+typedef enum TraceEventType
+{
+    TRACE_EVENT_QUEUE_POST,       //object: queue, arg0: depth after post, arg1: 1 if urgent, arg2: lane
+    TRACE_EVENT_QUEUE_RECEIVE,    //object: queue, arg0: events received, arg1: depth after receive
+    TRACE_EVENT_DISPATCH_BEGIN,   //object: active object, arg0: signal
+    TRACE_EVENT_DISPATCH_END,     //object: active object, arg0: signal, arg1: state after dispatch
+    TRACE_EVENT_STATE_TRANSITION, //object: active object, arg0: source state, arg1: target state, arg2: signal
+    TRACE_EVENT_CALLBACK,         //object: active object, arg0: callback id, arg1: value
+    TRACE_EVENT_USER              //free form arguments
+} TraceEventTypeT;
+
+/**
+ * @brief TraceRecord - as collected, the timestamp is in nanoseconds
+ *        since tracing was first enabled.
+ */
+typedef struct TraceRecord
+{
+    uint64_t timestampNs;
+    uint64_t object;
+    uint32_t arg0;
+    uint32_t arg1;
+    uint32_t arg2;
+    uint16_t type;
+    uint16_t thread;
+} TraceRecordT;
+
+/**
+ * @brief vTraceEnable() - tracing is disabled by default. While disabled,
+ *        each trace point costs a single relaxed load. While enabled, a
+ *        record costs a TSC read (CLOCK_MONOTONIC where there is no TSC)
+ *        and four stores to the thread's own ring.
+ */
+void vTraceEnable(bool xEnable);
+bool xTraceIsEnabled(void);
+
+void vTraceRecord(TraceEventTypeT type, const void* pvObject, uint32_t ulArg0, uint32_t ulArg1, uint32_t ulArg2);
+
+/**
+ * @brief vTraceSetThreadName() - name the calling thread's ring. Tasks
+ *        created by xTaskCreate() are named after the task.
+ */
+void vTraceSetThreadName(const char* pcName);
+
+/**
+ * @brief vTraceSetObjectName() - name a queue or active object in dumps.
+ */
+void vTraceSetObjectName(const void* pvObject, const char* pcName);
+
+/**
+ * @brief uxTraceCollect() - copy up to uxMaxRecords of the records of all
+ *        threads, oldest first. Records overwritten while collecting are
+ *        skipped, so collection may run while other threads trace.
+ * @return the number of records copied.
+ */
+size_t uxTraceCollect(TraceRecordT* pxBuffer, size_t uxMaxRecords);
+
+/**
+ * @brief vTraceClear() - forget all records recorded so far.
+ */
+void vTraceClear(void);
+
+/**
+ * @brief xTraceWriteFile() - write the collected records, with the thread
+ *        and object names, to a binary trace file.
+ */
+bool xTraceWriteFile(const char* pcTracePath);
+
+/**
+ * @brief xTraceConvertToChromeJson() - convert a binary trace file to the
+ *        Chrome trace event JSON format, viewable in Perfetto
+ *        (https://ui.perfetto.dev) or chrome://tracing.
+ */
+bool xTraceConvertToChromeJson(const char* pcTracePath, const char* pcJsonPath);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //FAUXTRACE_H
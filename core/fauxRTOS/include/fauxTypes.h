@@ -0,0 +1,24 @@
+//
+// Common 'faux' RTOS types, modeled after FreeRTOS.
+//
+
+#ifndef FAUXTYPES_H
+#define FAUXTYPES_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint32_t TickType_t;
+
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS ((TickType_t)1)
+#define pdMS_TO_TICKS(xTimeInMs) ((TickType_t)(xTimeInMs) / portTICK_PERIOD_MS)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //FAUXTYPES_H
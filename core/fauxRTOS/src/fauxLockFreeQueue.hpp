@@ -0,0 +1,319 @@
+//
+// Lock-free faux RTOS queue variants. Producers never take a lock
+// held by the consumer while it is processing events, the consumer
+// only falls back to a condition variable when it is actually idle,
+// and producers only when they choose to wait for a full queue.
+//
+
+#ifndef FAUXLOCKFREEQUEUE_HPP
+#define FAUXLOCKFREEQUEUE_HPP
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include "fauxQueueInterface.hpp"
+#include "fauxWaiter.hpp"
+
+namespace cms
+{
+
+/**
+ * @brief SpscQueue - wait-free single producer, single consumer ring.
+ *        Head and tail are free running counters, each on its own
+ *        cache line. Urgent (front) insertion is not supported.
+ */
+class SpscQueue : public QueueInterface
+{
+public:
+    explicit SpscQueue(size_t queueDepth, size_t eventSize) :
+        mQueueDepth(queueDepth),
+        mEventSize(eventSize),
+        mStorage(queueDepth * eventSize),
+        mTimestamps(queueDepth),
+        mNotEmpty(),
+        mNotFull(),
+        mHead(0),
+        mTail(0),
+        mProducerHeadCache(0)
+    {
+    }
+
+    size_t Count() const override
+    {
+        size_t tail = mTail.load(std::memory_order_acquire);
+        size_t head = mHead.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    bool Post(const void* item, TickType_t ticksToWait) override
+    {
+        if (!mNotFull.WaitUntil([this, item]() { return TryPost(item); }, ticksToWait))
+        {
+            mStats.OnFull();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool PostUrgent(const void* item, TickType_t ticksToWait) override
+    {
+        (void)item;
+        (void)ticksToWait;
+        return false;
+    }
+
+    bool Receive(void* pvBuffer, TickType_t ticksToWait) override
+    {
+        return mNotEmpty.WaitUntil([this, pvBuffer]() { return TryReceive(pvBuffer); }, ticksToWait);
+    }
+
+    size_t ReceiveBatch(void* pvBuffer, size_t maxItems, TickType_t ticksToWait) override
+    {
+        auto buffer = static_cast<uint8_t*>(pvBuffer);
+        if ((maxItems == 0) ||
+            !mNotEmpty.WaitUntil([this, buffer]() { return TryReceive(buffer); }, ticksToWait))
+        {
+            return 0;
+        }
+
+        size_t received = 1;
+        while ((received < maxItems) && TryReceive(buffer + (received * mEventSize)))
+        {
+            ++received;
+        }
+
+        return received;
+    }
+
+private:
+    bool TryPost(const void* item)
+    {
+        size_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail - mProducerHeadCache >= mQueueDepth)
+        {
+            mProducerHeadCache = mHead.load(std::memory_order_acquire);
+            if (tail - mProducerHeadCache >= mQueueDepth)
+            {
+                return false;
+            }
+        }
+
+        memcpy(SlotAt(tail), item, mEventSize);
+        mTimestamps[tail % mQueueDepth] = mStats.Timestamp();
+        mTail.store(tail + 1, std::memory_order_release);
+        mNotEmpty.NotifyIfWaiting();
+        if (mStats.Enabled())
+        {
+            mStats.OnPost(false, Count());
+        }
+        NotifyPosted();
+        return true;
+    }
+
+    bool TryReceive(void* pvBuffer)
+    {
+        size_t head = mHead.load(std::memory_order_relaxed);
+        if (head == mTail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        memcpy(pvBuffer, SlotAt(head), mEventSize);
+        uint64_t timestamp = mTimestamps[head % mQueueDepth];
+        mHead.store(head + 1, std::memory_order_release);
+        mNotFull.NotifyIfWaiting();
+        mStats.OnReceive(timestamp, mStats.Timestamp());
+        return true;
+    }
+
+    uint8_t* SlotAt(size_t position)
+    {
+        return mStorage.data() + ((position % mQueueDepth) * mEventSize);
+    }
+
+    const size_t mQueueDepth;
+    const size_t mEventSize;
+    std::vector<uint8_t> mStorage;
+    std::vector<uint64_t> mTimestamps;
+    Waiter mNotEmpty;
+    Waiter mNotFull;
+
+    //consumer owned
+    alignas(CacheLineSize) std::atomic<size_t> mHead;
+
+    //producer owned
+    alignas(CacheLineSize) std::atomic<size_t> mTail;
+    size_t mProducerHeadCache;
+};
+
+/**
+ * @brief MpscQueue - lock-free multiple producer, single consumer ring.
+ *        Each slot carries a sequence number (bounded queue design
+ *        by Dmitry Vyukov) so producers claim slots with a single
+ *        compare-exchange on the tail. Urgent (front) insertion is
+ *        not supported.
+ */
+class MpscQueue : public QueueInterface
+{
+public:
+    explicit MpscQueue(size_t queueDepth, size_t eventSize) :
+        mQueueDepth(queueDepth),
+        mEventSize(eventSize),
+        mStorage(queueDepth * eventSize),
+        mTimestamps(queueDepth),
+        mSequences(new std::atomic<size_t>[queueDepth]),
+        mNotEmpty(),
+        mNotFull(),
+        mHead(0),
+        mTail(0)
+    {
+        for (size_t i = 0; i < mQueueDepth; ++i)
+        {
+            mSequences[i].store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Count - approximate, includes slots claimed by producers
+     *        which are still being written.
+     */
+    size_t Count() const override
+    {
+        size_t tail = mTail.load(std::memory_order_acquire);
+        size_t head = mHead.load(std::memory_order_acquire);
+        return (tail > head) ? (tail - head) : 0;
+    }
+
+    bool Post(const void* item, TickType_t ticksToWait) override
+    {
+        if (!mNotFull.WaitUntil([this, item]() { return TryPost(item); }, ticksToWait))
+        {
+            mStats.OnFull();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool PostUrgent(const void* item, TickType_t ticksToWait) override
+    {
+        (void)item;
+        (void)ticksToWait;
+        return false;
+    }
+
+    bool Receive(void* pvBuffer, TickType_t ticksToWait) override
+    {
+        return mNotEmpty.WaitUntil([this, pvBuffer]() { return TryReceive(pvBuffer); }, ticksToWait);
+    }
+
+    size_t ReceiveBatch(void* pvBuffer, size_t maxItems, TickType_t ticksToWait) override
+    {
+        auto buffer = static_cast<uint8_t*>(pvBuffer);
+        if ((maxItems == 0) ||
+            !mNotEmpty.WaitUntil([this, buffer]() { return TryReceive(buffer); }, ticksToWait))
+        {
+            return 0;
+        }
+
+        size_t received = 1;
+        while ((received < maxItems) && TryReceive(buffer + (received * mEventSize)))
+        {
+            ++received;
+        }
+
+        return received;
+    }
+
+private:
+    bool TryPost(const void* item)
+    {
+        if (mQueueDepth == 0)
+        {
+            return false;
+        }
+
+        size_t position = mTail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            size_t sequence = mSequences[position % mQueueDepth].load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (diff == 0)
+            {
+                if (mTail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false; //full
+            }
+            else
+            {
+                position = mTail.load(std::memory_order_relaxed);
+            }
+        }
+
+        size_t index = position % mQueueDepth;
+        memcpy(SlotAt(index), item, mEventSize);
+        mTimestamps[index] = mStats.Timestamp();
+        mSequences[index].store(position + 1, std::memory_order_release);
+        mNotEmpty.NotifyIfWaiting();
+        if (mStats.Enabled())
+        {
+            mStats.OnPost(false, Count());
+        }
+        NotifyPosted();
+        return true;
+    }
+
+    bool TryReceive(void* pvBuffer)
+    {
+        if (mQueueDepth == 0)
+        {
+            return false;
+        }
+
+        size_t position = mHead.load(std::memory_order_relaxed);
+        size_t index = position % mQueueDepth;
+        if (mSequences[index].load(std::memory_order_acquire) != position + 1)
+        {
+            return false;
+        }
+
+        memcpy(pvBuffer, SlotAt(index), mEventSize);
+        uint64_t timestamp = mTimestamps[index];
+        mSequences[index].store(position + mQueueDepth, std::memory_order_release);
+        mHead.store(position + 1, std::memory_order_release);
+        mNotFull.NotifyIfWaiting();
+        mStats.OnReceive(timestamp, mStats.Timestamp());
+        return true;
+    }
+
+    uint8_t* SlotAt(size_t index)
+    {
+        return mStorage.data() + (index * mEventSize);
+    }
+
+    const size_t mQueueDepth;
+    const size_t mEventSize;
+    std::vector<uint8_t> mStorage;
+    std::vector<uint64_t> mTimestamps;
+    std::unique_ptr<std::atomic<size_t>[]> mSequences;
+    Waiter mNotEmpty;
+    Waiter mNotFull;
+
+    //consumer owned
+    alignas(CacheLineSize) std::atomic<size_t> mHead;
+
+    //shared by all producers
+    alignas(CacheLineSize) std::atomic<size_t> mTail;
+};
+
+} // namespace cms
+
+#endif //FAUXLOCKFREEQUEUE_HPP
@@ -0,0 +1,365 @@
+//
+// Buffered asynchronous log for the faux RTOS, see fauxLog.h.
+//
+#include "fauxLog.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cms
+{
+
+struct LogMessage
+{
+    uint64_t timestampNs;
+    uint32_t length;
+    int level;
+    char text[LOG_MESSAGE_MAX];
+};
+
+/**
+ * @brief LogRing - a single producer, single consumer ring of formatted
+ *        messages. Only the owning thread writes, and only the flush,
+ *        under the drain mutex, reads. A ring is recycled once its
+ *        thread exits and it is drained, so short lived threads do
+ *        not grow the log.
+ */
+class LogRing
+{
+public:
+    static_assert((LOG_RING_MESSAGES & (LOG_RING_MESSAGES - 1)) == 0, "LOG_RING_MESSAGES must be a power of 2");
+
+    /**
+     * @return false: the ring was full, the message was dropped.
+     */
+    bool Write(uint64_t timestampNs, int level, const char* format, va_list args)
+    {
+        uint64_t head = mHead.load(std::memory_order_relaxed);
+        if (head - mTail.load(std::memory_order_acquire) >= LOG_RING_MESSAGES)
+        {
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        LogMessage& message = mMessages[head & (LOG_RING_MESSAGES - 1)];
+        int length = vsnprintf(message.text, LOG_MESSAGE_MAX - 1, format, args);
+        length = std::min(std::max(length, 0), LOG_MESSAGE_MAX - 2);
+        message.text[length] = '\n';
+        message.length = static_cast<uint32_t>(length + 1);
+        message.timestampNs = timestampNs;
+        message.level = level;
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool HalfFull() const
+    {
+        return (mHead.load(std::memory_order_relaxed) - mTail.load(std::memory_order_relaxed)) >= (LOG_RING_MESSAGES / 2);
+    }
+
+    /**
+     * @brief Drain - copy out all published messages, oldest first,
+     *        then release their slots to the writer.
+     */
+    void Drain(std::vector<LogMessage>& messages)
+    {
+        uint64_t tail = mTail.load(std::memory_order_relaxed);
+        uint64_t head = mHead.load(std::memory_order_acquire);
+        for (uint64_t index = tail; index < head; ++index)
+        {
+            messages.push_back(mMessages[index & (LOG_RING_MESSAGES - 1)]);
+        }
+        mTail.store(head, std::memory_order_release);
+    }
+
+    /**
+     * @brief TakeDropped - messages dropped since the last call.
+     */
+    uint64_t TakeDropped()
+    {
+        uint64_t dropped = mDropped.load(std::memory_order_relaxed);
+        uint64_t unreported = dropped - mReportedDropped;
+        mReportedDropped = dropped;
+        return unreported;
+    }
+
+    uint64_t Dropped() const
+    {
+        return mDropped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief TryAcquire - claim a released ring, once drained, so a new
+     *        thread starts with the whole ring to itself.
+     */
+    bool TryAcquire()
+    {
+        bool inUse = false;
+        if (!mInUse.compare_exchange_strong(inUse, true, std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        if (mHead.load(std::memory_order_relaxed) != mTail.load(std::memory_order_acquire))
+        {
+            mInUse.store(false, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    void Release()
+    {
+        mInUse.store(false, std::memory_order_release);
+    }
+
+private:
+    std::atomic<uint64_t> mHead{0};
+    std::atomic<uint64_t> mTail{0};
+    std::atomic<uint64_t> mDropped{0};
+    uint64_t mReportedDropped = 0; //drain mutex only
+    std::atomic<bool> mInUse{false};
+    LogMessage mMessages[LOG_RING_MESSAGES];
+};
+
+static void WriteToStderr(void* context, const char* text, size_t length)
+{
+    (void)context;
+    fwrite(text, 1, length, stderr);
+    fflush(stderr);
+}
+
+/**
+ * @brief Logger - the rings of all threads, and the flush thread,
+ *        started with the first message logged.
+ */
+class Logger
+{
+public:
+    static Logger& Instance()
+    {
+        static Logger logger;
+        return logger;
+    }
+
+    ~Logger()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mWakeMutex);
+            mStop = true;
+        }
+        mWakeCondition.notify_one();
+        if (mThread.joinable())
+        {
+            mThread.join();
+        }
+        Flush();
+    }
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    void Write(int level, const char* format, va_list args)
+    {
+        LogRing* ring = tRingOwner.ring;
+        if (ring == nullptr)
+        {
+            ring = AcquireRing();
+        }
+
+        auto timestampNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - mEpoch).count());
+        ring->Write(timestampNs, level, format, args);
+        if (ring->HalfFull() && !mWake.exchange(true))
+        {
+            mWakeCondition.notify_one();
+        }
+    }
+
+    void SetSink(LogSinkFunction sink, void* context)
+    {
+        std::lock_guard<std::mutex> lock(mDrainMutex);
+        mSink = (sink != nullptr) ? sink : WriteToStderr;
+        mSinkContext = (sink != nullptr) ? context : nullptr;
+    }
+
+    /**
+     * @brief Flush - drain all rings, merge their messages by time,
+     *        and hand them to the sink as a single batch.
+     */
+    void Flush()
+    {
+        std::vector<LogRing*> rings;
+        {
+            std::lock_guard<std::mutex> lock(mRingsMutex);
+            for (auto& ring : mRings)
+            {
+                rings.push_back(ring.get());
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mDrainMutex);
+        mMessages.clear();
+        uint64_t dropped = 0;
+        for (auto ring : rings)
+        {
+            ring->Drain(mMessages);
+            dropped += ring->TakeDropped();
+        }
+
+        std::stable_sort(mMessages.begin(), mMessages.end(), [](const LogMessage& a, const LogMessage& b) {
+            return a.timestampNs < b.timestampNs;
+        });
+
+        mBatch.clear();
+        for (const auto& message : mMessages)
+        {
+            AppendPrefix(message.timestampNs, message.level);
+            mBatch.append(message.text, message.length);
+        }
+
+        if (dropped != 0)
+        {
+            char notice[64];
+            snprintf(notice, sizeof(notice), "log dropped %" PRIu64 " messages\n", dropped);
+            AppendPrefix(mMessages.empty() ? 0 : mMessages.back().timestampNs, LOG_LEVEL_WARNING);
+            mBatch.append(notice);
+        }
+
+        if (!mBatch.empty())
+        {
+            mSink(mSinkContext, mBatch.data(), mBatch.size());
+        }
+    }
+
+    uint64_t Dropped()
+    {
+        std::lock_guard<std::mutex> lock(mRingsMutex);
+        uint64_t dropped = 0;
+        for (auto& ring : mRings)
+        {
+            dropped += ring->Dropped();
+        }
+        return dropped;
+    }
+
+private:
+    /**
+     * @brief RingOwner - releases the thread's ring for reuse once the
+     *        thread exits. Its unflushed messages are still written.
+     */
+    struct RingOwner
+    {
+        LogRing* ring = nullptr;
+
+        ~RingOwner()
+        {
+            if (ring != nullptr)
+            {
+                ring->Release();
+            }
+        }
+    };
+
+    Logger() :
+        mEpoch(std::chrono::steady_clock::now())
+    {
+        mThread = std::thread(&Logger::Run, this);
+    }
+
+    LogRing* AcquireRing()
+    {
+        std::lock_guard<std::mutex> lock(mRingsMutex);
+        for (auto& ring : mRings)
+        {
+            if (ring->TryAcquire())
+            {
+                tRingOwner.ring = ring.get();
+                return tRingOwner.ring;
+            }
+        }
+
+        mRings.emplace_back(new LogRing());
+        mRings.back()->TryAcquire(); //always succeeds, the ring is new
+        tRingOwner.ring = mRings.back().get();
+        return tRingOwner.ring;
+    }
+
+    void AppendPrefix(uint64_t timestampNs, int level)
+    {
+        static constexpr char Levels[] = { '-', 'E', 'W', 'I', 'D' };
+        char prefix[32];
+        char letter = ((level >= 0) && (level <= LOG_LEVEL_DEBUG)) ? Levels[level] : '?';
+        snprintf(prefix, sizeof(prefix), "[%" PRIu64 ".%06" PRIu64 "] %c ",
+                 timestampNs / 1000000000, (timestampNs / 1000) % 1000000, letter);
+        mBatch.append(prefix);
+    }
+
+    void Run()
+    {
+        std::unique_lock<std::mutex> lock(mWakeMutex);
+        while (!mStop)
+        {
+            mWakeCondition.wait_for(lock, std::chrono::milliseconds(LOG_FLUSH_INTERVAL_MS),
+                                    [this]() { return mStop || mWake.load(); });
+            mWake = false;
+            lock.unlock();
+            Flush();
+            lock.lock();
+        }
+    }
+
+    static thread_local RingOwner tRingOwner;
+
+    const std::chrono::steady_clock::time_point mEpoch;
+    std::mutex mRingsMutex;
+    std::vector<std::unique_ptr<LogRing>> mRings;
+
+    std::mutex mDrainMutex;
+    LogSinkFunction mSink = WriteToStderr;
+    void* mSinkContext = nullptr;
+    std::vector<LogMessage> mMessages; //drain mutex only, reused across flushes
+    std::string mBatch;
+
+    std::mutex mWakeMutex;
+    std::condition_variable mWakeCondition;
+    std::atomic<bool> mWake{false};
+    bool mStop = false;
+    std::thread mThread;
+};
+
+thread_local Logger::RingOwner Logger::tRingOwner;
+
+} // namespace cms
+
+void vLogPrintf(int level, const char* pcFormat, ...)
+{
+    va_list args;
+    va_start(args, pcFormat);
+    cms::Logger::Instance().Write(level, pcFormat, args);
+    va_end(args);
+}
+
+void vLogSetSink(LogSinkFunction pxSink, void* pvContext)
+{
+    cms::Logger::Instance().SetSink(pxSink, pvContext);
+}
+
+void vLogFlush(void)
+{
+    cms::Logger::Instance().Flush();
+}
+
+uint64_t uxLogGetDroppedCount(void)
+{
+    return cms::Logger::Instance().Dropped();
+}
@@ -1,177 +1,281 @@
 //
 // Created by Matthew Eshleman on 4/9/21.
 //
-#include <mutex>
-#include <vector>
-#include <deque>
-#include <condition_variable>
-#include <cstring>
+#include <cmath>
 #include "fauxQueue.h"
+#include "fauxStdQueue.hpp"
+#include "fauxLockFreeQueue.hpp"
 
-namespace cms
+QueueHandle_t xQueueCreate(size_t uxQueueLength, size_t uxItemSize)
 {
+    return xQueueCreateWithMode(uxQueueLength, uxItemSize, QUEUE_MODE_STANDARD);
+}
 
-class StdQueue
+QueueHandle_t xQueueCreateWithMode(size_t uxQueueLength, size_t uxItemSize, QueueModeT mode)
 {
-public:
-    using LockGuard = std::unique_lock<std::mutex>;
-
-    explicit StdQueue(size_t queueDepth, size_t eventSize) :
-        mQueueDepth(queueDepth),
-        mEventSize(eventSize),
-        mCondVar(),
-        mMutex(),
-        mQueue()
+    cms::QueueInterface* queue = nullptr;
+    switch (mode)
     {
+    case QUEUE_MODE_SPSC:
+        queue = new cms::SpscQueue(uxQueueLength, uxItemSize);
+        break;
+    case QUEUE_MODE_MPSC:
+        queue = new cms::MpscQueue(uxQueueLength, uxItemSize);
+        break;
+    case QUEUE_MODE_STANDARD: //purposeful fallthrough
+    default:
+        queue = new cms::StdQueue(uxQueueLength, uxItemSize);
+        break;
     }
 
-    ~StdQueue()
-    {
-    }
+    return queue;
+}
 
-    size_t Count() const
+QueueHandle_t xQueueCreateWithLanes(size_t uxLaneCount, const size_t* puxLaneDepths, size_t uxItemSize)
+{
+    if ((puxLaneDepths == nullptr) || (uxLaneCount == 0) || (uxLaneCount > QUEUE_MAX_LANES))
     {
-        LockGuard lockQueue(mMutex);
-        return mQueue.size();
+        return nullptr;
     }
 
-    bool Post(const void * item)
+    for (size_t i = 0; i < uxLaneCount; ++i)
     {
-        LockGuard lockQueue(mMutex);
-        auto queueSize = mQueue.size();
-        if (queueSize < mQueueDepth)
+        if (puxLaneDepths[i] == 0)
         {
-            EventT qEvent;
-            qEvent.resize(mEventSize);
-            memcpy(qEvent.data(), item, mEventSize);
-
-            mQueue.push_back(qEvent);
-            lockQueue.unlock();
-            if (queueSize == 0)
-            {
-                mCondVar.notify_one();
-            }
-            return true;
-        }
-        else
-        {
-            return false;
+            return nullptr;
         }
     }
 
-    bool PostUrgent(const void * item)
+    return new cms::StdQueue(puxLaneDepths, uxLaneCount, uxItemSize);
+}
+
+void vQueueDelete( QueueHandle_t xQueue )
+{
+    auto queue = static_cast<cms::QueueInterface*>(xQueue);
+    if (queue != nullptr)
     {
-        LockGuard lockQueue(mMutex);
-        auto queueSize = mQueue.size();
-        if (queueSize < mQueueDepth)
-        {
-            EventT qEvent;
-            qEvent.resize(mEventSize);
-            memcpy(qEvent.data(), item, mEventSize);
-
-            mQueue.push_front(qEvent);
-            lockQueue.unlock();
-
-            if (queueSize == 0)
-            {
-                mCondVar.notify_one();
-            }
-            return true;
-        }
-        else
-        {
-            return false;
-        }
+        delete queue;
     }
+}
 
-    bool Receive(void *pvBuffer)
+bool xQueueSendToBack(QueueHandle_t xQueue, const void* pvItemToQueue)
+{
+    return xQueueSendToBackTimed(xQueue, pvItemToQueue, 0);
+}
+
+bool xQueueSendToFront(QueueHandle_t xQueue, const void* pvItemToQueue)
+{
+    return xQueueSendToFrontTimed(xQueue, pvItemToQueue, 0);
+}
+
+bool xQueueReceive(QueueHandle_t xQueue, void *pvBuffer)
+{
+    return xQueueReceiveTimed(xQueue, pvBuffer, portMAX_DELAY);
+}
+
+bool xQueueSendToBackTimed(QueueHandle_t xQueue, const void* pvItemToQueue, TickType_t xTicksToWait)
+{
+    auto queue = static_cast<cms::QueueInterface*>(xQueue);
+    if (queue == nullptr)
     {
-        LockGuard lockQueue(mMutex);
+        return false;
+    }
 
-        EventT event;
+    return queue->Post(pvItemToQueue, xTicksToWait);
+}
 
-        while (mQueue.empty())
-        {
-            mCondVar.wait(lockQueue);
-        }
+bool xQueueSendToFrontTimed(QueueHandle_t xQueue, const void* pvItemToQueue, TickType_t xTicksToWait)
+{
+    auto queue = static_cast<cms::QueueInterface*>(xQueue);
+    if (queue == nullptr)
+    {
+        return false;
+    }
+
+    return queue->PostUrgent(pvItemToQueue, xTicksToWait);
+}
 
-        event = mQueue.front();
-        mQueue.pop_front();
+bool xQueueReceiveTimed(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait)
+{
+    auto queue = static_cast<cms::QueueInterface*>(xQueue);
+    if (queue == nullptr)
+    {
+        return false;
+    }
 
-        memcpy(pvBuffer, event.data(), mEventSize);
+    return queue->Receive(pvBuffer, xTicksToWait);
+}
 
-        lockQueue.unlock();
+bool xQueueReceiveBatch(QueueHandle_t xQueue, void *pvBuffer, size_t uxMaxItems, size_t* puxReceived)
+{
+    return xQueueReceiveBatchTimed(xQueue, pvBuffer, uxMaxItems, puxReceived, portMAX_DELAY);
+}
 
-        return true;
+bool xQueueReceiveBatchTimed(QueueHandle_t xQueue, void *pvBuffer, size_t uxMaxItems, size_t* puxReceived,
+                             TickType_t xTicksToWait)
+{
+    auto queue = static_cast<cms::QueueInterface*>(xQueue);
+    if ((queue == nullptr) || (puxReceived == nullptr))
+    {
+        return false;
     }
 
-private:
-    using EventT = std::vector<uint8_t>;
-    const size_t mQueueDepth;
-    const size_t mEventSize;
-    std::condition_variable mCondVar;
-    mutable std::mutex mMutex;
-    std::deque<EventT> mQueue;
-};
+    *puxReceived = queue->ReceiveBatch(pvBuffer, uxMaxItems, xTicksToWait);
+    return *puxReceived != 0;
+}
 
-} // namespace cms
+size_t uxQueueMessagesWaiting(const QueueHandle_t xQueue)
+{
+    auto queue = static_cast<cms::QueueInterface*>(xQueue);
+    if (queue == nullptr)
+    {
+        return 0;
+    }
 
+    return queue->Count();
+}
 
-QueueHandle_t xQueueCreate(size_t uxQueueLength, size_t uxItemSize)
+bool xQueueSendToLane(QueueHandle_t xQueue, const void* pvItemToQueue, size_t uxLane)
 {
-    auto queue = new cms::StdQueue(uxQueueLength, uxItemSize);
-    return queue;
+    return xQueueSendToLaneTimed(xQueue, pvItemToQueue, uxLane, 0);
 }
 
-void vQueueDelete( QueueHandle_t xQueue )
+bool xQueueSendToLaneTimed(QueueHandle_t xQueue, const void* pvItemToQueue, size_t uxLane,
+                           TickType_t xTicksToWait)
 {
-    auto queue = static_cast<cms::StdQueue*>(xQueue);
-    if (queue != nullptr)
+    auto queue = static_cast<cms::QueueInterface*>(xQueue);
+    if (queue == nullptr)
     {
-        delete queue;
+        return false;
     }
+
+    return queue->PostToLane(pvItemToQueue, uxLane, xTicksToWait);
 }
 
-bool xQueueSendToBack(QueueHandle_t xQueue, const void* pvItemToQueue)
+size_t uxQueueLaneMessagesWaiting(const QueueHandle_t xQueue, size_t uxLane)
 {
-    auto queue = static_cast<cms::StdQueue*>(xQueue);
+    auto queue = static_cast<cms::QueueInterface*>(xQueue);
     if (queue == nullptr)
     {
-        return false;
+        return 0;
     }
 
-    return queue->Post(pvItemToQueue);
+    return queue->LaneCount(uxLane);
 }
 
-bool xQueueSendToFront(QueueHandle_t xQueue, const void* pvItemToQueue)
+bool xQueueHasItemsAboveLane(const QueueHandle_t xQueue, size_t uxLane)
 {
-    auto queue = static_cast<cms::StdQueue*>(xQueue);
+    auto queue = static_cast<cms::QueueInterface*>(xQueue);
     if (queue == nullptr)
     {
         return false;
     }
 
-    return queue->PostUrgent(pvItemToQueue);
+    return queue->HasItemsAboveLane(uxLane);
 }
 
-bool xQueueReceive(QueueHandle_t xQueue, void *pvBuffer)
+void vQueueSetPostCallback(QueueHandle_t xQueue, QueuePostCallback_t pxCallback, void* pvContext)
 {
-    auto queue = static_cast<cms::StdQueue*>(xQueue);
-    if (queue == nullptr)
+    auto queue = static_cast<cms::QueueInterface*>(xQueue);
+    if (queue != nullptr)
+    {
+        queue->SetPostCallback(pxCallback, pvContext);
+    }
+}
+
+bool xQueueSetCoalescing(QueueHandle_t xQueue, uint32_t ulSignal, QueueCoalesceT mode, uint8_t ucClass)
+{
+    auto queue = static_cast<cms::QueueInterface*>(xQueue);
+    if ((queue == nullptr) || (ulSignal >= QUEUE_COALESCE_MAX_SIGNALS) || (ucClass >= QUEUE_COALESCE_MAX_CLASSES))
     {
         return false;
     }
 
-    return queue->Receive(pvBuffer);
+    return queue->SetCoalescing(ulSignal, mode, ucClass);
 }
 
-size_t uxQueueMessagesWaiting(const QueueHandle_t xQueue)
+void vQueueEnableStats(QueueHandle_t xQueue, bool xEnable)
 {
-    auto queue = static_cast<cms::StdQueue*>(xQueue);
-    if (queue == nullptr)
+    auto queue = static_cast<cms::QueueInterface*>(xQueue);
+    if (queue != nullptr)
+    {
+        queue->Statistics().Enable(xEnable);
+    }
+}
+
+bool xQueueGetStats(const QueueHandle_t xQueue, QueueStatsT* pxStats)
+{
+    auto queue = static_cast<cms::QueueInterface*>(xQueue);
+    if ((queue == nullptr) || (pxStats == nullptr))
+    {
+        return false;
+    }
+
+    queue->Statistics().Get(pxStats, queue->Count());
+    return true;
+}
+
+void vQueueResetStats(QueueHandle_t xQueue)
+{
+    auto queue = static_cast<cms::QueueInterface*>(xQueue);
+    if (queue != nullptr)
+    {
+        queue->Statistics().Reset();
+    }
+}
+
+uint64_t uxQueueStatsBucketLowerBoundNs(size_t uxBucket)
+{
+    if (uxBucket >= QUEUE_STATS_LATENCY_BUCKETS)
+    {
+        uxBucket = QUEUE_STATS_LATENCY_BUCKETS - 1;
+    }
+
+    return cms::QueueStatistics::BucketLowerBound(uxBucket);
+}
+
+uint64_t uxQueueStatsLatencyPercentileNs(const QueueStatsT* pxStats, double dPercentile)
+{
+    if (pxStats == nullptr)
     {
         return 0;
     }
 
-    return queue->Count();
+    uint64_t total = 0;
+    for (auto count : pxStats->latencyHistogram)
+    {
+        total += count;
+    }
+
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    if (dPercentile < 0.0)
+    {
+        dPercentile = 0.0;
+    }
+    else if (dPercentile > 100.0)
+    {
+        dPercentile = 100.0;
+    }
+
+    auto target = static_cast<uint64_t>(std::ceil((dPercentile / 100.0) * static_cast<double>(total)));
+    if (target == 0)
+    {
+        target = 1;
+    }
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < QUEUE_STATS_LATENCY_BUCKETS - 1; ++i)
+    {
+        seen += pxStats->latencyHistogram[i];
+        if (seen >= target)
+        {
+            return cms::QueueStatistics::BucketLowerBound(i + 1) - 1;
+        }
+    }
+
+    return cms::QueueStatistics::BucketLowerBound(QUEUE_STATS_LATENCY_BUCKETS - 1);
 }
@@ -0,0 +1,149 @@
+//
+// Internal interface implemented by each faux RTOS queue variant.
+// The C API in fauxQueue.cpp dispatches through this interface.
+//
+
+#ifndef FAUXQUEUEINTERFACE_HPP
+#define FAUXQUEUEINTERFACE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include "fauxQueue.h"
+#include "fauxQueueStats.hpp"
+
+namespace cms
+{
+
+/**
+ * @brief cache line size used to pad indices that are written
+ *        by different threads.
+ */
+static constexpr size_t CacheLineSize = 64;
+
+class QueueInterface
+{
+public:
+    QueueInterface() :
+        mStats(),
+        mPostCallback(nullptr),
+        mPostContext(nullptr),
+        mPostCallbacksInFlight(0)
+    {
+    }
+
+    virtual ~QueueInterface() = default;
+
+    /**
+     * @note: ticksToWait of 0 never blocks, portMAX_DELAY blocks forever.
+     *        Each method returns false if the timeout expired.
+     */
+    virtual size_t Count() const = 0;
+    virtual bool Post(const void* item, TickType_t ticksToWait) = 0;
+    virtual bool PostUrgent(const void* item, TickType_t ticksToWait) = 0;
+    virtual bool Receive(void* pvBuffer, TickType_t ticksToWait) = 0;
+
+    /**
+     * @brief ReceiveBatch - wait for at least one event, then copy up to
+     *        maxItems pending events, in queue order, into pvBuffer.
+     * @return the number of events copied, 0 if the timeout expired.
+     */
+    virtual size_t ReceiveBatch(void* pvBuffer, size_t maxItems, TickType_t ticksToWait) = 0;
+
+    /**
+     * @brief PostToLane - see xQueueSendToLaneTimed().
+     * @return false if the lane does not exist, or the queue variant has no lanes.
+     */
+    virtual bool PostToLane(const void* item, size_t lane, TickType_t ticksToWait)
+    {
+        (void)item;
+        (void)lane;
+        (void)ticksToWait;
+        return false;
+    }
+
+    /**
+     * @brief LaneCount - events pending in a lane. Queue variants
+     *        without lanes have a single lane 0.
+     */
+    virtual size_t LaneCount(size_t lane) const
+    {
+        return (lane == 0) ? Count() : 0;
+    }
+
+    /**
+     * @brief HasItemsAboveLane - see xQueueHasItemsAboveLane().
+     *        Queue variants without lanes have nothing above lane 0.
+     */
+    virtual bool HasItemsAboveLane(size_t lane) const
+    {
+        (void)lane;
+        return false;
+    }
+
+    /**
+     * @brief SetCoalescing - see xQueueSetCoalescing().
+     * @return false if the queue variant does not coalesce.
+     */
+    virtual bool SetCoalescing(uint32_t signal, QueueCoalesceT mode, uint8_t coalesceClass)
+    {
+        (void)signal;
+        (void)mode;
+        (void)coalesceClass;
+        return false;
+    }
+
+    /**
+     * @brief SetPostCallback - install or (with nullptr) remove the
+     *        callback. Returns only once no thread is still executing
+     *        the previous callback, so its context may then be released.
+     */
+    void SetPostCallback(QueuePostCallback_t callback, void* context)
+    {
+        mPostCallback.store(nullptr);
+        while (mPostCallbacksInFlight.load() != 0)
+        {
+            std::this_thread::yield();
+        }
+
+        mPostContext.store(context);
+        mPostCallback.store(callback);
+    }
+
+    QueueStatistics& Statistics()
+    {
+        return mStats;
+    }
+
+protected:
+    /**
+     * @brief NotifyPosted - implementations call this after each
+     *        successful post, outside of any internal lock.
+     */
+    void NotifyPosted()
+    {
+        if (mPostCallback.load(std::memory_order_relaxed) == nullptr)
+        {
+            return;
+        }
+
+        mPostCallbacksInFlight.fetch_add(1);
+        auto callback = mPostCallback.load();
+        if (callback != nullptr)
+        {
+            callback(mPostContext.load());
+        }
+        mPostCallbacksInFlight.fetch_sub(1);
+    }
+
+    QueueStatistics mStats;
+
+private:
+    std::atomic<QueuePostCallback_t> mPostCallback;
+    std::atomic<void*> mPostContext;
+    std::atomic<size_t> mPostCallbacksInFlight;
+};
+
+} // namespace cms
+
+#endif //FAUXQUEUEINTERFACE_HPP
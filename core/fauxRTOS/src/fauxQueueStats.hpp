@@ -0,0 +1,178 @@
+//
+// QueueStatistics - cheap, optional, per queue statistics.
+// All counters are relaxed atomics, updated outside of any lock
+// where possible, so statistics may be left enabled in production.
+//
+
+#ifndef FAUXQUEUESTATS_HPP
+#define FAUXQUEUESTATS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "fauxQueue.h"
+
+namespace cms
+{
+
+class QueueStatistics
+{
+public:
+    QueueStatistics() :
+        mEnabled(false),
+        mNormalPosts(0),
+        mUrgentPosts(0),
+        mFullRejections(0),
+        mCoalescedPosts(0),
+        mReceives(0),
+        mHighWaterMark(0),
+        mLatency()
+    {
+        Reset();
+    }
+
+    void Enable(bool enable)
+    {
+        mEnabled.store(enable, std::memory_order_relaxed);
+    }
+
+    bool Enabled() const
+    {
+        return mEnabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Timestamp - steady clock nanoseconds, 0 while disabled.
+     */
+    uint64_t Timestamp() const
+    {
+        return Enabled() ? NowNs() : 0;
+    }
+
+    void OnPost(bool urgent, size_t depthAfterPost)
+    {
+        if (!Enabled())
+        {
+            return;
+        }
+
+        (urgent ? mUrgentPosts : mNormalPosts).fetch_add(1, std::memory_order_relaxed);
+        size_t highWater = mHighWaterMark.load(std::memory_order_relaxed);
+        while ((depthAfterPost > highWater) &&
+               !mHighWaterMark.compare_exchange_weak(highWater, depthAfterPost, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void OnFull()
+    {
+        if (Enabled())
+        {
+            mFullRejections.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void OnCoalesced()
+    {
+        if (Enabled())
+        {
+            mCoalescedPosts.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @param now: a Timestamp() taken when the event was received.
+     */
+    void OnReceive(uint64_t enqueueTimestamp, uint64_t now)
+    {
+        if (!Enabled())
+        {
+            return;
+        }
+
+        mReceives.fetch_add(1, std::memory_order_relaxed);
+        if ((enqueueTimestamp != 0) && (now != 0))
+        {
+            uint64_t latency = (now > enqueueTimestamp) ? (now - enqueueTimestamp) : 0;
+            mLatency[BucketIndex(latency)].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void Get(QueueStatsT* stats, size_t currentDepth) const
+    {
+        stats->normalPosts = mNormalPosts.load(std::memory_order_relaxed);
+        stats->urgentPosts = mUrgentPosts.load(std::memory_order_relaxed);
+        stats->fullRejections = mFullRejections.load(std::memory_order_relaxed);
+        stats->coalescedPosts = mCoalescedPosts.load(std::memory_order_relaxed);
+        stats->receives = mReceives.load(std::memory_order_relaxed);
+        stats->highWaterMark = mHighWaterMark.load(std::memory_order_relaxed);
+        stats->currentDepth = currentDepth;
+        for (size_t i = 0; i < QUEUE_STATS_LATENCY_BUCKETS; ++i)
+        {
+            stats->latencyHistogram[i] = mLatency[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    void Reset()
+    {
+        mNormalPosts = 0;
+        mUrgentPosts = 0;
+        mFullRejections = 0;
+        mCoalescedPosts = 0;
+        mReceives = 0;
+        mHighWaterMark = 0;
+        for (auto& bucket : mLatency)
+        {
+            bucket = 0;
+        }
+    }
+
+    /**
+     * @brief BucketIndex - log2 buckets, each split into four linear
+     *        sub-buckets (HDR histogram style, ~25% resolution).
+     */
+    static size_t BucketIndex(uint64_t ns)
+    {
+        if (ns < 4)
+        {
+            return static_cast<size_t>(ns);
+        }
+
+        auto msb = static_cast<size_t>(63 - __builtin_clzll(ns));
+        size_t sub = static_cast<size_t>(ns >> (msb - 2)) & 0x3;
+        size_t index = ((msb - 1) * 4) + sub;
+        return (index < QUEUE_STATS_LATENCY_BUCKETS) ? index : (QUEUE_STATS_LATENCY_BUCKETS - 1);
+    }
+
+    static uint64_t BucketLowerBound(size_t index)
+    {
+        if (index < 4)
+        {
+            return index;
+        }
+
+        size_t msb = (index / 4) + 1;
+        uint64_t sub = index % 4;
+        return (4 + sub) << (msb - 2);
+    }
+
+private:
+    static uint64_t NowNs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    std::atomic<bool> mEnabled;
+    std::atomic<uint64_t> mNormalPosts;
+    std::atomic<uint64_t> mUrgentPosts;
+    std::atomic<uint64_t> mFullRejections;
+    std::atomic<uint64_t> mCoalescedPosts;
+    std::atomic<uint64_t> mReceives;
+    std::atomic<size_t> mHighWaterMark;
+    std::atomic<uint64_t> mLatency[QUEUE_STATS_LATENCY_BUCKETS];
+};
+
+} // namespace cms
+
+#endif //FAUXQUEUESTATS_HPP
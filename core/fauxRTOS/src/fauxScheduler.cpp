@@ -0,0 +1,476 @@
+//
+// M:N active object scheduler for the faux RTOS.
+//
+#include "fauxScheduler.h"
+#include "fauxSimulation.h"
+#include "fauxTimer.h"
+#include "fauxQueueInterface.hpp"
+#include "fauxWaiter.hpp"
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace cms
+{
+
+/**
+ * @brief ScheduledObject - an active object's scheduling state.
+ *        IDLE:     no pending work known, not in any run queue.
+ *        QUEUED:   in exactly one worker run queue.
+ *        RUNNING:  a worker is dispatching its events.
+ *        NOTIFIED: running, and more events arrived meanwhile.
+ */
+struct ScheduledObject
+{
+    enum State : int
+    {
+        IDLE,
+        QUEUED,
+        RUNNING,
+        NOTIFIED
+    };
+
+    QueueHandle_t queue;
+    SchedulerDispatchFunction_t dispatch;
+    void* context;
+    std::atomic<int> state;
+    std::atomic<bool> removed;
+};
+
+class Scheduler
+{
+public:
+    //events dispatched per turn, before yielding the worker to other objects.
+    static constexpr size_t EventBudget = 16;
+
+    /**
+     * @param workerCount: 0 - simulated, see fauxSimulation.h. No worker
+     *        runs, objects are only dispatched by SimulationStep().
+     */
+    Scheduler(size_t workerCount, uint32_t seed) :
+        mRunQueues(workerCount),
+        mWorkAvailable(),
+        mStopping(false),
+        mNextRunQueue(0),
+        mSimulated(workerCount == 0),
+        mRandom(seed),
+        mObjectsMutex(),
+        mObjects(),
+        mReady()
+    {
+    }
+
+    bool IsSimulated() const
+    {
+        return mSimulated;
+    }
+
+    void Add(ScheduledObject* object)
+    {
+        std::lock_guard<std::mutex> lock(mObjectsMutex);
+        mObjects.push_back(object);
+    }
+
+    void Remove(ScheduledObject* object)
+    {
+        std::lock_guard<std::mutex> lock(mObjectsMutex);
+        for (auto it = mObjects.begin(); it != mObjects.end(); ++it)
+        {
+            if (*it == object)
+            {
+                mObjects.erase(it);
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief SimulationStep - dispatch a single event of one object, chosen
+     *        at random (from the seeded generator) among the objects with
+     *        pending events. An object whose dispatch reports it is finished
+     *        is not chosen again.
+     * @return false: no object had pending events.
+     */
+    bool SimulationStep()
+    {
+        ScheduledObject* object = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mObjectsMutex);
+            mReady.clear();
+            for (auto candidate : mObjects)
+            {
+                if (!candidate->removed.load() && (uxQueueMessagesWaiting(candidate->queue) != 0))
+                {
+                    mReady.push_back(candidate);
+                }
+            }
+
+            if (mReady.empty())
+            {
+                return false;
+            }
+
+            object = mReady[mRandom() % mReady.size()];
+        }
+
+        if (!object->dispatch(object->context))
+        {
+            object->removed.store(true);
+        }
+        return true;
+    }
+
+    size_t WorkerCount() const
+    {
+        return mRunQueues.size();
+    }
+
+    void Stop()
+    {
+        mStopping.store(true);
+        mWorkAvailable.NotifyIfWaiting();
+    }
+
+    /**
+     * @brief Notify - called whenever an event is posted to the object's queue.
+     */
+    void Notify(ScheduledObject* object)
+    {
+        if (mSimulated)
+        {
+            return; //SimulationStep() polls the queues
+        }
+
+        //always a read-modify-write, even when nothing changes, so the
+        //worker which next takes the object observes this post.
+        int state = object->state.load();
+        while (true)
+        {
+            int next = state;
+            if (state == ScheduledObject::IDLE)
+            {
+                next = ScheduledObject::QUEUED;
+            }
+            else if (state == ScheduledObject::RUNNING)
+            {
+                next = ScheduledObject::NOTIFIED;
+            }
+
+            if (object->state.compare_exchange_weak(state, next))
+            {
+                if (state == ScheduledObject::IDLE)
+                {
+                    Enqueue(object);
+                }
+                return;
+            }
+        }
+    }
+
+    void RunWorker(size_t index)
+    {
+        tWorkerIndex = index;
+        while (true)
+        {
+            ScheduledObject* object = nullptr;
+            mWorkAvailable.WaitUntil([this, &object, index]() {
+                object = FindWork(index);
+                return (object != nullptr) || mStopping.load();
+            }, portMAX_DELAY);
+
+            if (object == nullptr)
+            {
+                return; //stopping
+            }
+
+            Run(object);
+        }
+    }
+
+private:
+    struct alignas(CacheLineSize) RunQueue
+    {
+        std::mutex mutex;
+        std::deque<ScheduledObject*> objects;
+    };
+
+    void Enqueue(ScheduledObject* object)
+    {
+        //a worker keeps work it creates local; other threads spread work round robin.
+        size_t index = (tWorkerIndex != NoWorker) ? tWorkerIndex : (mNextRunQueue.fetch_add(1, std::memory_order_relaxed) % mRunQueues.size());
+        {
+            std::lock_guard<std::mutex> lock(mRunQueues[index].mutex);
+            mRunQueues[index].objects.push_back(object);
+        }
+        mWorkAvailable.NotifyIfWaiting();
+    }
+
+    /**
+     * @brief FindWork - the worker's own run queue first (oldest first),
+     *        then steal the newest entry from another worker.
+     */
+    ScheduledObject* FindWork(size_t index)
+    {
+        const size_t count = mRunQueues.size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            RunQueue& runQueue = mRunQueues[(index + i) % count];
+            std::lock_guard<std::mutex> lock(runQueue.mutex);
+            if (!runQueue.objects.empty())
+            {
+                ScheduledObject* object;
+                if (i == 0)
+                {
+                    object = runQueue.objects.front();
+                    runQueue.objects.pop_front();
+                }
+                else
+                {
+                    object = runQueue.objects.back();
+                    runQueue.objects.pop_back();
+                }
+                return object;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void Run(ScheduledObject* object)
+    {
+        object->state.exchange(ScheduledObject::RUNNING);
+
+        bool budgetExhausted = false;
+        if (!object->removed.load())
+        {
+            size_t dispatched = 0;
+            while (object->dispatch(object->context))
+            {
+                if (++dispatched == EventBudget)
+                {
+                    budgetExhausted = true;
+                    break;
+                }
+            }
+        }
+
+        //after the final store to IDLE this worker must not touch the object,
+        //vSchedulerUnregister() may release it.
+        int expected = ScheduledObject::RUNNING;
+        if (!budgetExhausted && object->state.compare_exchange_strong(expected, ScheduledObject::IDLE))
+        {
+            return;
+        }
+
+        if (object->removed.load())
+        {
+            object->state.store(ScheduledObject::IDLE);
+            return;
+        }
+
+        object->state.store(ScheduledObject::QUEUED);
+        Enqueue(object);
+    }
+
+    static constexpr size_t NoWorker = static_cast<size_t>(-1);
+    static thread_local size_t tWorkerIndex;
+
+    std::vector<RunQueue> mRunQueues;
+    Waiter mWorkAvailable;
+    std::atomic<bool> mStopping;
+    std::atomic<size_t> mNextRunQueue;
+    const bool mSimulated;
+    std::mt19937 mRandom;
+    std::mutex mObjectsMutex;
+    std::vector<ScheduledObject*> mObjects;
+    std::vector<ScheduledObject*> mReady;
+};
+
+thread_local size_t Scheduler::tWorkerIndex = Scheduler::NoWorker;
+
+} // namespace cms
+
+static std::unique_ptr<cms::Scheduler> s_scheduler;
+static std::vector<TaskHandle_t> s_workers;
+static std::atomic<size_t> s_nextWorkerIndex(0);
+
+static void SchedulerWorkerTask()
+{
+    s_scheduler->RunWorker(s_nextWorkerIndex.fetch_add(1));
+}
+
+static void SchedulerPostCallback(void* pvContext)
+{
+    s_scheduler->Notify(static_cast<cms::ScheduledObject*>(pvContext));
+}
+
+bool xSchedulerStart(size_t uxWorkerCount, const TaskOptionsT* pxWorkerOptions)
+{
+    if (s_scheduler)
+    {
+        return false;
+    }
+
+    if (uxWorkerCount == 0)
+    {
+        uxWorkerCount = std::thread::hardware_concurrency();
+        if (uxWorkerCount == 0)
+        {
+            uxWorkerCount = 1;
+        }
+    }
+
+    s_scheduler.reset(new cms::Scheduler(uxWorkerCount, 0));
+    s_nextWorkerIndex = 0;
+    for (size_t i = 0; i < uxWorkerCount; ++i)
+    {
+        TaskHandle_t worker = nullptr;
+        if (!xTaskCreateWithOptions(SchedulerWorkerTask, "faux-worker", 0, pxWorkerOptions, &worker))
+        {
+            vSchedulerStop();
+            return false;
+        }
+        s_workers.push_back(worker);
+    }
+
+    return true;
+}
+
+void vSchedulerStop(void)
+{
+    if (!s_scheduler)
+    {
+        return;
+    }
+
+    s_scheduler->Stop();
+    for (auto worker : s_workers)
+    {
+        vTaskDelete(worker);
+    }
+    s_workers.clear();
+    s_scheduler.reset();
+}
+
+bool xSchedulerIsRunning(void)
+{
+    return static_cast<bool>(s_scheduler);
+}
+
+ScheduledObjectHandle_t xSchedulerRegister(QueueHandle_t xQueue,
+                                           SchedulerDispatchFunction_t pxDispatch,
+                                           void* pvContext)
+{
+    if (!s_scheduler || (xQueue == nullptr) || (pxDispatch == nullptr))
+    {
+        return nullptr;
+    }
+
+    auto object = new cms::ScheduledObject();
+    object->queue = xQueue;
+    object->dispatch = pxDispatch;
+    object->context = pvContext;
+    object->state = cms::ScheduledObject::IDLE;
+    object->removed = false;
+    s_scheduler->Add(object);
+
+    vQueueSetPostCallback(xQueue, SchedulerPostCallback, object);
+
+    //events posted before registration
+    if (uxQueueMessagesWaiting(xQueue) != 0)
+    {
+        s_scheduler->Notify(object);
+    }
+
+    return object;
+}
+
+void vSchedulerUnregister(ScheduledObjectHandle_t xObject)
+{
+    auto object = static_cast<cms::ScheduledObject*>(xObject);
+    if (object == nullptr)
+    {
+        return;
+    }
+
+    //no new notifications, then wait for any queued or running turn to finish.
+    vQueueSetPostCallback(object->queue, nullptr, nullptr);
+    object->removed.store(true);
+    while (object->state.load() != cms::ScheduledObject::IDLE)
+    {
+        std::this_thread::yield();
+    }
+
+    s_scheduler->Remove(object);
+    delete object;
+}
+
+bool xSimulationStart(uint32_t ulSeed)
+{
+    if (s_scheduler || xTimerServiceIsRunning())
+    {
+        return false;
+    }
+
+    if (!xTimerServiceStart(TIMER_CLOCK_VIRTUAL))
+    {
+        return false;
+    }
+
+    s_scheduler.reset(new cms::Scheduler(0, ulSeed));
+    return true;
+}
+
+void vSimulationStop(void)
+{
+    if (!xSimulationIsRunning())
+    {
+        return;
+    }
+
+    vTimerServiceStop();
+    s_scheduler.reset();
+}
+
+bool xSimulationIsRunning(void)
+{
+    return s_scheduler && s_scheduler->IsSimulated();
+}
+
+bool xSimulationStep(void)
+{
+    return xSimulationIsRunning() && s_scheduler->SimulationStep();
+}
+
+size_t uxSimulationRunUntilIdle(size_t uxMaxSteps)
+{
+    size_t steps = 0;
+    while ((steps < uxMaxSteps) && xSimulationStep())
+    {
+        ++steps;
+    }
+    return steps;
+}
+
+size_t uxSimulationRunFor(TickType_t xTicks)
+{
+    size_t steps = 0;
+    while (xSimulationIsRunning())
+    {
+        while (xSimulationStep())
+        {
+            ++steps;
+        }
+
+        if (xTicks == 0)
+        {
+            break;
+        }
+        xTicks -= xTimerAdvanceToNextExpiry(xTicks);
+    }
+    return steps;
+}
@@ -0,0 +1,510 @@
+//
+// StdQueue - the standard faux RTOS queue, protected by a mutex
+// and condition variable.
+//
+
+#ifndef FAUXSTDQUEUE_HPP
+#define FAUXSTDQUEUE_HPP
+
+#include <mutex>
+#include <vector>
+#include <cstdint>
+#include <condition_variable>
+#include <cstring>
+#include "fauxQueueInterface.hpp"
+#include "fauxTicks.hpp"
+#include "fauxTrace.hpp"
+
+namespace cms
+{
+
+/**
+ * @brief StdQueue - fixed slot ring buffers of opaque events, one
+ *        per priority lane. All storage is allocated once at
+ *        construction, events are copied in and out of their slots.
+ *        No allocation takes place after construction.
+ *
+ *        A non-empty lane bitmap finds the highest priority lane
+ *        with pending events in O(1). Events are FIFO within a lane.
+ */
+class StdQueue : public QueueInterface
+{
+public:
+    using LockGuard = std::unique_lock<std::mutex>;
+
+    explicit StdQueue(size_t queueDepth, size_t eventSize) :
+        StdQueue(&queueDepth, 1, eventSize)
+    {
+    }
+
+    /**
+     * @param laneDepths: the depth of each lane, lane 0 has the lowest
+     *        priority. 1 to QUEUE_MAX_LANES lanes, each at least one deep.
+     */
+    StdQueue(const size_t* laneDepths, size_t laneCount, size_t eventSize) :
+        mEventSize(eventSize),
+        mNotEmpty(),
+        mNotFull(),
+        mMutex(),
+        mStorage(TotalDepth(laneDepths, laneCount) * eventSize),
+        mTimestamps(TotalDepth(laneDepths, laneCount)),
+        mLanes(laneCount),
+        mNonEmptyLanes(0),
+        mCount(0),
+        mWaitingReceivers(0),
+        mWaitingSenders(0),
+        mCoalescing(false),
+        mPendingClasses(laneCount, 0),
+        mSignalModes(),
+        mSignalClasses(),
+        mPendingSlots(laneCount * QUEUE_COALESCE_MAX_CLASSES),
+        mSlotClasses(TotalDepth(laneDepths, laneCount), NoClass)
+    {
+        size_t base = 0;
+        for (size_t i = 0; i < laneCount; ++i)
+        {
+            mLanes[i].base = base;
+            mLanes[i].depth = laneDepths[i];
+            base += laneDepths[i];
+        }
+    }
+
+    ~StdQueue() override
+    {
+    }
+
+    /**
+     * @brief Count - wait free, the depth is published under the lock
+     *        and read without it. May lag a concurrent post or receive.
+     */
+    size_t Count() const override
+    {
+        return mCount.load(std::memory_order_relaxed);
+    }
+
+    size_t LaneCount(size_t lane) const override
+    {
+        LockGuard lockQueue(mMutex);
+        return (lane < mLanes.size()) ? mLanes[lane].count : 0;
+    }
+
+    /**
+     * @brief HasItemsAboveLane - wait free, see LaneCount().
+     */
+    bool HasItemsAboveLane(size_t lane) const override
+    {
+        if (lane + 1 >= mLanes.size())
+        {
+            return false;
+        }
+
+        return (mNonEmptyLanes.load(std::memory_order_relaxed) >> (lane + 1)) != 0;
+    }
+
+    bool Post(const void * item, TickType_t ticksToWait) override
+    {
+        return Enqueue(item, 0, ticksToWait, false);
+    }
+
+    bool PostToLane(const void* item, size_t lane, TickType_t ticksToWait) override
+    {
+        if (lane >= mLanes.size())
+        {
+            return false;
+        }
+
+        return Enqueue(item, lane, ticksToWait, false);
+    }
+
+    bool PostUrgent(const void * item, TickType_t ticksToWait) override
+    {
+        //with lanes, urgent events queue in order in the highest lane
+        return Enqueue(item, mLanes.size() - 1, ticksToWait, true);
+    }
+
+    bool Receive(void *pvBuffer, TickType_t ticksToWait) override
+    {
+        LockGuard lockQueue(mMutex);
+        if (!Wait(lockQueue, mNotEmpty, mWaitingReceivers, ticksToWait,
+                  [this]() { return mCount.load(std::memory_order_relaxed) != 0; }))
+        {
+            return false;
+        }
+
+        Lane& lane = mLanes[HighestLane()];
+        size_t index = lane.base + lane.head;
+        memcpy(pvBuffer, SlotAt(index), mEventSize);
+        uint64_t timestamp = mTimestamps[index];
+        if (mCoalescing)
+        {
+            UntrackPending(lane, index);
+        }
+        Consume(lane, 1);
+        size_t depth = SetCount(mCount.load(std::memory_order_relaxed) - 1);
+
+        NotifySenders(lockQueue, 1);
+        mStats.OnReceive(timestamp, mStats.Timestamp());
+        Tracer::Record(TRACE_EVENT_QUEUE_RECEIVE, this, 1, static_cast<uint32_t>(depth));
+        return true;
+    }
+
+    size_t ReceiveBatch(void* pvBuffer, size_t maxItems, TickType_t ticksToWait) override
+    {
+        if (maxItems == 0)
+        {
+            return 0;
+        }
+
+        LockGuard lockQueue(mMutex);
+        if (!Wait(lockQueue, mNotEmpty, mWaitingReceivers, ticksToWait,
+                  [this]() { return mCount.load(std::memory_order_relaxed) != 0; }))
+        {
+            return 0;
+        }
+
+        //drain the lanes in priority order, at most two
+        //contiguous copies per lane: head to end of the lane, then wrapped.
+        auto buffer = static_cast<uint8_t*>(pvBuffer);
+        uint64_t now = mStats.Timestamp();
+        size_t received = 0;
+        while ((received < maxItems) && (mNonEmptyLanes.load(std::memory_order_relaxed) != 0))
+        {
+            Lane& lane = mLanes[HighestLane()];
+            size_t count = (lane.count < (maxItems - received)) ? lane.count : (maxItems - received);
+            size_t firstRun = lane.depth - lane.head;
+            if (firstRun > count)
+            {
+                firstRun = count;
+            }
+
+            memcpy(buffer + (received * mEventSize), SlotAt(lane.base + lane.head), firstRun * mEventSize);
+            memcpy(buffer + ((received + firstRun) * mEventSize), SlotAt(lane.base), (count - firstRun) * mEventSize);
+
+            if (mStats.Enabled() || mCoalescing)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    size_t offset = lane.head + i;
+                    size_t index = lane.base + ((offset < lane.depth) ? offset : (offset - lane.depth));
+                    mStats.OnReceive(mTimestamps[index], now);
+                    if (mCoalescing)
+                    {
+                        UntrackPending(lane, index);
+                    }
+                }
+            }
+
+            Consume(lane, count);
+            received += count;
+        }
+        size_t depth = SetCount(mCount.load(std::memory_order_relaxed) - received);
+
+        NotifySenders(lockQueue, received);
+        Tracer::Record(TRACE_EVENT_QUEUE_RECEIVE, this, static_cast<uint32_t>(received), static_cast<uint32_t>(depth));
+        return received;
+    }
+
+    bool SetCoalescing(uint32_t signal, QueueCoalesceT mode, uint8_t coalesceClass) override
+    {
+        if ((mEventSize < sizeof(uint32_t)) || (signal >= QUEUE_COALESCE_MAX_SIGNALS) ||
+            (coalesceClass >= QUEUE_COALESCE_MAX_CLASSES))
+        {
+            return false;
+        }
+
+        LockGuard lockQueue(mMutex);
+        mSignalModes[signal] = mode;
+        mSignalClasses[signal] = coalesceClass;
+        mCoalescing = true;
+        return true;
+    }
+
+private:
+    static constexpr uint8_t NoClass = 0xFF;
+    static_assert(QUEUE_MAX_LANES <= 32, "the non-empty lane bitmap is 32 bits");
+
+    struct Lane
+    {
+        size_t base = 0;  //first slot of the lane
+        size_t depth = 0;
+        size_t head = 0;  //relative to base
+        size_t count = 0;
+    };
+
+    static size_t TotalDepth(const size_t* laneDepths, size_t laneCount)
+    {
+        size_t total = 0;
+        for (size_t i = 0; i < laneCount; ++i)
+        {
+            total += laneDepths[i];
+        }
+        return total;
+    }
+
+    size_t HighestLane() const
+    {
+        return static_cast<size_t>(31 - __builtin_clz(mNonEmptyLanes.load(std::memory_order_relaxed)));
+    }
+
+    /**
+     * @brief Enqueue - copy the item into its lane.
+     * @param urgent: a xQueueSendToFront*() send. With a single lane, the
+     *        event is placed at the head, with lanes at the tail of its lane.
+     */
+    bool Enqueue(const void* item, size_t laneIndex, TickType_t ticksToWait, bool urgent)
+    {
+        LockGuard lockQueue(mMutex);
+        if (!urgent && mCoalescing && Coalesce(item, laneIndex))
+        {
+            //the receiver was notified of the pending event already
+            lockQueue.unlock();
+            mStats.OnCoalesced();
+            return true;
+        }
+
+        Lane& lane = mLanes[laneIndex];
+        if (!Wait(lockQueue, mNotFull, mWaitingSenders, ticksToWait,
+                  [&lane]() { return lane.count < lane.depth; }))
+        {
+            lockQueue.unlock();
+            mStats.OnFull();
+            return false;
+        }
+
+        size_t offset;
+        if (urgent && (mLanes.size() == 1))
+        {
+            //move the head back one slot, the urgent
+            //event becomes the next event received.
+            lane.head = (lane.head == 0) ? (lane.depth - 1) : (lane.head - 1);
+            offset = lane.head;
+        }
+        else
+        {
+            offset = lane.head + lane.count;
+            if (offset >= lane.depth)
+            {
+                offset -= lane.depth;
+            }
+        }
+
+        size_t index = lane.base + offset;
+        memcpy(SlotAt(index), item, mEventSize);
+        mTimestamps[index] = mStats.Timestamp();
+        if (mCoalescing)
+        {
+            if (urgent)
+            {
+                mSlotClasses[index] = NoClass;
+            }
+            else
+            {
+                TrackPending(item, laneIndex, index);
+            }
+        }
+        ++lane.count;
+        SetNonEmptyLanes(mNonEmptyLanes.load(std::memory_order_relaxed) | (1u << laneIndex));
+        size_t depth = SetCount(mCount.load(std::memory_order_relaxed) + 1);
+        NotifyReceiver(lockQueue);
+        mStats.OnPost(urgent, depth);
+        Tracer::Record(TRACE_EVENT_QUEUE_POST, this, static_cast<uint32_t>(depth), urgent ? 1 : 0,
+                       static_cast<uint32_t>(laneIndex));
+        NotifyPosted();
+        return true;
+    }
+
+    /**
+     * @brief SetCount - called with the lock held, the lock orders
+     *        the writes, relaxed stores suffice for lock free readers.
+     */
+    size_t SetCount(size_t count)
+    {
+        mCount.store(count, std::memory_order_relaxed);
+        return count;
+    }
+
+    /**
+     * @brief SetNonEmptyLanes - as SetCount().
+     */
+    void SetNonEmptyLanes(uint32_t lanes)
+    {
+        mNonEmptyLanes.store(lanes, std::memory_order_relaxed);
+    }
+
+    void Consume(Lane& lane, size_t count)
+    {
+        lane.head += count;
+        if (lane.head >= lane.depth)
+        {
+            lane.head -= lane.depth;
+        }
+        lane.count -= count;
+        if (lane.count == 0)
+        {
+            SetNonEmptyLanes(mNonEmptyLanes.load(std::memory_order_relaxed) &
+                             ~(1u << static_cast<unsigned>(LaneIndex(lane))));
+        }
+    }
+
+    static uint32_t SignalOf(const void* item)
+    {
+        uint32_t signal;
+        memcpy(&signal, item, sizeof(signal));
+        return signal;
+    }
+
+    size_t LaneIndex(const Lane& lane) const
+    {
+        return static_cast<size_t>(&lane - mLanes.data());
+    }
+
+    /**
+     * @brief Coalesce - merge the item into the pending event of its
+     *        class in the same lane, if any, as per the signal's mode.
+     *        Pending events of other lanes are never touched.
+     * @return true if the item needs no slot of its own.
+     */
+    bool Coalesce(const void* item, size_t laneIndex)
+    {
+        uint32_t signal = SignalOf(item);
+        if ((signal >= QUEUE_COALESCE_MAX_SIGNALS) || (mSignalModes[signal] == QUEUE_COALESCE_NONE))
+        {
+            return false;
+        }
+
+        uint8_t coalesceClass = mSignalClasses[signal];
+        if ((mPendingClasses[laneIndex] & (uint64_t(1) << coalesceClass)) == 0)
+        {
+            return false;
+        }
+
+        uint8_t* pending = SlotAt(PendingSlot(laneIndex, coalesceClass));
+        if (mSignalModes[signal] == QUEUE_COALESCE_DROP_IF_PENDING)
+        {
+            return memcmp(pending, item, mEventSize) == 0;
+        }
+
+        memcpy(pending, item, mEventSize);
+        return true;
+    }
+
+    size_t& PendingSlot(size_t laneIndex, uint8_t coalesceClass)
+    {
+        return mPendingSlots[(laneIndex * QUEUE_COALESCE_MAX_CLASSES) + coalesceClass];
+    }
+
+    void TrackPending(const void* item, size_t laneIndex, size_t index)
+    {
+        uint32_t signal = SignalOf(item);
+        if ((signal >= QUEUE_COALESCE_MAX_SIGNALS) || (mSignalModes[signal] == QUEUE_COALESCE_NONE))
+        {
+            return;
+        }
+
+        uint8_t coalesceClass = mSignalClasses[signal];
+        mPendingClasses[laneIndex] |= (uint64_t(1) << coalesceClass);
+        PendingSlot(laneIndex, coalesceClass) = index;
+        mSlotClasses[index] = coalesceClass;
+    }
+
+    void UntrackPending(const Lane& lane, size_t index)
+    {
+        uint8_t coalesceClass = mSlotClasses[index];
+        if (coalesceClass == NoClass)
+        {
+            return;
+        }
+
+        //an older event of the class may be received after
+        //a newer one, which did not coalesce, became pending.
+        size_t laneIndex = LaneIndex(lane);
+        if (PendingSlot(laneIndex, coalesceClass) == index)
+        {
+            mPendingClasses[laneIndex] &= ~(uint64_t(1) << coalesceClass);
+        }
+        mSlotClasses[index] = NoClass;
+    }
+
+    template<typename Predicate>
+    static bool Wait(LockGuard& lock, std::condition_variable& condVar, size_t& waiters,
+                     TickType_t ticksToWait, Predicate predicate)
+    {
+        if (predicate())
+        {
+            return true;
+        }
+
+        if (ticksToWait == 0)
+        {
+            return false;
+        }
+
+        bool ok = true;
+        ++waiters;
+        if (ticksToWait == portMAX_DELAY)
+        {
+            condVar.wait(lock, predicate);
+        }
+        else
+        {
+            ok = condVar.wait_until(lock, TicksToDeadline(ticksToWait), predicate);
+        }
+        --waiters;
+        return ok;
+    }
+
+    void NotifySenders(LockGuard& lock, size_t freedSlots)
+    {
+        //with lanes, a single waiting sender woken may be waiting on another lane
+        bool notifyAll = (mWaitingSenders > 1) && ((freedSlots > 1) || (mLanes.size() > 1));
+        bool notify = (mWaitingSenders != 0);
+        lock.unlock();
+        if (notifyAll)
+        {
+            mNotFull.notify_all();
+        }
+        else if (notify)
+        {
+            mNotFull.notify_one();
+        }
+    }
+
+    void NotifyReceiver(LockGuard& lock)
+    {
+        bool notify = (mWaitingReceivers != 0);
+        lock.unlock();
+        if (notify)
+        {
+            mNotEmpty.notify_one();
+        }
+    }
+
+    uint8_t* SlotAt(size_t index)
+    {
+        return mStorage.data() + (index * mEventSize);
+    }
+
+    const size_t mEventSize;
+    std::condition_variable mNotEmpty;
+    std::condition_variable mNotFull;
+    mutable std::mutex mMutex;
+    std::vector<uint8_t> mStorage;
+    std::vector<uint64_t> mTimestamps;
+    std::vector<Lane> mLanes;
+    std::atomic<uint32_t> mNonEmptyLanes;
+    std::atomic<size_t> mCount;
+    size_t mWaitingReceivers;
+    size_t mWaitingSenders;
+
+    //coalescing, see xQueueSetCoalescing(), pending classes are per lane
+    bool mCoalescing;
+    std::vector<uint64_t> mPendingClasses;
+    QueueCoalesceT mSignalModes[QUEUE_COALESCE_MAX_SIGNALS];
+    uint8_t mSignalClasses[QUEUE_COALESCE_MAX_SIGNALS];
+    std::vector<size_t> mPendingSlots;
+    std::vector<uint8_t> mSlotClasses;
+};
+
+} // namespace cms
+
+#endif //FAUXSTDQUEUE_HPP
@@ -2,30 +2,244 @@
 // Created by Matthew Eshleman on 4/9/21.
 //
 #include "fauxThread.h"
+#include "fauxTrace.h"
+#include <pthread.h>
+#include <sched.h>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <future>
 #include <thread>
+#include <unistd.h>
+#include <sys/resource.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace cms
+{
+
+struct PosixTask
+{
+    pthread_t thread;
+    TaskFunction_t function;
+    TaskParameterFunction_t parameterFunction;
+    void* parameters;
+    char name[16];
+    TaskOptionsT options;
+    std::promise<bool> attributesApplied; //only when applied by the new thread, see AppliedByTask()
+};
+
+static int Clamp(int value, int min, int max)
+{
+    return (value < min) ? min : ((value > max) ? max : value);
+}
+
+static size_t StackSizeBytes(size_t stackDepth)
+{
+    size_t bytes = stackDepth * sizeof(StackType_t);
+    auto minimum = static_cast<size_t>(PTHREAD_STACK_MIN);
+    if (bytes < minimum)
+    {
+        bytes = minimum;
+    }
+
+    auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return ((bytes + pageSize - 1) / pageSize) * pageSize;
+}
+
+/**
+ * @brief AppliedByTask - attributes applied from within the new thread,
+ *        which are confirmed to the creator before the task function runs.
+ */
+static bool AppliedByTask(const TaskOptionsT& options)
+{
+#ifdef __linux__
+    //on Linux the nice value is a per thread attribute.
+    return (options.policy == TASK_SCHED_NORMAL) && (options.priority != 0);
+#else
+    (void)options;
+    return false;
+#endif
+}
+
+/**
+ * @brief TaskEntry - applies the attributes which must be applied
+ *        from within the new thread, then runs the task function.
+ *        If they cannot be applied, the thread exits without running it.
+ */
+static void* TaskEntry(void* arg)
+{
+    auto task = static_cast<PosixTask*>(arg);
+
+#if defined(__APPLE__)
+    pthread_setname_np(task->name);
+#else
+    pthread_setname_np(pthread_self(), task->name);
+#endif
+
+#ifdef __linux__
+    if (AppliedByTask(task->options))
+    {
+        //a nice value below the process limit, for example a negative
+        //nice value without CAP_SYS_NICE, fails the task's creation.
+        auto tid = static_cast<id_t>(syscall(SYS_gettid));
+        bool ok = (setpriority(PRIO_PROCESS, tid, Clamp(-task->options.priority, -20, 19)) == 0);
+        task->attributesApplied.set_value(ok);
+        if (!ok)
+        {
+            return nullptr;
+        }
+    }
+#endif
+
+    vTraceSetThreadName(task->name);
+    if (task->parameterFunction != nullptr)
+    {
+        task->parameterFunction(task->parameters);
+    }
+    else
+    {
+        task->function();
+    }
+    return nullptr;
+}
+
+static bool ApplyAttributes(pthread_attr_t* attr, size_t stackDepth, const TaskOptionsT& options)
+{
+    if ((stackDepth != 0) && (pthread_attr_setstacksize(attr, StackSizeBytes(stackDepth)) != 0))
+    {
+        return false;
+    }
+
+    if (options.policy == TASK_SCHED_REALTIME)
+    {
+        sched_param param = {};
+        param.sched_priority = Clamp(options.priority,
+                                     sched_get_priority_min(SCHED_FIFO),
+                                     sched_get_priority_max(SCHED_FIFO));
+        if ((pthread_attr_setinheritsched(attr, PTHREAD_EXPLICIT_SCHED) != 0) ||
+            (pthread_attr_setschedpolicy(attr, SCHED_FIFO) != 0) ||
+            (pthread_attr_setschedparam(attr, &param) != 0))
+        {
+            return false;
+        }
+    }
+
+#ifdef __linux__
+    if (options.cpuAffinityMask != 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (int cpu = 0; (cpu < 64) && (cpu < CPU_SETSIZE); ++cpu)
+        {
+            if (options.cpuAffinityMask & (UINT64_C(1) << cpu))
+            {
+                CPU_SET(cpu, &cpus);
+            }
+        }
+
+        if (pthread_attr_setaffinity_np(attr, sizeof(cpus), &cpus) != 0)
+        {
+            return false;
+        }
+    }
+#endif
+
+    return true;
+}
+
+/**
+ * @brief StartTask - create the thread of a task, which is released on failure.
+ */
+static bool StartTask(PosixTask* task, const char* pcName, size_t usStackDepth,
+                      const TaskOptionsT* pxOptions, TaskHandle_t* pxCreatedTask)
+{
+    strncpy(task->name, (pcName != nullptr) ? pcName : "", sizeof(task->name) - 1);
+    task->options = (pxOptions != nullptr) ? *pxOptions : TaskOptionsT{ TASK_SCHED_NORMAL, 0, 0 };
+
+    bool appliedByTask = AppliedByTask(task->options);
+    std::future<bool> attributesApplied;
+    if (appliedByTask)
+    {
+        attributesApplied = task->attributesApplied.get_future();
+    }
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    bool ok = ApplyAttributes(&attr, usStackDepth, task->options) &&
+              (pthread_create(&task->thread, &attr, TaskEntry, task) == 0);
+    pthread_attr_destroy(&attr);
+
+    if (ok && appliedByTask && !attributesApplied.get())
+    {
+        pthread_join(task->thread, nullptr);
+        ok = false;
+    }
+
+    if (!ok)
+    {
+        delete task;
+        *pxCreatedTask = nullptr;
+        return false;
+    }
+
+    *pxCreatedTask = static_cast<TaskHandle_t>(task);
+    return true;
+}
+
+} // namespace cms
 
 bool xTaskCreate(TaskFunction_t pxTaskCode, const char *pcName,
                  size_t usStackDepth,
                  TaskHandle_t *pxCreatedTask)
 {
-    (void)pcName;
-    (void)usStackDepth;
+    return xTaskCreateWithOptions(pxTaskCode, pcName, usStackDepth, nullptr, pxCreatedTask);
+}
 
-    auto thread = new std::thread(pxTaskCode);
-    *pxCreatedTask = static_cast<TaskHandle_t>(thread);
-    return true;
+bool xTaskCreateWithOptions(TaskFunction_t pxTaskCode, const char* pcName, size_t usStackDepth,
+                            const TaskOptionsT* pxOptions, TaskHandle_t* pxCreatedTask)
+{
+    if ((pxTaskCode == nullptr) || (pxCreatedTask == nullptr))
+    {
+        return false;
+    }
+
+    auto task = new cms::PosixTask();
+    task->function = pxTaskCode;
+    return cms::StartTask(task, pcName, usStackDepth, pxOptions, pxCreatedTask);
 }
 
-void vTaskDelete(TaskHandle_t handle)
+bool xTaskCreateWithParameters(TaskParameterFunction_t pxTaskCode, const char* pcName, size_t usStackDepth,
+                               void* pvParameters, const TaskOptionsT* pxOptions, TaskHandle_t* pxCreatedTask)
 {
-    auto thread = static_cast<std::thread*>(handle);
-    if (thread != nullptr)
+    if ((pxTaskCode == nullptr) || (pxCreatedTask == nullptr))
     {
-        if (thread->joinable())
-        {
-            thread->join();
-        }
+        return false;
+    }
+
+    auto task = new cms::PosixTask();
+    task->parameterFunction = pxTaskCode;
+    task->parameters = pvParameters;
+    return cms::StartTask(task, pcName, usStackDepth, pxOptions, pxCreatedTask);
+}
 
-        delete thread;
+void vTaskDelete(TaskHandle_t handle)
+{
+    auto task = static_cast<cms::PosixTask*>(handle);
+    if (task != nullptr)
+    {
+        pthread_join(task->thread, nullptr);
+        delete task;
     }
-}
\ No newline at end of file
+}
+
+void vTaskYield(void)
+{
+    sched_yield();
+}
+
+void vTaskDelay(TickType_t xTicksToDelay)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(xTicksToDelay * portTICK_PERIOD_MS));
+}
@@ -0,0 +1,28 @@
+//
+// Conversion of faux RTOS ticks to std::chrono types.
+//
+
+#ifndef FAUXTICKS_HPP
+#define FAUXTICKS_HPP
+
+#include <chrono>
+#include "fauxTypes.h"
+
+namespace cms
+{
+
+using TickClock = std::chrono::steady_clock;
+
+inline std::chrono::milliseconds TicksToDuration(TickType_t ticks)
+{
+    return std::chrono::milliseconds(static_cast<uint64_t>(ticks) * portTICK_PERIOD_MS);
+}
+
+inline TickClock::time_point TicksToDeadline(TickType_t ticks)
+{
+    return TickClock::now() + TicksToDuration(ticks);
+}
+
+} // namespace cms
+
+#endif //FAUXTICKS_HPP
@@ -0,0 +1,398 @@
+//
+// Software timer service for the faux RTOS.
+//
+#include "fauxTimer.h"
+#include "fauxThread.h"
+#include "fauxTicks.hpp"
+#include "fauxTimingWheel.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace cms
+{
+
+struct Timer : public TimingWheel::Node
+{
+    std::string name;
+    TickType_t period;
+    bool autoReload;
+    QueueHandle_t queue;
+    size_t lane; //Timer::NoLane: xQueueSendToBack()
+    std::vector<uint8_t> event;
+    size_t dropped;
+
+    static constexpr size_t NoLane = SIZE_MAX;
+};
+
+/**
+ * @brief TimerService - all timers share one TimingWheel, serialized by a
+ *        single mutex. Expired timers post while holding the mutex, so once
+ *        a timer API call returns, the timer's previous settings are no
+ *        longer in use.
+ */
+class TimerService
+{
+public:
+    explicit TimerService(TimerClockT clock) :
+        mClock(clock),
+        mStart(TickClock::now()),
+        mMutex(),
+        mChanged(),
+        mWheel(),
+        mTimers(),
+        mSleepingUntil(TimingWheel::NoWork),
+        mStopping(false)
+    {
+    }
+
+    ~TimerService()
+    {
+        for (auto timer : mTimers)
+        {
+            delete timer;
+        }
+    }
+
+    TimerClockT Clock() const
+    {
+        return mClock;
+    }
+
+    void Stop()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+        mChanged.notify_all();
+    }
+
+    TickType_t TickCount()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return static_cast<TickType_t>(CurrentTick());
+    }
+
+    Timer* Create(const char* name, TickType_t period, bool autoReload, QueueHandle_t queue,
+                  const void* event, size_t eventSize)
+    {
+        auto timer = new Timer();
+        timer->name = (name != nullptr) ? name : "";
+        timer->period = period;
+        timer->autoReload = autoReload;
+        timer->queue = queue;
+        timer->lane = Timer::NoLane;
+        timer->event.assign(static_cast<const uint8_t*>(event), static_cast<const uint8_t*>(event) + eventSize);
+        timer->dropped = 0;
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTimers.insert(timer);
+        return timer;
+    }
+
+    void Delete(Timer* timer)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mWheel.Remove(timer);
+        mTimers.erase(timer);
+        delete timer;
+    }
+
+    void Start(Timer* timer, TickType_t newPeriod)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (newPeriod != 0)
+        {
+            timer->period = newPeriod;
+        }
+
+        mWheel.Remove(timer);
+        uint64_t expiry = CurrentTick() + timer->period;
+        mWheel.Insert(timer, expiry);
+        if (expiry < mSleepingUntil)
+        {
+            mChanged.notify_all();
+        }
+    }
+
+    void SetLane(Timer* timer, size_t lane)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        timer->lane = lane;
+    }
+
+    void Stop(Timer* timer)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mWheel.Remove(timer);
+    }
+
+    bool IsActive(Timer* timer)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return timer->linked;
+    }
+
+    size_t Dropped(Timer* timer)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return timer->dropped;
+    }
+
+    TickType_t AdvanceVirtual(TickType_t ticks, bool untilExpiry)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        uint64_t start = mWheel.Now();
+        AdvanceTo(start + ticks, untilExpiry);
+        return static_cast<TickType_t>(mWheel.Now() - start);
+    }
+
+    /**
+     * @brief Run - the TIMER_CLOCK_REAL timer thread. Sleeps until the
+     *        wheel's next work, or until a timer is armed to expire sooner.
+     */
+    void Run()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (!mStopping)
+        {
+            AdvanceTo(RealTick());
+
+            uint64_t ticks = mWheel.TicksUntilNextWork();
+            if (ticks == TimingWheel::NoWork)
+            {
+                mSleepingUntil = TimingWheel::NoWork;
+                mChanged.wait(lock);
+            }
+            else
+            {
+                mSleepingUntil = mWheel.Now() + ticks;
+                mChanged.wait_until(lock, mStart + std::chrono::milliseconds(mSleepingUntil * portTICK_PERIOD_MS));
+            }
+        }
+    }
+
+private:
+    uint64_t RealTick() const
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(TickClock::now() - mStart);
+        return static_cast<uint64_t>(elapsed.count()) / portTICK_PERIOD_MS;
+    }
+
+    /**
+     * @brief CurrentTick - the real clock may be ahead of the wheel while
+     *        the timer thread sleeps, new expiries are relative to it.
+     */
+    uint64_t CurrentTick() const
+    {
+        return (mClock == TIMER_CLOCK_REAL) ? RealTick() : mWheel.Now();
+    }
+
+    /**
+     * @brief AdvanceTo - move the wheel to target, or with untilExpiry,
+     *        stop early at the first tick which expired a timer.
+     */
+    void AdvanceTo(uint64_t target, bool untilExpiry = false)
+    {
+        bool expired = false;
+        while ((mWheel.Now() < target) && !expired)
+        {
+            uint64_t idle = mWheel.TicksUntilNextWork() - 1;
+            uint64_t remaining = target - mWheel.Now();
+            if (idle >= remaining)
+            {
+                mWheel.Skip(remaining);
+                break;
+            }
+
+            mWheel.Skip(idle);
+            mWheel.Advance([this, &expired, untilExpiry](TimingWheel::Node* node) {
+                Expire(static_cast<Timer*>(node));
+                expired = untilExpiry;
+            });
+        }
+    }
+
+    void Expire(Timer* timer)
+    {
+        bool posted = (timer->lane == Timer::NoLane) ?
+                      xQueueSendToBack(timer->queue, timer->event.data()) :
+                      xQueueSendToLane(timer->queue, timer->event.data(), timer->lane);
+        if (!posted)
+        {
+            timer->dropped++;
+        }
+
+        if (timer->autoReload)
+        {
+            mWheel.Insert(timer, timer->expiry + timer->period);
+        }
+    }
+
+    const TimerClockT mClock;
+    const TickClock::time_point mStart;
+    std::mutex mMutex;
+    std::condition_variable mChanged;
+    TimingWheel mWheel;
+    std::unordered_set<Timer*> mTimers;
+    uint64_t mSleepingUntil;
+    bool mStopping;
+};
+
+} // namespace cms
+
+static std::unique_ptr<cms::TimerService> s_timerService;
+static TaskHandle_t s_timerThread = nullptr;
+
+static void TimerServiceTask()
+{
+    s_timerService->Run();
+}
+
+bool xTimerServiceStart(TimerClockT clock)
+{
+    if (s_timerService)
+    {
+        return false;
+    }
+
+    s_timerService.reset(new cms::TimerService(clock));
+    if ((clock == TIMER_CLOCK_REAL) && !xTaskCreate(TimerServiceTask, "faux-timer", 0, &s_timerThread))
+    {
+        s_timerService.reset();
+        return false;
+    }
+
+    return true;
+}
+
+void vTimerServiceStop(void)
+{
+    if (!s_timerService)
+    {
+        return;
+    }
+
+    s_timerService->Stop();
+    if (s_timerThread != nullptr)
+    {
+        vTaskDelete(s_timerThread);
+        s_timerThread = nullptr;
+    }
+    s_timerService.reset();
+}
+
+bool xTimerServiceIsRunning(void)
+{
+    return static_cast<bool>(s_timerService);
+}
+
+TickType_t xTimerGetTickCount(void)
+{
+    return s_timerService ? s_timerService->TickCount() : 0;
+}
+
+void vTimerAdvanceTicks(TickType_t xTicks)
+{
+    if (s_timerService && (s_timerService->Clock() == TIMER_CLOCK_VIRTUAL))
+    {
+        s_timerService->AdvanceVirtual(xTicks, false);
+    }
+}
+
+TickType_t xTimerAdvanceToNextExpiry(TickType_t xMaxTicks)
+{
+    if (!s_timerService || (s_timerService->Clock() != TIMER_CLOCK_VIRTUAL))
+    {
+        return 0;
+    }
+
+    return s_timerService->AdvanceVirtual(xMaxTicks, true);
+}
+
+TimerHandle_t xTimerCreate(const char* pcTimerName, TickType_t xTimerPeriod, bool xAutoReload,
+                           QueueHandle_t xQueue, const void* pvEvent, size_t uxEventSize)
+{
+    if (!s_timerService || (xTimerPeriod == 0) || (xTimerPeriod == portMAX_DELAY) ||
+        (xQueue == nullptr) || (pvEvent == nullptr) || (uxEventSize == 0))
+    {
+        return nullptr;
+    }
+
+    return s_timerService->Create(pcTimerName, xTimerPeriod, xAutoReload, xQueue, pvEvent, uxEventSize);
+}
+
+bool xTimerSetQueueLane(TimerHandle_t xTimer, size_t uxLane)
+{
+    if (!s_timerService || (xTimer == nullptr) || (uxLane >= QUEUE_MAX_LANES))
+    {
+        return false;
+    }
+
+    s_timerService->SetLane(static_cast<cms::Timer*>(xTimer), uxLane);
+    return true;
+}
+
+void vTimerDelete(TimerHandle_t xTimer)
+{
+    if (s_timerService && (xTimer != nullptr))
+    {
+        s_timerService->Delete(static_cast<cms::Timer*>(xTimer));
+    }
+}
+
+bool xTimerStart(TimerHandle_t xTimer)
+{
+    if (!s_timerService || (xTimer == nullptr))
+    {
+        return false;
+    }
+
+    s_timerService->Start(static_cast<cms::Timer*>(xTimer), 0);
+    return true;
+}
+
+bool xTimerStop(TimerHandle_t xTimer)
+{
+    if (!s_timerService || (xTimer == nullptr))
+    {
+        return false;
+    }
+
+    s_timerService->Stop(static_cast<cms::Timer*>(xTimer));
+    return true;
+}
+
+bool xTimerChangePeriod(TimerHandle_t xTimer, TickType_t xNewPeriod)
+{
+    if (!s_timerService || (xTimer == nullptr) || (xNewPeriod == 0) || (xNewPeriod == portMAX_DELAY))
+    {
+        return false;
+    }
+
+    s_timerService->Start(static_cast<cms::Timer*>(xTimer), xNewPeriod);
+    return true;
+}
+
+bool xTimerIsTimerActive(TimerHandle_t xTimer)
+{
+    if (!s_timerService || (xTimer == nullptr))
+    {
+        return false;
+    }
+
+    return s_timerService->IsActive(static_cast<cms::Timer*>(xTimer));
+}
+
+size_t uxTimerGetDroppedCount(TimerHandle_t xTimer)
+{
+    if (!s_timerService || (xTimer == nullptr))
+    {
+        return 0;
+    }
+
+    return s_timerService->Dropped(static_cast<cms::Timer*>(xTimer));
+}
@@ -0,0 +1,251 @@
+//
+// Hierarchical timing wheel used by the faux RTOS timer service.
+//
+
+#ifndef FAUXTIMINGWHEEL_HPP
+#define FAUXTIMINGWHEEL_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+namespace cms
+{
+
+/**
+ * @brief TimingWheel - Levels wheels of Slots (64) slots each. Level 0 holds
+ *        nodes expiring within 64 ticks, one slot per tick, and each
+ *        higher level covers 64 times the span of the level below. When
+ *        a lower level wraps, the matching slot of the next level is
+ *        cascaded, re-inserting its nodes closer to their expiry. Nodes
+ *        are intrusive, so Insert() and Remove() are O(1) and never
+ *        allocate. Nodes beyond the top level's span wait in its furthest
+ *        slot and are re-inserted on each cascade.
+ *
+ * @note: not thread safe, the timer service serializes access.
+ */
+class TimingWheel
+{
+public:
+    static constexpr unsigned SlotBits = 6;
+    static constexpr size_t Slots = 1u << SlotBits;
+    static constexpr size_t Levels = 4;
+    static constexpr uint64_t NoWork = UINT64_MAX;
+
+    struct Node
+    {
+        Node* prev = nullptr;
+        Node* next = nullptr;
+        uint64_t expiry = 0;
+        uint8_t level = 0;
+        uint8_t slot = 0;
+        bool linked = false;
+    };
+
+    TimingWheel() :
+        mNow(0),
+        mCount(0),
+        mSlots(),
+        mOccupied()
+    {
+    }
+
+    uint64_t Now() const
+    {
+        return mNow;
+    }
+
+    size_t Count() const
+    {
+        return mCount;
+    }
+
+    /**
+     * @brief Insert - expiry is an absolute tick, at least Now() + 1.
+     */
+    void Insert(Node* node, uint64_t expiry)
+    {
+        assert(!node->linked);
+        assert(expiry > mNow);
+        node->expiry = expiry;
+        Link(node);
+        ++mCount;
+    }
+
+    void Remove(Node* node)
+    {
+        if (!node->linked)
+        {
+            return;
+        }
+
+        Unlink(node);
+        --mCount;
+    }
+
+    /**
+     * @brief Advance - move time forward one tick, then remove and pass
+     *        each node expiring at the new tick to onExpired. onExpired
+     *        may re-insert the node.
+     */
+    template<typename OnExpired>
+    void Advance(OnExpired onExpired)
+    {
+        ++mNow;
+
+        //cascade the highest level which wrapped first, so its nodes
+        //may land in the slots cascaded next.
+        size_t wrapped = 0;
+        while ((wrapped + 1 < Levels) && (SlotIndex(wrapped, mNow) == 0))
+        {
+            ++wrapped;
+        }
+        for (size_t level = wrapped; level > 0; --level)
+        {
+            Cascade(level, SlotIndex(level, mNow));
+        }
+
+        size_t slot = SlotIndex(0, mNow);
+        while (mSlots[0][slot] != nullptr)
+        {
+            Node* node = mSlots[0][slot];
+            assert(node->expiry == mNow);
+            Unlink(node);
+            --mCount;
+            onExpired(node);
+        }
+    }
+
+    /**
+     * @brief TicksUntilNextWork - how far time may move before Advance()
+     *        has work to do: the next level 0 expiry, or a cascade. May be
+     *        earlier than the next expiry, never later.
+     * @return NoWork if the wheel is empty.
+     */
+    uint64_t TicksUntilNextWork() const
+    {
+        uint64_t ticks = NoWork;
+        uint64_t occupied = mOccupied[0];
+        if (occupied != 0)
+        {
+            //first occupied slot after the current one, in wheel order
+            unsigned shift = static_cast<unsigned>((mNow + 1) % Slots);
+            uint64_t rotated = (occupied >> shift) | ((shift == 0) ? 0 : (occupied << (Slots - shift)));
+            ticks = static_cast<uint64_t>(__builtin_ctzll(rotated)) + 1;
+        }
+
+        for (size_t level = 1; level < Levels; ++level)
+        {
+            if (mOccupied[level] != 0)
+            {
+                //a cascade is due, at the latest, when level 0 next wraps
+                uint64_t untilWrap = Slots - (mNow % Slots);
+                ticks = (untilWrap < ticks) ? untilWrap : ticks;
+                break;
+            }
+        }
+
+        return ticks;
+    }
+
+    /**
+     * @brief Skip - move time forward without any work, ticks must be
+     *        less than TicksUntilNextWork().
+     */
+    void Skip(uint64_t ticks)
+    {
+        assert(ticks < TicksUntilNextWork());
+        mNow += ticks;
+    }
+
+private:
+    static size_t SlotIndex(size_t level, uint64_t tick)
+    {
+        return static_cast<size_t>((tick >> (level * SlotBits)) & (Slots - 1));
+    }
+
+    void Link(Node* node)
+    {
+        uint64_t delta = node->expiry - mNow;
+        size_t level = 0;
+        while ((level + 1 < Levels) && (delta >= (uint64_t(1) << ((level + 1) * SlotBits))))
+        {
+            ++level;
+        }
+
+        size_t slot;
+        if (delta < (uint64_t(1) << ((level + 1) * SlotBits)))
+        {
+            slot = SlotIndex(level, node->expiry);
+        }
+        else
+        {
+            //beyond the top level's span: the furthest slot, then re-evaluate
+            slot = SlotIndex(level, mNow + ((Slots - 1) << (level * SlotBits)));
+        }
+
+        Node*& head = mSlots[level][slot];
+        node->prev = nullptr;
+        node->next = head;
+        if (head != nullptr)
+        {
+            head->prev = node;
+        }
+        head = node;
+        node->level = static_cast<uint8_t>(level);
+        node->slot = static_cast<uint8_t>(slot);
+        node->linked = true;
+        mOccupied[level] |= (uint64_t(1) << slot);
+    }
+
+    void Unlink(Node* node)
+    {
+        size_t level = node->level;
+        size_t slot = node->slot;
+        if (node->prev != nullptr)
+        {
+            node->prev->next = node->next;
+        }
+        else
+        {
+            mSlots[level][slot] = node->next;
+        }
+
+        if (node->next != nullptr)
+        {
+            node->next->prev = node->prev;
+        }
+
+        if (mSlots[level][slot] == nullptr)
+        {
+            mOccupied[level] &= ~(uint64_t(1) << slot);
+        }
+
+        node->prev = nullptr;
+        node->next = nullptr;
+        node->linked = false;
+    }
+
+    void Cascade(size_t level, size_t slot)
+    {
+        Node* node = mSlots[level][slot];
+        mSlots[level][slot] = nullptr;
+        mOccupied[level] &= ~(uint64_t(1) << slot);
+        while (node != nullptr)
+        {
+            Node* next = node->next;
+            node->linked = false;
+            Link(node);
+            node = next;
+        }
+    }
+
+    uint64_t mNow;
+    size_t mCount;
+    Node* mSlots[Levels][Slots];
+    uint64_t mOccupied[Levels];
+};
+
+} // namespace cms
+
+#endif //FAUXTIMINGWHEEL_HPP
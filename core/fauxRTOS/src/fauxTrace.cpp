@@ -0,0 +1,346 @@
+//
+// Binary event trace for the faux RTOS.
+//
+#include "fauxTrace.hpp"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace cms
+{
+
+std::atomic<bool> Tracer::sEnabled(false);
+thread_local TraceRing* Tracer::tRing = nullptr;
+
+/**
+ * @brief TraceRegistry - every ring ever created, and the object names.
+ *        Rings outlive their threads, so a finished thread's records
+ *        remain available to collect.
+ */
+struct TraceRegistry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TraceRing>> rings;
+    std::unordered_map<uint64_t, std::string> objectNames;
+
+    //raw timestamp to nanoseconds calibration, set when first enabled
+    bool calibrated = false;
+    uint64_t epochRaw = 0;
+    std::chrono::steady_clock::time_point epoch;
+};
+
+static TraceRegistry& Registry()
+{
+    static TraceRegistry registry;
+    return registry;
+}
+
+static thread_local char tThreadName[32] = {};
+
+TraceRing* Tracer::CreateThreadRing()
+{
+    auto& registry = Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.rings.emplace_back(new TraceRing(static_cast<uint16_t>(registry.rings.size() + 1)));
+    tRing = registry.rings.back().get();
+    tRing->Name() = tThreadName;
+    return tRing;
+}
+
+/**
+ * @brief TraceFileHeader - the binary trace file is this header, then
+ *        threadCount TraceFileName entries (id: thread), objectCount
+ *        TraceFileName entries (id: object), then recordCount TraceRecordT.
+ */
+struct TraceFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t threadCount;
+    uint32_t objectCount;
+    uint32_t reserved;
+    uint64_t recordCount;
+};
+
+struct TraceFileName
+{
+    uint64_t id;
+    char name[24];
+};
+
+static constexpr char TraceFileMagic[8] = {'F', 'X', 'T', 'R', 'A', 'C', 'E', '1'};
+
+static void CopyName(char (&destination)[24], const std::string& source)
+{
+    memset(destination, 0, sizeof(destination));
+    strncpy(destination, source.c_str(), sizeof(destination) - 1);
+}
+
+static std::string JsonString(const char* text)
+{
+    std::string escaped;
+    for (const char* c = text; *c != '\0'; ++c)
+    {
+        if ((*c == '"') || (*c == '\\'))
+        {
+            escaped += '\\';
+        }
+        if (static_cast<unsigned char>(*c) >= 0x20)
+        {
+            escaped += *c;
+        }
+    }
+    return escaped;
+}
+
+} // namespace cms
+
+void vTraceEnable(bool xEnable)
+{
+    auto& registry = cms::Registry();
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if (xEnable && !registry.calibrated)
+        {
+            registry.epoch = std::chrono::steady_clock::now();
+            registry.epochRaw = cms::Tracer::Timestamp();
+            registry.calibrated = true;
+        }
+    }
+
+    cms::Tracer::SetEnabled(xEnable);
+}
+
+bool xTraceIsEnabled(void)
+{
+    return cms::Tracer::Enabled();
+}
+
+void vTraceRecord(TraceEventTypeT type, const void* pvObject, uint32_t ulArg0, uint32_t ulArg1, uint32_t ulArg2)
+{
+    cms::Tracer::Record(type, pvObject, ulArg0, ulArg1, ulArg2);
+}
+
+void vTraceSetThreadName(const char* pcName)
+{
+    strncpy(cms::tThreadName, (pcName != nullptr) ? pcName : "", sizeof(cms::tThreadName) - 1);
+    auto ring = cms::Tracer::ThreadRing();
+    if (ring != nullptr)
+    {
+        std::lock_guard<std::mutex> lock(cms::Registry().mutex);
+        ring->Name() = cms::tThreadName;
+    }
+}
+
+void vTraceSetObjectName(const void* pvObject, const char* pcName)
+{
+    auto& registry = cms::Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.objectNames[reinterpret_cast<uintptr_t>(pvObject)] = (pcName != nullptr) ? pcName : "";
+}
+
+size_t uxTraceCollect(TraceRecordT* pxBuffer, size_t uxMaxRecords)
+{
+    auto& registry = cms::Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    if (!registry.calibrated || (pxBuffer == nullptr))
+    {
+        return 0;
+    }
+
+    std::vector<TraceRecordT> records;
+    for (const auto& ring : registry.rings)
+    {
+        ring->Collect([&records](const TraceRecordT& record) { records.push_back(record); });
+    }
+
+    //calibrate raw timestamps against the steady clock, over the whole trace
+    auto nowRaw = cms::Tracer::Timestamp();
+    auto nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - registry.epoch).count();
+    double nsPerTick = (nowRaw > registry.epochRaw) ? (static_cast<double>(nowNs) / static_cast<double>(nowRaw - registry.epochRaw)) : 1.0;
+    for (auto& record : records)
+    {
+        int64_t ticks = static_cast<int64_t>(record.timestampNs - registry.epochRaw);
+        record.timestampNs = (ticks > 0) ? static_cast<uint64_t>(static_cast<double>(ticks) * nsPerTick) : 0;
+    }
+
+    std::stable_sort(records.begin(), records.end(), [](const TraceRecordT& a, const TraceRecordT& b) {
+        return a.timestampNs < b.timestampNs;
+    });
+
+    //the most recent records, when the buffer is too small
+    size_t count = std::min(records.size(), uxMaxRecords);
+    std::copy(records.end() - static_cast<std::ptrdiff_t>(count), records.end(), pxBuffer);
+    return count;
+}
+
+void vTraceClear(void)
+{
+    auto& registry = cms::Registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (auto& ring : registry.rings)
+    {
+        ring->Clear();
+    }
+}
+
+bool xTraceWriteFile(const char* pcTracePath)
+{
+    auto& registry = cms::Registry();
+    size_t capacity = 0;
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        capacity = registry.rings.size() * TRACE_RING_RECORDS;
+    }
+
+    std::vector<TraceRecordT> records(capacity);
+    records.resize(uxTraceCollect(records.data(), records.size()));
+
+    std::vector<cms::TraceFileName> threads;
+    std::vector<cms::TraceFileName> objects;
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (auto& ring : registry.rings)
+        {
+            cms::TraceFileName entry;
+            entry.id = ring->Thread();
+            cms::CopyName(entry.name, ring->Name());
+            threads.push_back(entry);
+        }
+        for (const auto& object : registry.objectNames)
+        {
+            cms::TraceFileName entry;
+            entry.id = object.first;
+            cms::CopyName(entry.name, object.second);
+            objects.push_back(entry);
+        }
+    }
+
+    FILE* file = fopen(pcTracePath, "wb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    cms::TraceFileHeader header = {};
+    memcpy(header.magic, cms::TraceFileMagic, sizeof(header.magic));
+    header.version = 1;
+    header.threadCount = static_cast<uint32_t>(threads.size());
+    header.objectCount = static_cast<uint32_t>(objects.size());
+    header.recordCount = records.size();
+
+    bool ok = (fwrite(&header, sizeof(header), 1, file) == 1) &&
+              (fwrite(threads.data(), sizeof(cms::TraceFileName), threads.size(), file) == threads.size()) &&
+              (fwrite(objects.data(), sizeof(cms::TraceFileName), objects.size(), file) == objects.size()) &&
+              (fwrite(records.data(), sizeof(TraceRecordT), records.size(), file) == records.size());
+    return (fclose(file) == 0) && ok;
+}
+
+bool xTraceConvertToChromeJson(const char* pcTracePath, const char* pcJsonPath)
+{
+    FILE* input = fopen(pcTracePath, "rb");
+    if (input == nullptr)
+    {
+        return false;
+    }
+
+    cms::TraceFileHeader header = {};
+    bool ok = (fread(&header, sizeof(header), 1, input) == 1) &&
+              (memcmp(header.magic, cms::TraceFileMagic, sizeof(header.magic)) == 0) &&
+              (header.version == 1);
+
+    std::vector<cms::TraceFileName> threads(ok ? header.threadCount : 0);
+    std::vector<cms::TraceFileName> objects(ok ? header.objectCount : 0);
+    std::vector<TraceRecordT> records(ok ? header.recordCount : 0);
+    ok = ok && (fread(threads.data(), sizeof(cms::TraceFileName), threads.size(), input) == threads.size()) &&
+         (fread(objects.data(), sizeof(cms::TraceFileName), objects.size(), input) == objects.size()) &&
+         (fread(records.data(), sizeof(TraceRecordT), records.size(), input) == records.size());
+    fclose(input);
+    if (!ok)
+    {
+        return false;
+    }
+
+    FILE* output = fopen(pcJsonPath, "w");
+    if (output == nullptr)
+    {
+        return false;
+    }
+
+    std::unordered_map<uint64_t, std::string> names;
+    for (auto& object : objects)
+    {
+        object.name[sizeof(object.name) - 1] = '\0';
+        names[object.id] = cms::JsonString(object.name);
+    }
+    auto nameOf = [&names](uint64_t object) {
+        auto found = names.find(object);
+        if (found != names.end())
+        {
+            return found->second;
+        }
+        char address[32];
+        snprintf(address, sizeof(address), "0x%" PRIx64, object);
+        return std::string(address);
+    };
+
+    fprintf(output, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    const char* separator = "";
+    for (auto& thread : threads)
+    {
+        thread.name[sizeof(thread.name) - 1] = '\0';
+        fprintf(output, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%" PRIu64 ",\"args\":{\"name\":\"%s\"}}",
+                separator, thread.id, cms::JsonString(thread.name).c_str());
+        separator = ",\n";
+    }
+
+    for (const auto& record : records)
+    {
+        //Chrome trace timestamps are microseconds
+        fprintf(output, "%s{\"pid\":1,\"tid\":%u,\"ts\":%" PRIu64 ".%03u,", separator,
+                record.thread, record.timestampNs / 1000, static_cast<unsigned>(record.timestampNs % 1000));
+        separator = ",\n";
+
+        std::string object = nameOf(record.object);
+        switch (record.type)
+        {
+        case TRACE_EVENT_QUEUE_POST:
+            fprintf(output, "\"ph\":\"i\",\"s\":\"t\",\"cat\":\"queue\",\"name\":\"post %s\",\"args\":{\"depth\":%u,\"urgent\":%u}}",
+                    object.c_str(), record.arg0, record.arg1);
+            break;
+        case TRACE_EVENT_QUEUE_RECEIVE:
+            fprintf(output, "\"ph\":\"i\",\"s\":\"t\",\"cat\":\"queue\",\"name\":\"receive %s\",\"args\":{\"received\":%u,\"depth\":%u}}",
+                    object.c_str(), record.arg0, record.arg1);
+            break;
+        case TRACE_EVENT_DISPATCH_BEGIN:
+            fprintf(output, "\"ph\":\"B\",\"cat\":\"dispatch\",\"name\":\"%s\",\"args\":{\"signal\":%u}}",
+                    object.c_str(), record.arg0);
+            break;
+        case TRACE_EVENT_DISPATCH_END:
+            fprintf(output, "\"ph\":\"E\",\"cat\":\"dispatch\",\"name\":\"%s\",\"args\":{\"signal\":%u,\"state\":%u}}",
+                    object.c_str(), record.arg0, record.arg1);
+            break;
+        case TRACE_EVENT_STATE_TRANSITION:
+            fprintf(output, "\"ph\":\"i\",\"s\":\"t\",\"cat\":\"state\",\"name\":\"%s transition\",\"args\":{\"source\":%u,\"target\":%u,\"signal\":%u}}",
+                    object.c_str(), record.arg0, record.arg1, record.arg2);
+            break;
+        case TRACE_EVENT_CALLBACK:
+            fprintf(output, "\"ph\":\"i\",\"s\":\"t\",\"cat\":\"callback\",\"name\":\"%s callback\",\"args\":{\"id\":%u,\"value\":%u}}",
+                    object.c_str(), record.arg0, record.arg1);
+            break;
+        default:
+            fprintf(output, "\"ph\":\"i\",\"s\":\"t\",\"cat\":\"user\",\"name\":\"%s\",\"args\":{\"arg0\":%u,\"arg1\":%u,\"arg2\":%u}}",
+                    object.c_str(), record.arg0, record.arg1, record.arg2);
+            break;
+        }
+    }
+
+    fprintf(output, "\n]}\n");
+    return fclose(output) == 0;
+}
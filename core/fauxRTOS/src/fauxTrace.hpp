@@ -0,0 +1,185 @@
+//
+// Inline trace points for the faux RTOS internals, see fauxTrace.h.
+//
+
+#ifndef FAUXTRACE_HPP
+#define FAUXTRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include "fauxTrace.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace cms
+{
+
+/**
+ * @brief TraceRing - a single producer ring of TRACE_RING_RECORDS records,
+ *        only written by its owning thread. Readers copy the slots, then
+ *        re-read the head and discard any slot the writer may have reused
+ *        meanwhile. Slots are relaxed atomics, which compile to plain stores.
+ */
+class TraceRing
+{
+public:
+    static_assert((TRACE_RING_RECORDS & (TRACE_RING_RECORDS - 1)) == 0, "TRACE_RING_RECORDS must be a power of 2");
+
+    explicit TraceRing(uint16_t thread) :
+        mThread(thread),
+        mName(),
+        mHead(0),
+        mFirst(0),
+        mSlots()
+    {
+    }
+
+    void Write(uint64_t timestamp, TraceEventTypeT type, const void* object,
+               uint32_t arg0, uint32_t arg1, uint32_t arg2)
+    {
+        uint64_t head = mHead.load(std::memory_order_relaxed);
+        Slot& slot = mSlots[head & (TRACE_RING_RECORDS - 1)];
+        slot.words[0].store(timestamp, std::memory_order_relaxed);
+        slot.words[1].store(reinterpret_cast<uintptr_t>(object), std::memory_order_relaxed);
+        slot.words[2].store(arg0 | (static_cast<uint64_t>(arg1) << 32), std::memory_order_relaxed);
+        slot.words[3].store(arg2 | (static_cast<uint64_t>(type) << 32), std::memory_order_relaxed);
+        mHead.store(head + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Collect - call onRecord(TraceRecordT&) for each record still
+     *        in the ring, oldest first, timestamps left raw.
+     */
+    template<typename OnRecord>
+    void Collect(OnRecord onRecord) const
+    {
+        //the writer may already be reusing the oldest slot, which
+        //leaves TRACE_RING_RECORDS - 1 records which can be read safely.
+        uint64_t head = mHead.load(std::memory_order_acquire);
+        uint64_t first = mFirst.load(std::memory_order_relaxed);
+        if (head >= TRACE_RING_RECORDS + first)
+        {
+            first = head - TRACE_RING_RECORDS + 1;
+        }
+
+        for (uint64_t index = first; index < head; ++index)
+        {
+            const Slot& slot = mSlots[index & (TRACE_RING_RECORDS - 1)];
+            uint64_t words[4];
+            for (size_t i = 0; i < 4; ++i)
+            {
+                words[i] = slot.words[i].load(std::memory_order_relaxed);
+            }
+
+            //the slot being written is one ahead of the published head
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (index + TRACE_RING_RECORDS <= mHead.load(std::memory_order_relaxed))
+            {
+                continue; //overwritten while copying
+            }
+
+            TraceRecordT record;
+            record.timestampNs = words[0];
+            record.object = words[1];
+            record.arg0 = static_cast<uint32_t>(words[2]);
+            record.arg1 = static_cast<uint32_t>(words[2] >> 32);
+            record.arg2 = static_cast<uint32_t>(words[3]);
+            record.type = static_cast<uint16_t>(words[3] >> 32);
+            record.thread = mThread;
+            onRecord(record);
+        }
+    }
+
+    void Clear()
+    {
+        mFirst.store(mHead.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+
+    uint16_t Thread() const
+    {
+        return mThread;
+    }
+
+    std::string& Name()
+    {
+        return mName;
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> words[4];
+    };
+
+    const uint16_t mThread;
+    std::string mName; //guarded by the Tracer's registry mutex
+    std::atomic<uint64_t> mHead;
+    std::atomic<uint64_t> mFirst;
+    Slot mSlots[TRACE_RING_RECORDS];
+};
+
+class Tracer
+{
+public:
+    static bool Enabled()
+    {
+        return sEnabled.load(std::memory_order_relaxed);
+    }
+
+    static void SetEnabled(bool enabled)
+    {
+        sEnabled.store(enabled);
+    }
+
+    /**
+     * @brief ThreadRing - the calling thread's ring, nullptr if the
+     *        thread has not recorded anything yet.
+     */
+    static TraceRing* ThreadRing()
+    {
+        return tRing;
+    }
+
+    static void Record(TraceEventTypeT type, const void* object,
+                       uint32_t arg0 = 0, uint32_t arg1 = 0, uint32_t arg2 = 0)
+    {
+        if (!Enabled())
+        {
+            return;
+        }
+
+        TraceRing* ring = tRing;
+        if (ring == nullptr)
+        {
+            ring = CreateThreadRing();
+        }
+        ring->Write(Timestamp(), type, object, arg0, arg1, arg2);
+    }
+
+    /**
+     * @brief Timestamp - raw TSC ticks, or CLOCK_MONOTONIC nanoseconds,
+     *        converted to nanoseconds only when collected.
+     */
+    static uint64_t Timestamp()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+private:
+    static TraceRing* CreateThreadRing();
+
+    static std::atomic<bool> sEnabled;
+    static thread_local TraceRing* tRing;
+};
+
+} // namespace cms
+
+#endif //FAUXTRACE_HPP
@@ -0,0 +1,113 @@
+//
+// Waiter - lets threads block on lock-free state without the
+// updating side taking a lock unless somebody is waiting.
+//
+
+#ifndef FAUXWAITER_HPP
+#define FAUXWAITER_HPP
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+#include "fauxTicks.hpp"
+
+namespace cms
+{
+
+/**
+ * @brief Waiter - an event count parking threads waiting on lock-free
+ *        state, such as a queue consumer while the queue is empty, or
+ *        producers while it is full. The other side only touches the
+ *        mutex when a waiter has announced itself. The attempted
+ *        operation never runs while holding the mutex.
+ */
+class Waiter
+{
+public:
+    using LockGuard = std::unique_lock<std::mutex>;
+
+    Waiter() :
+        mWaiters(0),
+        mGeneration(0),
+        mMutex(),
+        mCondVar()
+    {
+    }
+
+    /**
+     * @brief WaitUntil - block until attempt() succeeds or ticksToWait expires.
+     * @return the final result of attempt()
+     */
+    template<typename Attempt>
+    bool WaitUntil(Attempt attempt, TickType_t ticksToWait)
+    {
+        if (attempt())
+        {
+            return true;
+        }
+
+        if (ticksToWait == 0)
+        {
+            return false;
+        }
+
+        const auto deadline = TicksToDeadline(ticksToWait);
+        bool done = false;
+        bool timedOut = false;
+        while (!done && !timedOut)
+        {
+            mWaiters.fetch_add(1, std::memory_order_relaxed);
+
+            //pairs with the fence in NotifyIfWaiting(): either the other
+            //side observes mWaiters, or we observe its update below.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto generation = mGeneration.load(std::memory_order_acquire);
+            done = attempt();
+            if (!done)
+            {
+                LockGuard lock(mMutex);
+                auto changed = [this, generation]() {
+                    return mGeneration.load(std::memory_order_acquire) != generation;
+                };
+
+                if (ticksToWait == portMAX_DELAY)
+                {
+                    mCondVar.wait(lock, changed);
+                }
+                else
+                {
+                    timedOut = !mCondVar.wait_until(lock, deadline, changed);
+                }
+            }
+            mWaiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        return done || attempt();
+    }
+
+    /**
+     * @brief NotifyIfWaiting - called after the queue changed in a way
+     *        a waiter may be interested in.
+     */
+    void NotifyIfWaiting()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (mWaiters.load(std::memory_order_relaxed) != 0)
+        {
+            LockGuard lock(mMutex);
+            mGeneration.fetch_add(1, std::memory_order_release);
+            mCondVar.notify_all();
+        }
+    }
+
+private:
+    std::atomic<size_t> mWaiters;
+    std::atomic<size_t> mGeneration;
+    std::mutex mMutex;
+    std::condition_variable mCondVar;
+};
+
+} // namespace cms
+
+#endif //FAUXWAITER_HPP
@@ -0,0 +1,186 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "fauxLog.h"
+#include "CppUTest/TestHarness.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+struct CapturedLog
+{
+    std::mutex mutex;
+    std::string text;
+    size_t batches = 0;
+
+    //while true, the sink blocks, and with it the flush thread
+    std::atomic<bool> blocked{false};
+    std::atomic<bool> entered{false};
+};
+
+void CaptureSink(void* context, const char* text, size_t length)
+{
+    auto captured = static_cast<CapturedLog*>(context);
+    captured->entered = true;
+    while (captured->blocked.load())
+    {
+        std::this_thread::yield();
+    }
+
+    std::lock_guard<std::mutex> lock(captured->mutex);
+    captured->text.append(text, length);
+    ++captured->batches;
+}
+
+size_t CountLines(const std::string& text, const std::string& containing)
+{
+    size_t count = 0;
+    size_t start = 0;
+    while (start < text.size())
+    {
+        size_t end = text.find('\n', start);
+        if (text.substr(start, end - start).find(containing) != std::string::npos)
+        {
+            ++count;
+        }
+        start = end + 1;
+    }
+    return count;
+}
+
+} // namespace
+
+TEST_GROUP(FauxLogTests)
+{
+    CapturedLog mCaptured;
+
+    void setup() final
+    {
+        vLogFlush();
+        vLogSetSink(CaptureSink, &mCaptured);
+    }
+
+    void teardown() final
+    {
+        mCaptured.blocked = false;
+        vLogFlush();
+        vLogSetSink(nullptr, nullptr);
+    }
+
+    std::string Flushed()
+    {
+        vLogFlush();
+        std::lock_guard<std::mutex> lock(mCaptured.mutex);
+        return mCaptured.text;
+    }
+};
+
+TEST(FauxLogTests, logged_messages_are_written_with_their_level_once_flushed)
+{
+    FAUX_LOG_ERROR("error %d", 1);
+    FAUX_LOG_WARNING("warning %s", "two");
+    FAUX_LOG_INFO("info %u", 3u);
+
+    std::string text = Flushed();
+    auto error = text.find("] E error 1\n");
+    auto warning = text.find("] W warning two\n");
+    auto info = text.find("] I info 3\n");
+    CHECK_TRUE(error != std::string::npos);
+    CHECK_TRUE(warning != std::string::npos);
+    CHECK_TRUE(info != std::string::npos);
+    CHECK_TRUE((error < warning) && (warning < info));
+    CHECK_EQUAL('[', text[0]);
+}
+
+TEST(FauxLogTests, levels_above_the_compiled_level_are_not_evaluated)
+{
+    int evaluated = 0;
+    FAUX_LOG_DEBUG("debug %d", ++evaluated);
+    FAUX_LOG_INFO("info %d", ++evaluated);
+    LONGS_EQUAL(1, evaluated);
+    CHECK_TRUE(Flushed().find("debug") == std::string::npos);
+}
+
+TEST(FauxLogTests, long_messages_are_truncated_and_newline_terminated)
+{
+    std::string longText(2 * LOG_MESSAGE_MAX, 'x');
+    FAUX_LOG_INFO("%s", longText.c_str());
+
+    std::string text = Flushed();
+    auto start = text.find("] I ") + 4;
+    auto end = text.find('\n', start);
+    LONGS_EQUAL(LOG_MESSAGE_MAX - 2, end - start);
+}
+
+TEST(FauxLogTests, given_a_stalled_flush_when_a_thread_ring_fills_then_further_messages_are_dropped_and_reported)
+{
+    static constexpr size_t Extra = 10;
+    mCaptured.blocked = true;
+    FAUX_LOG_INFO("first");
+    while (!mCaptured.entered.load())
+    {
+        std::this_thread::yield();
+    }
+
+    uint64_t droppedBefore = uxLogGetDroppedCount();
+    for (size_t i = 0; i < LOG_RING_MESSAGES + Extra; ++i)
+    {
+        FAUX_LOG_INFO("message %zu", i);
+    }
+    UNSIGNED_LONGS_EQUAL(Extra, uxLogGetDroppedCount() - droppedBefore);
+
+    mCaptured.blocked = false;
+    std::string text = Flushed();
+    UNSIGNED_LONGS_EQUAL(LOG_RING_MESSAGES + 1, CountLines(text, "] I "));
+    CHECK_TRUE(text.find("] W log dropped 10 messages\n") != std::string::npos);
+}
+
+TEST(FauxLogTests, messages_from_many_threads_are_all_written)
+{
+    static constexpr size_t ThreadCount = 4;
+    static constexpr size_t PerThread = LOG_RING_MESSAGES / 2;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < ThreadCount; ++t)
+    {
+        threads.emplace_back([t]() {
+            for (size_t i = 0; i < PerThread; ++i)
+            {
+                FAUX_LOG_INFO("thread %zu message %zu", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    std::string text = Flushed();
+    UNSIGNED_LONGS_EQUAL(ThreadCount * PerThread, CountLines(text, " message "));
+    CHECK_TRUE(text.find("thread 3 message 63\n") != std::string::npos);
+}
@@ -0,0 +1,713 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "fauxQueue.h"
+#include "CppUTest/TestHarness.h"
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <chrono>
+
+struct TestEvent
+{
+    uint32_t signal;
+    uint32_t payload;
+};
+
+static constexpr size_t TestQueueDepth = 4;
+
+TEST_GROUP(FauxQueueTests)
+{
+    QueueHandle_t mQueue = nullptr;
+
+    void setup() final
+    {
+        mQueue = xQueueCreate(TestQueueDepth, sizeof(TestEvent));
+    }
+
+    void teardown() final
+    {
+        vQueueDelete(mQueue);
+    }
+
+    void Send(uint32_t signal)
+    {
+        TestEvent event = { signal, signal * 10 };
+        CHECK_TRUE(xQueueSendToBack(mQueue, &event));
+    }
+
+    void SendUrgent(uint32_t signal)
+    {
+        TestEvent event = { signal, signal * 10 };
+        CHECK_TRUE(xQueueSendToFront(mQueue, &event));
+    }
+
+    void ReceiveAndCheck(uint32_t expectedSignal)
+    {
+        TestEvent event = { 0, 0 };
+        CHECK_TRUE(xQueueReceive(mQueue, &event));
+        UNSIGNED_LONGS_EQUAL(expectedSignal, event.signal);
+        UNSIGNED_LONGS_EQUAL(expectedSignal * 10, event.payload);
+    }
+};
+
+TEST(FauxQueueTests, given_new_queue_then_it_is_empty)
+{
+    UNSIGNED_LONGS_EQUAL(0, uxQueueMessagesWaiting(mQueue));
+}
+
+TEST(FauxQueueTests, given_events_sent_to_back_then_received_in_fifo_order)
+{
+    Send(1);
+    Send(2);
+    Send(3);
+    UNSIGNED_LONGS_EQUAL(3, uxQueueMessagesWaiting(mQueue));
+    ReceiveAndCheck(1);
+    ReceiveAndCheck(2);
+    ReceiveAndCheck(3);
+    UNSIGNED_LONGS_EQUAL(0, uxQueueMessagesWaiting(mQueue));
+}
+
+TEST(FauxQueueTests, given_full_queue_when_send_then_send_fails)
+{
+    for (uint32_t i = 1; i <= TestQueueDepth; ++i)
+    {
+        Send(i);
+    }
+
+    TestEvent event = { 99, 990 };
+    CHECK_FALSE(xQueueSendToBack(mQueue, &event));
+    CHECK_FALSE(xQueueSendToFront(mQueue, &event));
+    UNSIGNED_LONGS_EQUAL(TestQueueDepth, uxQueueMessagesWaiting(mQueue));
+}
+
+TEST(FauxQueueTests, given_queued_events_when_send_to_front_then_urgent_event_received_first)
+{
+    Send(1);
+    Send(2);
+    SendUrgent(3);
+    ReceiveAndCheck(3);
+    ReceiveAndCheck(1);
+    ReceiveAndCheck(2);
+}
+
+TEST(FauxQueueTests, given_many_wrap_arounds_then_order_is_preserved)
+{
+    uint32_t next = 1;
+    uint32_t expected = 1;
+    for (int loop = 0; loop < 10; ++loop)
+    {
+        Send(next++);
+        Send(next++);
+        SendUrgent(100 + loop);
+        ReceiveAndCheck(100 + loop);
+        ReceiveAndCheck(expected++);
+        ReceiveAndCheck(expected++);
+    }
+    UNSIGNED_LONGS_EQUAL(0, uxQueueMessagesWaiting(mQueue));
+}
+
+TEST_GROUP(FauxLockFreeQueueTests)
+{
+    static constexpr QueueModeT LockFreeModes[] = { QUEUE_MODE_SPSC, QUEUE_MODE_MPSC };
+
+    void ProduceAndConsume(QueueHandle_t queue, uint32_t producers, uint32_t eventsPerProducer)
+    {
+        std::vector<std::thread> threads;
+        for (uint32_t p = 0; p < producers; ++p)
+        {
+            threads.emplace_back([queue, p, eventsPerProducer]() {
+                for (uint32_t i = 0; i < eventsPerProducer; ++i)
+                {
+                    TestEvent event = { p, i };
+                    while (!xQueueSendToBack(queue, &event))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        //each producer's events must arrive in order, none lost.
+        std::vector<uint32_t> nextExpected(producers, 0);
+        for (uint32_t count = 0; count < producers * eventsPerProducer; ++count)
+        {
+            TestEvent event = { 0, 0 };
+            CHECK_TRUE(xQueueReceive(queue, &event));
+            CHECK_TRUE(event.signal < producers);
+            UNSIGNED_LONGS_EQUAL(nextExpected[event.signal], event.payload);
+            nextExpected[event.signal]++;
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        UNSIGNED_LONGS_EQUAL(0, uxQueueMessagesWaiting(queue));
+    }
+};
+
+TEST(FauxLockFreeQueueTests, given_lock_free_queue_then_fifo_and_full_behavior_matches_standard_queue)
+{
+    for (auto mode : LockFreeModes)
+    {
+        QueueHandle_t queue = xQueueCreateWithMode(TestQueueDepth, sizeof(TestEvent), mode);
+        for (uint32_t i = 1; i <= TestQueueDepth; ++i)
+        {
+            TestEvent event = { i, i * 10 };
+            CHECK_TRUE(xQueueSendToBack(queue, &event));
+        }
+
+        TestEvent extra = { 99, 990 };
+        CHECK_FALSE(xQueueSendToBack(queue, &extra));
+        UNSIGNED_LONGS_EQUAL(TestQueueDepth, uxQueueMessagesWaiting(queue));
+
+        for (uint32_t i = 1; i <= TestQueueDepth; ++i)
+        {
+            TestEvent event = { 0, 0 };
+            CHECK_TRUE(xQueueReceive(queue, &event));
+            UNSIGNED_LONGS_EQUAL(i, event.signal);
+            UNSIGNED_LONGS_EQUAL(i * 10, event.payload);
+        }
+        UNSIGNED_LONGS_EQUAL(0, uxQueueMessagesWaiting(queue));
+        vQueueDelete(queue);
+    }
+}
+
+TEST(FauxLockFreeQueueTests, given_lock_free_queue_when_send_to_front_then_send_fails)
+{
+    for (auto mode : LockFreeModes)
+    {
+        QueueHandle_t queue = xQueueCreateWithMode(TestQueueDepth, sizeof(TestEvent), mode);
+        TestEvent event = { 1, 10 };
+        CHECK_FALSE(xQueueSendToFront(queue, &event));
+        UNSIGNED_LONGS_EQUAL(0, uxQueueMessagesWaiting(queue));
+        vQueueDelete(queue);
+    }
+}
+
+TEST(FauxLockFreeQueueTests, given_spsc_queue_when_producer_thread_streams_events_then_none_lost)
+{
+    QueueHandle_t queue = xQueueCreateWithMode(TestQueueDepth, sizeof(TestEvent), QUEUE_MODE_SPSC);
+    ProduceAndConsume(queue, 1, 100000);
+    vQueueDelete(queue);
+}
+
+TEST(FauxLockFreeQueueTests, given_mpsc_queue_when_many_producer_threads_stream_events_then_none_lost)
+{
+    QueueHandle_t queue = xQueueCreateWithMode(TestQueueDepth, sizeof(TestEvent), QUEUE_MODE_MPSC);
+    ProduceAndConsume(queue, 4, 25000);
+    vQueueDelete(queue);
+}
+
+TEST_GROUP(FauxQueueTimedTests)
+{
+    static constexpr QueueModeT AllModes[] = { QUEUE_MODE_STANDARD, QUEUE_MODE_SPSC, QUEUE_MODE_MPSC };
+    static constexpr TickType_t ShortTimeout = pdMS_TO_TICKS(20);
+
+    using Clock = std::chrono::steady_clock;
+
+    static long ElapsedMs(Clock::time_point start)
+    {
+        return static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+    }
+
+    static void Fill(QueueHandle_t queue)
+    {
+        for (uint32_t i = 1; i <= TestQueueDepth; ++i)
+        {
+            TestEvent event = { i, i * 10 };
+            xQueueSendToBack(queue, &event);
+        }
+    }
+};
+
+TEST(FauxQueueTimedTests, given_empty_queue_when_timed_receive_then_times_out)
+{
+    for (auto mode : AllModes)
+    {
+        QueueHandle_t queue = xQueueCreateWithMode(TestQueueDepth, sizeof(TestEvent), mode);
+        TestEvent event = { 0, 0 };
+        CHECK_FALSE(xQueueReceiveTimed(queue, &event, 0));
+
+        auto start = Clock::now();
+        CHECK_FALSE(xQueueReceiveTimed(queue, &event, ShortTimeout));
+        CHECK_TRUE(ElapsedMs(start) >= static_cast<long>(ShortTimeout));
+        vQueueDelete(queue);
+    }
+}
+
+TEST(FauxQueueTimedTests, given_full_queue_when_timed_send_then_times_out)
+{
+    for (auto mode : AllModes)
+    {
+        QueueHandle_t queue = xQueueCreateWithMode(TestQueueDepth, sizeof(TestEvent), mode);
+        Fill(queue);
+
+        TestEvent event = { 99, 990 };
+        auto start = Clock::now();
+        CHECK_FALSE(xQueueSendToBackTimed(queue, &event, ShortTimeout));
+        CHECK_TRUE(ElapsedMs(start) >= static_cast<long>(ShortTimeout));
+        UNSIGNED_LONGS_EQUAL(TestQueueDepth, uxQueueMessagesWaiting(queue));
+        vQueueDelete(queue);
+    }
+}
+
+TEST(FauxQueueTimedTests, given_full_queue_when_receiver_frees_space_then_blocked_sender_wakes)
+{
+    for (auto mode : AllModes)
+    {
+        QueueHandle_t queue = xQueueCreateWithMode(TestQueueDepth, sizeof(TestEvent), mode);
+        Fill(queue);
+
+        std::thread consumer([queue]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            TestEvent event = { 0, 0 };
+            xQueueReceive(queue, &event);
+        });
+
+        TestEvent event = { 99, 990 };
+        CHECK_TRUE(xQueueSendToBackTimed(queue, &event, portMAX_DELAY));
+        consumer.join();
+        UNSIGNED_LONGS_EQUAL(TestQueueDepth, uxQueueMessagesWaiting(queue));
+        vQueueDelete(queue);
+    }
+}
+
+TEST(FauxQueueTimedTests, given_empty_queue_when_sender_posts_then_blocked_receiver_wakes)
+{
+    for (auto mode : AllModes)
+    {
+        QueueHandle_t queue = xQueueCreateWithMode(TestQueueDepth, sizeof(TestEvent), mode);
+
+        std::thread producer([queue]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            TestEvent event = { 7, 70 };
+            xQueueSendToBack(queue, &event);
+        });
+
+        TestEvent event = { 0, 0 };
+        CHECK_TRUE(xQueueReceiveTimed(queue, &event, pdMS_TO_TICKS(5000)));
+        UNSIGNED_LONGS_EQUAL(7, event.signal);
+        producer.join();
+        vQueueDelete(queue);
+    }
+}
+
+TEST(FauxQueueTests, given_wrapped_queue_when_batch_received_then_all_events_arrive_in_order)
+{
+    Send(1);
+    Send(2);
+    ReceiveAndCheck(1);
+    ReceiveAndCheck(2);
+    Send(3);
+    Send(4);
+    Send(5);
+    SendUrgent(6);
+
+    TestEvent events[TestQueueDepth + 2] = {};
+    size_t count = 0;
+    CHECK_TRUE(xQueueReceiveBatch(mQueue, events, TestQueueDepth + 2, &count));
+    UNSIGNED_LONGS_EQUAL(4, count);
+    UNSIGNED_LONGS_EQUAL(6, events[0].signal);
+    UNSIGNED_LONGS_EQUAL(3, events[1].signal);
+    UNSIGNED_LONGS_EQUAL(4, events[2].signal);
+    UNSIGNED_LONGS_EQUAL(5, events[3].signal);
+    UNSIGNED_LONGS_EQUAL(50, events[3].payload);
+    UNSIGNED_LONGS_EQUAL(0, uxQueueMessagesWaiting(mQueue));
+}
+
+TEST(FauxQueueTests, given_more_events_than_batch_size_then_batch_is_limited)
+{
+    Send(1);
+    Send(2);
+    Send(3);
+
+    TestEvent events[2] = {};
+    size_t count = 0;
+    CHECK_TRUE(xQueueReceiveBatch(mQueue, events, 2, &count));
+    UNSIGNED_LONGS_EQUAL(2, count);
+    UNSIGNED_LONGS_EQUAL(1, events[0].signal);
+    UNSIGNED_LONGS_EQUAL(2, events[1].signal);
+    ReceiveAndCheck(3);
+}
+
+TEST(FauxQueueTimedTests, given_any_mode_when_batch_received_then_events_arrive_in_order_or_time_out)
+{
+    for (auto mode : AllModes)
+    {
+        QueueHandle_t queue = xQueueCreateWithMode(TestQueueDepth, sizeof(TestEvent), mode);
+        TestEvent events[TestQueueDepth] = {};
+        size_t count = 99;
+        CHECK_FALSE(xQueueReceiveBatchTimed(queue, events, TestQueueDepth, &count, 0));
+        UNSIGNED_LONGS_EQUAL(0, count);
+
+        Fill(queue);
+        CHECK_TRUE(xQueueReceiveBatchTimed(queue, events, TestQueueDepth, &count, 0));
+        UNSIGNED_LONGS_EQUAL(TestQueueDepth, count);
+        for (uint32_t i = 0; i < TestQueueDepth; ++i)
+        {
+            UNSIGNED_LONGS_EQUAL(i + 1, events[i].signal);
+        }
+        vQueueDelete(queue);
+    }
+}
+
+static uint64_t LatencySamples(const QueueStatsT& stats)
+{
+    uint64_t total = 0;
+    for (auto count : stats.latencyHistogram)
+    {
+        total += count;
+    }
+    return total;
+}
+
+TEST(FauxQueueTests, given_stats_enabled_then_posts_rejections_and_high_water_are_counted)
+{
+    vQueueEnableStats(mQueue, true);
+    Send(1);
+    SendUrgent(2);
+    Send(3);
+    Send(4);
+
+    TestEvent event = { 99, 990 };
+    CHECK_FALSE(xQueueSendToBack(mQueue, &event));
+    CHECK_FALSE(xQueueSendToFront(mQueue, &event));
+    ReceiveAndCheck(2);
+
+    QueueStatsT stats;
+    CHECK_TRUE(xQueueGetStats(mQueue, &stats));
+    UNSIGNED_LONGS_EQUAL(3, stats.normalPosts);
+    UNSIGNED_LONGS_EQUAL(1, stats.urgentPosts);
+    UNSIGNED_LONGS_EQUAL(2, stats.fullRejections);
+    UNSIGNED_LONGS_EQUAL(1, stats.receives);
+    UNSIGNED_LONGS_EQUAL(TestQueueDepth, stats.highWaterMark);
+    UNSIGNED_LONGS_EQUAL(TestQueueDepth - 1, stats.currentDepth);
+    UNSIGNED_LONGS_EQUAL(1, LatencySamples(stats));
+
+    vQueueResetStats(mQueue);
+    CHECK_TRUE(xQueueGetStats(mQueue, &stats));
+    UNSIGNED_LONGS_EQUAL(0, stats.normalPosts + stats.urgentPosts + stats.fullRejections + stats.receives);
+    UNSIGNED_LONGS_EQUAL(0, stats.highWaterMark);
+    UNSIGNED_LONGS_EQUAL(0, LatencySamples(stats));
+}
+
+TEST(FauxQueueTests, given_drop_if_pending_signal_when_identical_event_pending_then_send_is_dropped)
+{
+    CHECK_TRUE(xQueueSetCoalescing(mQueue, 5, QUEUE_COALESCE_DROP_IF_PENDING, 0));
+    vQueueEnableStats(mQueue, true);
+
+    Send(5);
+    Send(1);
+    Send(5);
+    UNSIGNED_LONGS_EQUAL(2, uxQueueMessagesWaiting(mQueue));
+
+    //a different payload is not identical, so it is queued
+    TestEvent event = { 5, 51 };
+    CHECK_TRUE(xQueueSendToBack(mQueue, &event));
+    UNSIGNED_LONGS_EQUAL(3, uxQueueMessagesWaiting(mQueue));
+
+    ReceiveAndCheck(5);
+    ReceiveAndCheck(1);
+    Send(5); //differs from the pending {5, 51}, so it is queued
+    UNSIGNED_LONGS_EQUAL(2, uxQueueMessagesWaiting(mQueue));
+    CHECK_TRUE(xQueueReceive(mQueue, &event));
+    UNSIGNED_LONGS_EQUAL(51, event.payload);
+    ReceiveAndCheck(5);
+
+    //once received, the next send of the class is queued again
+    Send(5);
+    UNSIGNED_LONGS_EQUAL(1, uxQueueMessagesWaiting(mQueue));
+
+    QueueStatsT stats;
+    CHECK_TRUE(xQueueGetStats(mQueue, &stats));
+    UNSIGNED_LONGS_EQUAL(1, stats.coalescedPosts);
+    UNSIGNED_LONGS_EQUAL(5, stats.normalPosts);
+}
+
+TEST(FauxQueueTests, given_last_value_wins_class_when_sent_then_pending_event_is_replaced_even_when_full)
+{
+    CHECK_TRUE(xQueueSetCoalescing(mQueue, 6, QUEUE_COALESCE_LAST_VALUE_WINS, 1));
+    CHECK_TRUE(xQueueSetCoalescing(mQueue, 7, QUEUE_COALESCE_LAST_VALUE_WINS, 1));
+    vQueueEnableStats(mQueue, true);
+
+    Send(6);
+    Send(1);
+    Send(2);
+    Send(3);
+    Send(7);
+    Send(6);
+    Send(7);
+    UNSIGNED_LONGS_EQUAL(TestQueueDepth, uxQueueMessagesWaiting(mQueue));
+
+    TestEvent events[TestQueueDepth] = {};
+    size_t count = 0;
+    CHECK_TRUE(xQueueReceiveBatch(mQueue, events, TestQueueDepth, &count));
+    UNSIGNED_LONGS_EQUAL(TestQueueDepth, count);
+    UNSIGNED_LONGS_EQUAL(7, events[0].signal);
+    UNSIGNED_LONGS_EQUAL(70, events[0].payload);
+    UNSIGNED_LONGS_EQUAL(1, events[1].signal);
+
+    //the batch receive cleared the pending class
+    Send(6);
+    Send(7);
+    UNSIGNED_LONGS_EQUAL(1, uxQueueMessagesWaiting(mQueue));
+    ReceiveAndCheck(7);
+
+    QueueStatsT stats;
+    CHECK_TRUE(xQueueGetStats(mQueue, &stats));
+    UNSIGNED_LONGS_EQUAL(4, stats.coalescedPosts);
+    UNSIGNED_LONGS_EQUAL(0, stats.fullRejections);
+}
+
+TEST(FauxQueueTests, given_coalescing_signal_when_sent_to_front_then_it_is_never_coalesced)
+{
+    CHECK_TRUE(xQueueSetCoalescing(mQueue, 5, QUEUE_COALESCE_LAST_VALUE_WINS, 0));
+    Send(5);
+    SendUrgent(5);
+    Send(5);
+    UNSIGNED_LONGS_EQUAL(2, uxQueueMessagesWaiting(mQueue));
+    ReceiveAndCheck(5);
+    ReceiveAndCheck(5);
+}
+
+TEST(FauxQueueTests, given_bad_arguments_or_lock_free_queue_then_coalescing_is_rejected)
+{
+    CHECK_FALSE(xQueueSetCoalescing(nullptr, 1, QUEUE_COALESCE_DROP_IF_PENDING, 0));
+    CHECK_FALSE(xQueueSetCoalescing(mQueue, QUEUE_COALESCE_MAX_SIGNALS, QUEUE_COALESCE_DROP_IF_PENDING, 0));
+    CHECK_FALSE(xQueueSetCoalescing(mQueue, 1, QUEUE_COALESCE_DROP_IF_PENDING, QUEUE_COALESCE_MAX_CLASSES));
+
+    QueueHandle_t queue = xQueueCreateWithMode(TestQueueDepth, sizeof(TestEvent), QUEUE_MODE_MPSC);
+    CHECK_FALSE(xQueueSetCoalescing(queue, 1, QUEUE_COALESCE_DROP_IF_PENDING, 0));
+    vQueueDelete(queue);
+
+    queue = xQueueCreate(TestQueueDepth, sizeof(uint16_t));
+    CHECK_FALSE(xQueueSetCoalescing(queue, 1, QUEUE_COALESCE_DROP_IF_PENDING, 0));
+    vQueueDelete(queue);
+}
+
+TEST_GROUP(FauxQueueLaneTests)
+{
+    static constexpr size_t LaneCount = 3;
+    const size_t mLaneDepths[LaneCount] = { 4, 2, 1 };
+    QueueHandle_t mQueue = nullptr;
+
+    void setup() final
+    {
+        mQueue = xQueueCreateWithLanes(LaneCount, mLaneDepths, sizeof(TestEvent));
+        CHECK_TRUE(mQueue != nullptr);
+    }
+
+    void teardown() final
+    {
+        vQueueDelete(mQueue);
+    }
+
+    void SendToLane(uint32_t signal, size_t lane)
+    {
+        TestEvent event = { signal, signal * 10 };
+        CHECK_TRUE(xQueueSendToLane(mQueue, &event, lane));
+    }
+
+    void ReceiveAndCheck(uint32_t expectedSignal)
+    {
+        TestEvent event = { 0, 0 };
+        CHECK_TRUE(xQueueReceiveTimed(mQueue, &event, 0));
+        UNSIGNED_LONGS_EQUAL(expectedSignal, event.signal);
+    }
+};
+
+TEST(FauxQueueLaneTests, given_events_in_several_lanes_then_highest_lane_first_and_fifo_within_a_lane)
+{
+    SendToLane(1, 0);
+    SendToLane(2, 0);
+    SendToLane(3, 1);
+    SendToLane(4, 2);
+    SendToLane(5, 1);
+    UNSIGNED_LONGS_EQUAL(5, uxQueueMessagesWaiting(mQueue));
+    UNSIGNED_LONGS_EQUAL(2, uxQueueLaneMessagesWaiting(mQueue, 1));
+
+    ReceiveAndCheck(4);
+    ReceiveAndCheck(3);
+    SendToLane(6, 2);
+    ReceiveAndCheck(6);
+    ReceiveAndCheck(5);
+    ReceiveAndCheck(1);
+    ReceiveAndCheck(2);
+    UNSIGNED_LONGS_EQUAL(0, uxQueueMessagesWaiting(mQueue));
+}
+
+TEST(FauxQueueLaneTests, given_lane_queue_when_sent_to_back_and_front_then_lowest_and_highest_lanes_are_used_in_order)
+{
+    TestEvent event = { 1, 10 };
+    CHECK_TRUE(xQueueSendToBack(mQueue, &event));
+    event = { 2, 20 };
+    CHECK_TRUE(xQueueSendToFront(mQueue, &event));
+    event = { 3, 30 };
+    CHECK_FALSE(xQueueSendToFront(mQueue, &event)); //the highest lane is one deep
+    UNSIGNED_LONGS_EQUAL(1, uxQueueLaneMessagesWaiting(mQueue, 0));
+    UNSIGNED_LONGS_EQUAL(1, uxQueueLaneMessagesWaiting(mQueue, LaneCount - 1));
+    ReceiveAndCheck(2);
+    ReceiveAndCheck(1);
+}
+
+TEST(FauxQueueLaneTests, given_events_in_lanes_then_has_items_above_lane_reflects_only_higher_lanes)
+{
+    SendToLane(1, 1);
+    CHECK_TRUE(xQueueHasItemsAboveLane(mQueue, 0));
+    CHECK_FALSE(xQueueHasItemsAboveLane(mQueue, 1));
+    CHECK_FALSE(xQueueHasItemsAboveLane(mQueue, LaneCount - 1));
+    CHECK_FALSE(xQueueHasItemsAboveLane(mQueue, LaneCount + 40));
+
+    SendToLane(2, 0);
+    ReceiveAndCheck(1);
+    CHECK_FALSE(xQueueHasItemsAboveLane(mQueue, 0));
+    CHECK_FALSE(xQueueHasItemsAboveLane(nullptr, 0));
+}
+
+TEST(FauxQueueLaneTests, given_full_lane_then_send_to_it_fails_while_other_lanes_accept)
+{
+    SendToLane(1, 1);
+    SendToLane(2, 1);
+    TestEvent event = { 3, 30 };
+    CHECK_FALSE(xQueueSendToLane(mQueue, &event, 1));
+    CHECK_FALSE(xQueueSendToLane(mQueue, &event, LaneCount));
+    SendToLane(4, 0);
+
+    QueueStatsT stats;
+    vQueueEnableStats(mQueue, true);
+    CHECK_FALSE(xQueueSendToLaneTimed(mQueue, &event, 1, 0));
+    CHECK_TRUE(xQueueGetStats(mQueue, &stats));
+    UNSIGNED_LONGS_EQUAL(1, stats.fullRejections);
+}
+
+TEST(FauxQueueLaneTests, given_wrapped_lanes_when_batch_received_then_lanes_drain_in_priority_order)
+{
+    //wrap lane 0
+    for (uint32_t i = 1; i <= 3; ++i)
+    {
+        SendToLane(i, 0);
+    }
+    ReceiveAndCheck(1);
+    ReceiveAndCheck(2);
+    for (uint32_t i = 4; i <= 6; ++i)
+    {
+        SendToLane(i, 0);
+    }
+    SendToLane(7, 1);
+    SendToLane(8, 2);
+
+    TestEvent events[8] = {};
+    size_t count = 0;
+    CHECK_TRUE(xQueueReceiveBatchTimed(mQueue, events, 3, &count, 0));
+    UNSIGNED_LONGS_EQUAL(3, count);
+    UNSIGNED_LONGS_EQUAL(8, events[0].signal);
+    UNSIGNED_LONGS_EQUAL(7, events[1].signal);
+    UNSIGNED_LONGS_EQUAL(3, events[2].signal);
+
+    CHECK_TRUE(xQueueReceiveBatchTimed(mQueue, events, 8, &count, 0));
+    UNSIGNED_LONGS_EQUAL(3, count);
+    UNSIGNED_LONGS_EQUAL(4, events[0].signal);
+    UNSIGNED_LONGS_EQUAL(5, events[1].signal);
+    UNSIGNED_LONGS_EQUAL(6, events[2].signal);
+}
+
+TEST(FauxQueueLaneTests, given_last_value_wins_class_when_sent_to_several_lanes_then_only_same_lane_events_coalesce)
+{
+    CHECK_TRUE(xQueueSetCoalescing(mQueue, 6, QUEUE_COALESCE_LAST_VALUE_WINS, 1));
+    CHECK_TRUE(xQueueSetCoalescing(mQueue, 7, QUEUE_COALESCE_LAST_VALUE_WINS, 1));
+
+    SendToLane(6, 0);
+    SendToLane(7, 1); //pending in lane 0 is left untouched
+    SendToLane(6, 0); //coalesces in lane 0, not into lane 1
+    UNSIGNED_LONGS_EQUAL(1, uxQueueLaneMessagesWaiting(mQueue, 0));
+    UNSIGNED_LONGS_EQUAL(1, uxQueueLaneMessagesWaiting(mQueue, 1));
+
+    ReceiveAndCheck(7);
+    SendToLane(7, 0);
+    UNSIGNED_LONGS_EQUAL(1, uxQueueMessagesWaiting(mQueue));
+    ReceiveAndCheck(7);
+    UNSIGNED_LONGS_EQUAL(0, uxQueueMessagesWaiting(mQueue));
+}
+
+TEST(FauxQueueLaneTests, given_bad_lane_arguments_then_no_queue_is_created)
+{
+    size_t depths[QUEUE_MAX_LANES + 1] = { 1, 0 };
+    CHECK_TRUE(xQueueCreateWithLanes(0, depths, sizeof(TestEvent)) == nullptr);
+    CHECK_TRUE(xQueueCreateWithLanes(1, nullptr, sizeof(TestEvent)) == nullptr);
+    CHECK_TRUE(xQueueCreateWithLanes(2, depths, sizeof(TestEvent)) == nullptr);
+    CHECK_TRUE(xQueueCreateWithLanes(QUEUE_MAX_LANES + 1, depths, sizeof(TestEvent)) == nullptr);
+
+    QueueHandle_t queue = xQueueCreateWithMode(TestQueueDepth, sizeof(TestEvent), QUEUE_MODE_SPSC);
+    TestEvent event = { 1, 10 };
+    CHECK_FALSE(xQueueSendToLane(queue, &event, 0));
+    vQueueDelete(queue);
+}
+
+TEST(FauxQueueTests, given_histogram_then_percentiles_report_bucket_upper_bounds)
+{
+    QueueStatsT stats = {};
+    UNSIGNED_LONGS_EQUAL(0, uxQueueStatsLatencyPercentileNs(&stats, 50.0));
+
+    for (size_t i = 1; i < QUEUE_STATS_LATENCY_BUCKETS; ++i)
+    {
+        CHECK_TRUE(uxQueueStatsBucketLowerBoundNs(i) > uxQueueStatsBucketLowerBoundNs(i - 1));
+    }
+
+    stats.latencyHistogram[20] = 99;
+    stats.latencyHistogram[40] = 1;
+    UNSIGNED_LONGS_EQUAL(uxQueueStatsBucketLowerBoundNs(21) - 1, uxQueueStatsLatencyPercentileNs(&stats, 50.0));
+    UNSIGNED_LONGS_EQUAL(uxQueueStatsBucketLowerBoundNs(21) - 1, uxQueueStatsLatencyPercentileNs(&stats, 99.0));
+    UNSIGNED_LONGS_EQUAL(uxQueueStatsBucketLowerBoundNs(41) - 1, uxQueueStatsLatencyPercentileNs(&stats, 99.9));
+}
+
+TEST(FauxQueueTimedTests, given_any_mode_then_stats_are_disabled_by_default_and_count_once_enabled)
+{
+    for (auto mode : AllModes)
+    {
+        QueueHandle_t queue = xQueueCreateWithMode(TestQueueDepth, sizeof(TestEvent), mode);
+        TestEvent events[TestQueueDepth] = {};
+        size_t count = 0;
+        QueueStatsT stats;
+
+        Fill(queue);
+        CHECK_TRUE(xQueueReceiveBatchTimed(queue, events, TestQueueDepth, &count, 0));
+        CHECK_TRUE(xQueueGetStats(queue, &stats));
+        UNSIGNED_LONGS_EQUAL(0, stats.normalPosts + stats.receives + stats.highWaterMark);
+
+        vQueueEnableStats(queue, true);
+        Fill(queue);
+        CHECK_FALSE(xQueueSendToBackTimed(queue, &events[0], 0));
+        CHECK_TRUE(xQueueReceiveTimed(queue, &events[0], 0));
+        CHECK_TRUE(xQueueReceiveBatchTimed(queue, events, TestQueueDepth, &count, 0));
+
+        CHECK_TRUE(xQueueGetStats(queue, &stats));
+        UNSIGNED_LONGS_EQUAL(TestQueueDepth, stats.normalPosts);
+        UNSIGNED_LONGS_EQUAL(1, stats.fullRejections);
+        UNSIGNED_LONGS_EQUAL(TestQueueDepth, stats.receives);
+        UNSIGNED_LONGS_EQUAL(TestQueueDepth, stats.highWaterMark);
+        UNSIGNED_LONGS_EQUAL(TestQueueDepth, LatencySamples(stats));
+        vQueueDelete(queue);
+    }
+}
@@ -0,0 +1,180 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "fauxScheduler.h"
+#include "CppUTest/TestHarness.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+/**
+ * @brief a trivial active object, counting its events and
+ *        detecting any concurrent dispatch.
+ */
+struct CountingObject
+{
+    QueueHandle_t queue = nullptr;
+    ScheduledObjectHandle_t scheduled = nullptr;
+    std::atomic<bool> inDispatch{false};
+    std::atomic<bool> concurrentDispatch{false};
+    std::atomic<uint32_t> processed{0};
+    uint32_t lastValue = 0;
+    bool outOfOrder = false;
+
+    static bool Dispatch(void* context)
+    {
+        auto self = static_cast<CountingObject*>(context);
+        if (self->inDispatch.exchange(true))
+        {
+            self->concurrentDispatch = true;
+        }
+
+        uint32_t value = 0;
+        bool ok = xQueueReceiveTimed(self->queue, &value, 0);
+        if (ok)
+        {
+            if (value != self->lastValue + 1)
+            {
+                self->outOfOrder = true;
+            }
+            self->lastValue = value;
+            self->processed++;
+        }
+
+        self->inDispatch = false;
+        return ok;
+    }
+};
+
+} // namespace
+
+TEST_GROUP(FauxSchedulerTests)
+{
+    static constexpr size_t ObjectCount = 200;
+    static constexpr uint32_t EventsPerObject = 200;
+
+    std::vector<CountingObject> mObjects{ObjectCount};
+
+    void setup() final
+    {
+        CHECK_TRUE(xSchedulerStart(4, nullptr));
+        for (auto& object : mObjects)
+        {
+            object.queue = xQueueCreateWithMode(8, sizeof(uint32_t), QUEUE_MODE_MPSC);
+            object.scheduled = xSchedulerRegister(object.queue, CountingObject::Dispatch, &object);
+        }
+    }
+
+    void teardown() final
+    {
+        for (auto& object : mObjects)
+        {
+            vSchedulerUnregister(object.scheduled);
+            vQueueDelete(object.queue);
+        }
+        vSchedulerStop();
+    }
+
+    bool WaitForAllProcessed()
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            bool done = true;
+            for (auto& object : mObjects)
+            {
+                done = done && (object.processed == EventsPerObject);
+            }
+
+            if (done)
+            {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return false;
+    }
+};
+
+TEST(FauxSchedulerTests, given_scheduler_running_then_start_again_fails)
+{
+    CHECK_TRUE(xSchedulerIsRunning());
+    CHECK_FALSE(xSchedulerStart(1, nullptr));
+}
+
+TEST(FauxSchedulerTests, given_many_objects_on_few_workers_then_every_event_runs_once_in_order_without_concurrent_dispatch)
+{
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < 2; ++p)
+    {
+        producers.emplace_back([this, p]() {
+            for (uint32_t value = 1; value <= EventsPerObject; ++value)
+            {
+                for (size_t i = p; i < ObjectCount; i += 2)
+                {
+                    while (!xQueueSendToBack(mObjects[i].queue, &value))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        });
+    }
+
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+
+    CHECK_TRUE(WaitForAllProcessed());
+    for (auto& object : mObjects)
+    {
+        CHECK_FALSE(object.concurrentDispatch);
+        CHECK_FALSE(object.outOfOrder);
+    }
+}
+
+TEST(FauxSchedulerTests, given_events_posted_before_registration_then_they_are_dispatched)
+{
+    QueueHandle_t queue = xQueueCreate(4, sizeof(uint32_t));
+    CountingObject object;
+    object.queue = queue;
+    uint32_t value = 1;
+    xQueueSendToBack(queue, &value);
+
+    object.scheduled = xSchedulerRegister(queue, CountingObject::Dispatch, &object);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((object.processed == 0) && (std::chrono::steady_clock::now() < deadline))
+    {
+        std::this_thread::yield();
+    }
+
+    vSchedulerUnregister(object.scheduled);
+    vQueueDelete(queue);
+    UNSIGNED_LONGS_EQUAL(1, object.processed);
+}
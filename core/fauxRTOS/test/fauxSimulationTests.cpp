@@ -0,0 +1,180 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "fauxSimulation.h"
+#include "fauxScheduler.h"
+#include "fauxTimer.h"
+#include "CppUTest/TestHarness.h"
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+
+/**
+ * @brief a trivial active object, recording the order in which
+ *        all objects process their events.
+ */
+struct RecordingObject
+{
+    uint32_t id = 0;
+    QueueHandle_t queue = nullptr;
+    ScheduledObjectHandle_t scheduled = nullptr;
+    std::vector<uint32_t>* log = nullptr;
+    QueueHandle_t forwardTo = nullptr;
+
+    static bool Dispatch(void* context)
+    {
+        auto self = static_cast<RecordingObject*>(context);
+        uint32_t value = 0;
+        if (!xQueueReceiveTimed(self->queue, &value, 0))
+        {
+            return false;
+        }
+
+        self->log->push_back(self->id);
+        if (self->forwardTo != nullptr)
+        {
+            xQueueSendToBack(self->forwardTo, &value);
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+TEST_GROUP(FauxSimulationTests)
+{
+    static constexpr uint32_t ObjectCount = 4;
+    static constexpr uint32_t EventsPerObject = 25;
+
+    RecordingObject mObjects[ObjectCount];
+    std::vector<uint32_t> mLog;
+
+    void setup() final
+    {
+    }
+
+    void teardown() final
+    {
+        vSimulationStop();
+    }
+
+    void CreateObjects()
+    {
+        mLog.clear();
+        for (uint32_t i = 0; i < ObjectCount; ++i)
+        {
+            mObjects[i].id = i;
+            mObjects[i].log = &mLog;
+            mObjects[i].queue = xQueueCreate(EventsPerObject * 2, sizeof(uint32_t));
+            mObjects[i].scheduled = xSchedulerRegister(mObjects[i].queue, RecordingObject::Dispatch, &mObjects[i]);
+        }
+    }
+
+    void DestroyObjects()
+    {
+        for (auto& object : mObjects)
+        {
+            vSchedulerUnregister(object.scheduled);
+            vQueueDelete(object.queue);
+            object = RecordingObject();
+        }
+    }
+
+    std::vector<uint32_t> RunWithSeed(uint32_t seed)
+    {
+        xSimulationStart(seed);
+        CreateObjects();
+        for (uint32_t e = 0; e < EventsPerObject; ++e)
+        {
+            for (auto& object : mObjects)
+            {
+                xQueueSendToBack(object.queue, &e);
+            }
+        }
+
+        uxSimulationRunUntilIdle(SIZE_MAX);
+        DestroyObjects();
+        vSimulationStop();
+        return mLog;
+    }
+};
+
+TEST(FauxSimulationTests, simulation_cannot_start_while_scheduler_is_running)
+{
+    CHECK_TRUE(xSchedulerStart(1, nullptr));
+    CHECK_FALSE(xSimulationStart(1));
+    CHECK_FALSE(xSimulationIsRunning());
+    vSchedulerStop();
+
+    CHECK_TRUE(xSimulationStart(1));
+    CHECK_TRUE(xSimulationIsRunning());
+    CHECK_TRUE(xSchedulerIsRunning());
+    CHECK_TRUE(xTimerServiceIsRunning());
+    CHECK_FALSE(xSimulationStep());
+}
+
+TEST(FauxSimulationTests, same_seed_replays_the_same_interleaving_and_another_seed_does_not)
+{
+    auto first = RunWithSeed(42);
+    auto replay = RunWithSeed(42);
+    auto other = RunWithSeed(7);
+
+    CHECK_EQUAL(ObjectCount * EventsPerObject, first.size());
+    CHECK_TRUE(first == replay);
+    CHECK_TRUE(first != other);
+}
+
+TEST(FauxSimulationTests, events_posted_by_a_dispatch_are_simulated_in_the_same_run)
+{
+    CHECK_TRUE(xSimulationStart(3));
+    CreateObjects();
+    mObjects[0].forwardTo = mObjects[1].queue;
+
+    uint32_t event = 1;
+    xQueueSendToBack(mObjects[0].queue, &event);
+    CHECK_EQUAL(2u, uxSimulationRunUntilIdle(SIZE_MAX));
+    CHECK_TRUE((mLog == std::vector<uint32_t>{0, 1}));
+    DestroyObjects();
+}
+
+TEST(FauxSimulationTests, run_for_an_hour_of_virtual_time_jumps_between_timer_expiries)
+{
+    CHECK_TRUE(xSimulationStart(5));
+    CreateObjects();
+
+    //a periodic timer every second, chained through a second active object
+    mObjects[0].forwardTo = mObjects[1].queue;
+    uint32_t event = 0;
+    auto timer = xTimerCreate("sim", pdMS_TO_TICKS(1000), true, mObjects[0].queue, &event, sizeof(event));
+    CHECK_TRUE(xTimerStart(timer));
+
+    const TickType_t hour = pdMS_TO_TICKS(60 * 60 * 1000);
+    CHECK_EQUAL(2 * 3600u, uxSimulationRunFor(hour));
+    CHECK_EQUAL(hour, xTimerGetTickCount());
+    CHECK_EQUAL(0u, uxTimerGetDroppedCount(timer));
+
+    vTimerDelete(timer);
+    DestroyObjects();
+}
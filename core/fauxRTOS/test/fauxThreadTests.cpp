@@ -0,0 +1,153 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "fauxThread.h"
+#include "CppUTest/TestHarness.h"
+#include <pthread.h>
+#include <sched.h>
+#include <cerrno>
+#include <chrono>
+#include <string>
+#include <sys/resource.h>
+
+//task functions take no arguments, results are captured here.
+static bool s_ran = false;
+static std::string s_name;
+static int s_policy = -1;
+static int s_nice = 0;
+static bool s_onlyCpu0 = false;
+
+static void CaptureTask()
+{
+    s_ran = true;
+
+    char name[16] = {};
+    pthread_getname_np(pthread_self(), name, sizeof(name));
+    s_name = name;
+
+    sched_param param = {};
+    pthread_getschedparam(pthread_self(), &s_policy, &param);
+
+    errno = 0;
+    s_nice = getpriority(PRIO_PROCESS, 0);
+
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    s_onlyCpu0 = (CPU_COUNT(&cpus) == 1) && CPU_ISSET(0, &cpus);
+#endif
+}
+
+TEST_GROUP(FauxThreadTests)
+{
+    TaskHandle_t mTask = nullptr;
+
+    void setup() final
+    {
+        s_ran = false;
+        s_name.clear();
+        s_policy = -1;
+        s_nice = 0;
+        s_onlyCpu0 = false;
+    }
+
+    void teardown() final
+    {
+        vTaskDelete(mTask);
+    }
+};
+
+TEST(FauxThreadTests, given_default_task_then_it_runs_with_its_name_and_delete_joins)
+{
+    CHECK_TRUE(xTaskCreate(CaptureTask, "FauxThreadTestTask", 4096, &mTask));
+    vTaskDelete(mTask);
+    mTask = nullptr;
+    CHECK_TRUE(s_ran);
+    STRCMP_EQUAL("FauxThreadTestT", s_name.c_str());
+    LONGS_EQUAL(SCHED_OTHER, s_policy);
+}
+
+TEST(FauxThreadTests, given_tiny_stack_depth_then_task_is_still_created)
+{
+    CHECK_TRUE(xTaskCreate(CaptureTask, "tiny", 1, &mTask));
+    vTaskDelete(mTask);
+    mTask = nullptr;
+    CHECK_TRUE(s_ran);
+}
+
+TEST(FauxThreadTests, delay_blocks_for_at_least_the_ticks_given)
+{
+    auto start = std::chrono::steady_clock::now();
+    vTaskDelay(pdMS_TO_TICKS(5));
+    CHECK_TRUE((std::chrono::steady_clock::now() - start) >= std::chrono::milliseconds(5));
+}
+
+#ifdef __linux__
+TEST(FauxThreadTests, given_normal_options_then_nice_value_and_affinity_are_applied)
+{
+    //a lower priority, as raising it requires privileges.
+    TaskOptionsT options = { TASK_SCHED_NORMAL, -3, 0x1 };
+    CHECK_TRUE(xTaskCreateWithOptions(CaptureTask, "opts", 0, &options, &mTask));
+    vTaskDelete(mTask);
+    mTask = nullptr;
+    CHECK_TRUE(s_ran);
+    CHECK_TRUE(s_nice >= 3);
+    CHECK_TRUE(s_onlyCpu0);
+}
+
+TEST(FauxThreadTests, given_raised_normal_priority_then_nice_value_is_applied_or_creation_fails)
+{
+    TaskOptionsT options = { TASK_SCHED_NORMAL, 5, 0 };
+    if (xTaskCreateWithOptions(CaptureTask, "nice", 0, &options, &mTask))
+    {
+        vTaskDelete(mTask);
+        mTask = nullptr;
+        CHECK_TRUE(s_ran);
+        LONGS_EQUAL(-5, s_nice);
+    }
+    else
+    {
+        //insufficient privileges in this environment, the task never ran
+        POINTERS_EQUAL(nullptr, mTask);
+        CHECK_FALSE(s_ran);
+    }
+}
+#endif
+
+TEST(FauxThreadTests, given_realtime_options_then_task_runs_fifo_or_creation_fails)
+{
+    TaskOptionsT options = { TASK_SCHED_REALTIME, 10, 0 };
+    if (xTaskCreateWithOptions(CaptureTask, "rt", 0, &options, &mTask))
+    {
+        vTaskDelete(mTask);
+        mTask = nullptr;
+        CHECK_TRUE(s_ran);
+        LONGS_EQUAL(SCHED_FIFO, s_policy);
+    }
+    else
+    {
+        //insufficient privileges in this environment
+        POINTERS_EQUAL(nullptr, mTask);
+    }
+}
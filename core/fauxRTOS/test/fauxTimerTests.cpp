@@ -0,0 +1,225 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "fauxTimer.h"
+#include "CppUTest/TestHarness.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+TEST_GROUP(FauxTimerTests)
+{
+    QueueHandle_t mQueue = nullptr;
+
+    void setup() final
+    {
+        CHECK_TRUE(xTimerServiceStart(TIMER_CLOCK_VIRTUAL));
+        mQueue = xQueueCreate(16, sizeof(uint32_t));
+    }
+
+    void teardown() final
+    {
+        vTimerServiceStop();
+        vQueueDelete(mQueue);
+    }
+
+    TimerHandle_t CreateTimer(TickType_t period, bool autoReload, uint32_t event)
+    {
+        return xTimerCreate("test", period, autoReload, mQueue, &event, sizeof(event));
+    }
+
+    uint32_t ReceiveNow()
+    {
+        uint32_t event = 0;
+        return xQueueReceiveTimed(mQueue, &event, 0) ? event : UINT32_MAX;
+    }
+};
+
+TEST(FauxTimerTests, create_rejects_bad_arguments_and_is_dormant)
+{
+    uint32_t event = 1;
+    CHECK_TRUE(xTimerCreate("zero", 0, false, mQueue, &event, sizeof(event)) == nullptr);
+    CHECK_TRUE(xTimerCreate("no queue", 10, false, nullptr, &event, sizeof(event)) == nullptr);
+
+    auto timer = CreateTimer(10, false, event);
+    CHECK_FALSE(xTimerIsTimerActive(timer));
+    vTimerAdvanceTicks(100);
+    CHECK_EQUAL(0u, uxQueueMessagesWaiting(mQueue));
+    vTimerDelete(timer);
+}
+
+TEST(FauxTimerTests, one_shot_timer_posts_its_event_once_after_its_period)
+{
+    auto timer = CreateTimer(10, false, 42);
+    CHECK_TRUE(xTimerStart(timer));
+    CHECK_TRUE(xTimerIsTimerActive(timer));
+
+    vTimerAdvanceTicks(9);
+    CHECK_EQUAL(0u, uxQueueMessagesWaiting(mQueue));
+
+    vTimerAdvanceTicks(1);
+    CHECK_EQUAL(10u, xTimerGetTickCount());
+    CHECK_EQUAL(42u, ReceiveNow());
+    CHECK_FALSE(xTimerIsTimerActive(timer));
+
+    vTimerAdvanceTicks(1000);
+    CHECK_EQUAL(0u, uxQueueMessagesWaiting(mQueue));
+    vTimerDelete(timer);
+}
+
+TEST(FauxTimerTests, periodic_timer_posts_every_period_until_stopped)
+{
+    auto timer = CreateTimer(5, true, 7);
+    CHECK_TRUE(xTimerStart(timer));
+
+    vTimerAdvanceTicks(23);
+    CHECK_EQUAL(4u, uxQueueMessagesWaiting(mQueue));
+    CHECK_TRUE(xTimerIsTimerActive(timer));
+
+    CHECK_TRUE(xTimerStop(timer));
+    CHECK_FALSE(xTimerIsTimerActive(timer));
+    vTimerAdvanceTicks(100);
+    CHECK_EQUAL(4u, uxQueueMessagesWaiting(mQueue));
+    vTimerDelete(timer);
+}
+
+TEST(FauxTimerTests, start_restarts_and_change_period_rearms_a_running_timer)
+{
+    auto timer = CreateTimer(10, false, 1);
+    CHECK_TRUE(xTimerStart(timer));
+    vTimerAdvanceTicks(8);
+    CHECK_TRUE(xTimerStart(timer));
+    vTimerAdvanceTicks(8);
+    CHECK_EQUAL(0u, uxQueueMessagesWaiting(mQueue));
+    vTimerAdvanceTicks(2);
+    CHECK_EQUAL(1u, uxQueueMessagesWaiting(mQueue));
+
+    CHECK_TRUE(xTimerChangePeriod(timer, 100));
+    vTimerAdvanceTicks(99);
+    CHECK_EQUAL(1u, uxQueueMessagesWaiting(mQueue));
+    vTimerAdvanceTicks(1);
+    CHECK_EQUAL(2u, uxQueueMessagesWaiting(mQueue));
+    vTimerDelete(timer);
+}
+
+TEST(FauxTimerTests, expiry_is_dropped_and_counted_when_the_queue_is_full)
+{
+    auto timer = CreateTimer(1, true, 3);
+    CHECK_TRUE(xTimerStart(timer));
+    vTimerAdvanceTicks(20);
+    CHECK_EQUAL(16u, uxQueueMessagesWaiting(mQueue));
+    CHECK_EQUAL(4u, uxTimerGetDroppedCount(timer));
+    vTimerDelete(timer);
+}
+
+TEST(FauxTimerTests, timer_with_a_queue_lane_posts_to_that_lane)
+{
+    const size_t depths[] = { 4, 1 };
+    QueueHandle_t lanes = xQueueCreateWithLanes(2, depths, sizeof(uint32_t));
+    uint32_t event = 9;
+    auto timer = xTimerCreate("lane", 3, false, lanes, &event, sizeof(event));
+    CHECK_FALSE(xTimerSetQueueLane(nullptr, 1));
+    CHECK_FALSE(xTimerSetQueueLane(timer, QUEUE_MAX_LANES));
+    CHECK_TRUE(xTimerSetQueueLane(timer, 1));
+
+    CHECK_TRUE(xTimerStart(timer));
+    vTimerAdvanceTicks(3);
+    CHECK_EQUAL(1u, uxQueueLaneMessagesWaiting(lanes, 1));
+    CHECK_EQUAL(0u, uxQueueLaneMessagesWaiting(lanes, 0));
+
+    //the lane is full, the next expiry is dropped
+    CHECK_TRUE(xTimerStart(timer));
+    vTimerAdvanceTicks(3);
+    CHECK_EQUAL(1u, uxTimerGetDroppedCount(timer));
+    vTimerDelete(timer);
+    vQueueDelete(lanes);
+}
+
+TEST(FauxTimerTests, many_timers_across_all_wheel_levels_expire_exactly_on_time)
+{
+    constexpr uint32_t TimerCount = 10000;
+    QueueHandle_t queue = xQueueCreate(TimerCount, sizeof(uint32_t));
+
+    //periods up to 2^25 ticks also exceed the span of the top wheel level
+    std::mt19937 random(1234);
+    std::vector<TimerHandle_t> timers;
+    std::vector<TickType_t> expiries;
+    for (uint32_t i = 0; i < TimerCount; ++i)
+    {
+        TickType_t period = 1 + (random() % (1u << (1 + (i % 25))));
+        auto timer = xTimerCreate("many", period, false, queue, &i, sizeof(i));
+        CHECK_TRUE(timer != nullptr);
+        CHECK_TRUE(xTimerStart(timer));
+        timers.push_back(timer);
+        expiries.push_back(period);
+    }
+
+    std::vector<TickType_t> distinct(expiries);
+    std::sort(distinct.begin(), distinct.end());
+    distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+
+    size_t received = 0;
+    for (auto expiry : distinct)
+    {
+        vTimerAdvanceTicks(expiry - 1 - xTimerGetTickCount());
+        CHECK_EQUAL(0u, uxQueueMessagesWaiting(queue));
+
+        vTimerAdvanceTicks(1);
+        CHECK_TRUE(uxQueueMessagesWaiting(queue) > 0);
+        uint32_t index = 0;
+        while (xQueueReceiveTimed(queue, &index, 0))
+        {
+            CHECK_EQUAL(expiry, expiries[index]);
+            received++;
+        }
+    }
+
+    CHECK_EQUAL(TimerCount, received);
+    for (auto timer : timers)
+    {
+        vTimerDelete(timer);
+    }
+    vQueueDelete(queue);
+}
+
+TEST(FauxTimerTests, real_clock_timer_thread_posts_after_the_period)
+{
+    vTimerServiceStop();
+    CHECK_TRUE(xTimerServiceStart(TIMER_CLOCK_REAL));
+
+    auto timer = CreateTimer(pdMS_TO_TICKS(20), true, 9);
+    auto start = std::chrono::steady_clock::now();
+    CHECK_TRUE(xTimerStart(timer));
+
+    uint32_t event = 0;
+    CHECK_TRUE(xQueueReceiveTimed(mQueue, &event, pdMS_TO_TICKS(1000)));
+    CHECK_TRUE(xQueueReceiveTimed(mQueue, &event, pdMS_TO_TICKS(1000)));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    CHECK_EQUAL(9u, event);
+    //as with FreeRTOS, the first period may be up to one tick short
+    CHECK_TRUE(elapsed >= std::chrono::milliseconds(39));
+    CHECK_TRUE(xTimerGetTickCount() >= 40u);
+    vTimerDelete(timer);
+}
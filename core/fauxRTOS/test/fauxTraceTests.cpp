@@ -0,0 +1,165 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "fauxTrace.h"
+#include "fauxQueue.h"
+#include "fauxThread.h"
+#include "CppUTest/TestHarness.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST_GROUP(FauxTraceTests)
+{
+    std::vector<TraceRecordT> mRecords;
+
+    void setup() final
+    {
+        vTraceClear();
+        mRecords.resize(4 * TRACE_RING_RECORDS);
+    }
+
+    void teardown() final
+    {
+        vTraceEnable(false);
+        vTraceClear();
+    }
+
+    size_t Collect()
+    {
+        size_t count = uxTraceCollect(mRecords.data(), mRecords.size());
+        mRecords.resize(count);
+        return count;
+    }
+};
+
+TEST(FauxTraceTests, nothing_is_recorded_while_disabled)
+{
+    vTraceEnable(false);
+    vTraceRecord(TRACE_EVENT_USER, nullptr, 1, 2, 3);
+    CHECK_FALSE(xTraceIsEnabled());
+    CHECK_EQUAL(0u, Collect());
+}
+
+TEST(FauxTraceTests, queue_post_and_receive_are_recorded_in_order)
+{
+    vTraceEnable(true);
+    QueueHandle_t queue = xQueueCreate(4, sizeof(uint32_t));
+    uint32_t value = 5;
+    CHECK_TRUE(xQueueSendToBack(queue, &value));
+    CHECK_TRUE(xQueueSendToFront(queue, &value));
+    CHECK_TRUE(xQueueReceive(queue, &value));
+
+    CHECK_EQUAL(3u, Collect());
+    CHECK_EQUAL(TRACE_EVENT_QUEUE_POST, mRecords[0].type);
+    CHECK_EQUAL(1u, mRecords[0].arg0);
+    CHECK_EQUAL(0u, mRecords[0].arg1);
+    CHECK_EQUAL(TRACE_EVENT_QUEUE_POST, mRecords[1].type);
+    CHECK_EQUAL(2u, mRecords[1].arg0);
+    CHECK_EQUAL(1u, mRecords[1].arg1);
+    CHECK_EQUAL(TRACE_EVENT_QUEUE_RECEIVE, mRecords[2].type);
+    CHECK_EQUAL(1u, mRecords[2].arg1);
+    CHECK_EQUAL(reinterpret_cast<uintptr_t>(queue), mRecords[2].object);
+    CHECK_TRUE(mRecords[0].timestampNs <= mRecords[1].timestampNs);
+    CHECK_TRUE(mRecords[1].timestampNs <= mRecords[2].timestampNs);
+    vQueueDelete(queue);
+}
+
+static void TraceTask()
+{
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        vTraceRecord(TRACE_EVENT_USER, nullptr, i, 0, 0);
+    }
+}
+
+TEST(FauxTraceTests, each_thread_records_into_its_own_ring_and_rings_outlive_threads)
+{
+    vTraceEnable(true);
+    TaskHandle_t first = nullptr;
+    TaskHandle_t second = nullptr;
+    CHECK_TRUE(xTaskCreate(TraceTask, "trace-a", 0, &first));
+    CHECK_TRUE(xTaskCreate(TraceTask, "trace-b", 0, &second));
+    vTaskDelete(first);
+    vTaskDelete(second);
+
+    CHECK_EQUAL(200u, Collect());
+    uint32_t next[2] = {0, 0};
+    uint16_t threads[2] = {mRecords[0].thread, 0};
+    for (const auto& record : mRecords)
+    {
+        if ((record.thread != threads[0]) && (threads[1] == 0))
+        {
+            threads[1] = record.thread;
+        }
+        size_t index = (record.thread == threads[0]) ? 0 : 1;
+        CHECK_EQUAL(threads[index], record.thread);
+        CHECK_EQUAL(next[index]++, record.arg0);
+    }
+    CHECK_EQUAL(100u, next[0]);
+    CHECK_EQUAL(100u, next[1]);
+}
+
+TEST(FauxTraceTests, a_full_ring_keeps_the_most_recent_records)
+{
+    vTraceEnable(true);
+    for (uint32_t i = 0; i < TRACE_RING_RECORDS + 10; ++i)
+    {
+        vTraceRecord(TRACE_EVENT_USER, nullptr, i, 0, 0);
+    }
+
+    CHECK_EQUAL(static_cast<size_t>(TRACE_RING_RECORDS - 1), Collect());
+    CHECK_EQUAL(11u, mRecords.front().arg0);
+    CHECK_EQUAL(TRACE_RING_RECORDS + 9u, mRecords.back().arg0);
+}
+
+TEST(FauxTraceTests, trace_file_converts_to_chrome_json_with_names)
+{
+    vTraceEnable(true);
+    vTraceSetThreadName("trace-test");
+    int object = 0;
+    vTraceSetObjectName(&object, "traced object");
+    vTraceRecord(TRACE_EVENT_DISPATCH_BEGIN, &object, 3, 0, 0);
+    vTraceRecord(TRACE_EVENT_STATE_TRANSITION, &object, 1, 2, 3);
+    vTraceRecord(TRACE_EVENT_DISPATCH_END, &object, 3, 2, 0);
+
+    const char* tracePath = "fauxTraceTest.bin";
+    const char* jsonPath = "fauxTraceTest.json";
+    CHECK_TRUE(xTraceWriteFile(tracePath));
+    CHECK_TRUE(xTraceConvertToChromeJson(tracePath, jsonPath));
+    CHECK_FALSE(xTraceConvertToChromeJson(jsonPath, jsonPath));
+
+    std::ifstream json(jsonPath);
+    std::stringstream contents;
+    contents << json.rdbuf();
+    std::string text = contents.str();
+    CHECK_TRUE(text.find("\"traceEvents\"") != std::string::npos);
+    CHECK_TRUE(text.find("\"name\":\"trace-test\"") != std::string::npos);
+    CHECK_TRUE(text.find("\"ph\":\"B\",\"cat\":\"dispatch\",\"name\":\"traced object\"") != std::string::npos);
+    CHECK_TRUE(text.find("\"source\":1,\"target\":2,\"signal\":3") != std::string::npos);
+
+    remove(tracePath);
+    remove(jsonPath);
+}
@@ -0,0 +1,231 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CMSEVENTBUS_HPP
+#define CMSEVENTBUS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include "cmsBaseEvent.hpp"
+#include "cmsTypeUtils.hpp"
+#include "fauxQueue.h"
+
+namespace cms
+{
+
+/**
+ * @brief EventBus - publish/subscribe delivery of EventT, a cms::BaseEvent
+ *        derivative, for the signals FirstSignal to FirstSignal + SignalCount - 1.
+ *
+ *        Each subscriber is a queue owned by the subscriber, typically its
+ *        active object's event queue, holding items of sizeof(EventT).
+ *        Each signal has a bitmap of its subscribers. Publish() copies the
+ *        event into each subscribed queue with a non-blocking send, so a slow
+ *        subscriber never stalls the publisher: when its queue is full, the
+ *        event is dropped for that subscriber and counted by Dropped().
+ *
+ *        All methods are thread safe. Publish() takes no lock.
+ */
+template<typename EventT, uint32_t FirstSignal, size_t SignalCount, size_t MaxSubscribers = 32>
+class EventBus
+{
+    static_assert(is_base_of_any<BaseEvent, EventT>::value, "EventT must derive from cms::BaseEvent");
+    static_assert(std::is_trivially_copyable<EventT>::value, "EventT is copied into queues, must be trivially copyable");
+    static_assert((MaxSubscribers > 0) && (MaxSubscribers <= 64), "MaxSubscribers must be 1 to 64");
+    static_assert(SignalCount > 0, "SignalCount must be greater than zero");
+
+public:
+    using SubscriberId = size_t;
+    static constexpr SubscriberId InvalidSubscriber = MaxSubscribers;
+
+    EventBus() :
+        mSubscribers(),
+        mSubscriptions(),
+        mSendsInFlight(),
+        mDropped(0)
+    {
+        for (auto& subscriber : mSubscribers)
+        {
+            subscriber.store(nullptr, std::memory_order_relaxed);
+        }
+
+        for (auto& sends : mSendsInFlight)
+        {
+            sends.store(0, std::memory_order_relaxed);
+        }
+
+        for (auto& subscriptions : mSubscriptions)
+        {
+            subscriptions.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    /**
+     * @brief AddSubscriber - register a queue, initially subscribed to nothing.
+     * @return the subscriber's id, InvalidSubscriber if all slots are in use.
+     */
+    SubscriberId AddSubscriber(QueueHandle_t queue)
+    {
+        if (queue == nullptr)
+        {
+            return InvalidSubscriber;
+        }
+
+        for (SubscriberId id = 0; id < MaxSubscribers; ++id)
+        {
+            QueueHandle_t expected = nullptr;
+            if (mSubscribers[id].compare_exchange_strong(expected, queue))
+            {
+                return id;
+            }
+        }
+
+        return InvalidSubscriber;
+    }
+
+    /**
+     * @brief RemoveSubscriber - unsubscribe from all signals, then wait
+     *        for any Publish() which may still be sending to the queue.
+     *        The queue may be deleted once this returns. Only publishes
+     *        already sending to this subscriber are waited for, so the
+     *        wait is bounded, however busy other publishers are.
+     */
+    void RemoveSubscriber(SubscriberId id)
+    {
+        if (id >= MaxSubscribers)
+        {
+            return;
+        }
+
+        for (auto& subscriptions : mSubscriptions)
+        {
+            subscriptions.fetch_and(~Bit(id));
+        }
+
+        while (mSendsInFlight[id].load() != 0)
+        {
+            std::this_thread::yield();
+        }
+
+        mSubscribers[id].store(nullptr);
+    }
+
+    bool Subscribe(SubscriberId id, uint32_t signal)
+    {
+        if (!Valid(id, signal))
+        {
+            return false;
+        }
+
+        mSubscriptions[signal - FirstSignal].fetch_or(Bit(id));
+        return true;
+    }
+
+    bool Unsubscribe(SubscriberId id, uint32_t signal)
+    {
+        if (!Valid(id, signal))
+        {
+            return false;
+        }
+
+        mSubscriptions[signal - FirstSignal].fetch_and(~Bit(id));
+        return true;
+    }
+
+    /**
+     * @brief Publish - deliver a copy of event to every subscriber of
+     *        its signal, in subscriber id order. Never blocks.
+     * @return the number of subscribers the event was delivered to.
+     */
+    size_t Publish(const EventT& event)
+    {
+        if ((event.signal < FirstSignal) || (event.signal - FirstSignal >= SignalCount))
+        {
+            return 0;
+        }
+
+        const auto& subscriptions = mSubscriptions[event.signal - FirstSignal];
+        uint64_t subscribers = subscriptions.load();
+        size_t delivered = 0;
+        while (subscribers != 0)
+        {
+            auto id = static_cast<SubscriberId>(__builtin_ctzll(subscribers));
+            subscribers &= subscribers - 1;
+
+            //announce the send, then check the subscription again: either
+            //RemoveSubscriber() waits for this send, or it is seen removed.
+            mSendsInFlight[id].fetch_add(1);
+            if ((subscriptions.load() & Bit(id)) != 0)
+            {
+                QueueHandle_t queue = mSubscribers[id].load(std::memory_order_relaxed);
+                if ((queue != nullptr) && xQueueSendToBack(queue, &event))
+                {
+                    ++delivered;
+                }
+                else
+                {
+                    mDropped.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            mSendsInFlight[id].fetch_sub(1);
+        }
+
+        return delivered;
+    }
+
+    /**
+     * @brief Dropped - events not delivered because a subscriber's queue was full.
+     */
+    uint64_t Dropped() const
+    {
+        return mDropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr uint64_t Bit(SubscriberId id)
+    {
+        return uint64_t(1) << id;
+    }
+
+    bool Valid(SubscriberId id, uint32_t signal) const
+    {
+        return (id < MaxSubscribers) && (signal >= FirstSignal) && (signal - FirstSignal < SignalCount) &&
+               (mSubscribers[id].load(std::memory_order_relaxed) != nullptr);
+    }
+
+    std::atomic<QueueHandle_t> mSubscribers[MaxSubscribers];
+    std::atomic<uint64_t> mSubscriptions[SignalCount];
+    std::atomic<uint32_t> mSendsInFlight[MaxSubscribers]; //see RemoveSubscriber()
+    std::atomic<uint64_t> mDropped;
+};
+
+} //namespace cms
+
+#endif // CMSEVENTBUS_HPP
@@ -0,0 +1,340 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CMSEVENTPOOL_HPP
+#define CMSEVENTPOOL_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "cmsBaseEvent.hpp"
+#include "cmsTypeUtils.hpp"
+
+namespace cms
+{
+
+struct EventPoolClass
+{
+    size_t blockSize;  //largest event, in bytes, held by this class
+    size_t blockCount;
+};
+
+struct EventPoolClassStats
+{
+    size_t blockSize;
+    size_t blockCount;
+    size_t inUse;
+    size_t highWaterMark;
+    uint64_t allocations;
+    uint64_t exhaustions; //a request for this class found it empty
+};
+
+/**
+ * @brief EventPool - fixed size blocks, in up to MaxClasses size classes,
+ *        all carved from one arena allocated at construction. Nothing
+ *        is allocated afterwards.
+ *
+ *        Large events are allocated from the pool with New(), and only
+ *        their pointer is sent through queues (of sizeof(EventT*) items),
+ *        so the payload is never copied. Each block carries an atomic
+ *        reference count: to multicast, AddRef() once per additional
+ *        receiver, then send the same pointer to each queue. Every
+ *        receiver calls Release() when done, and the last Release()
+ *        returns the block to its class's lock-free free list.
+ *
+ *        A request is served by the smallest class which fits, or when
+ *        that class is exhausted, by the next larger class.
+ *
+ * @note: pooled events must be trivially destructible cms::BaseEvent
+ *        derivatives, no destructor is executed on Release().
+ */
+class EventPool
+{
+public:
+    static constexpr size_t MaxClasses = 8;
+
+    explicit EventPool(std::initializer_list<EventPoolClass> classes) :
+        mClassCount(0),
+        mArena(),
+        mFailures(0)
+    {
+        assert((classes.size() > 0) && (classes.size() <= MaxClasses));
+
+        size_t arenaSize = 0;
+        for (const auto& config : classes)
+        {
+            assert(((mClassCount == 0) || (config.blockSize > mClasses[mClassCount - 1].eventSize)) &&
+                   "size classes must be in ascending order");
+            assert(config.blockCount < NoBlock);
+
+            auto& sizeClass = mClasses[mClassCount++];
+            sizeClass.eventSize = config.blockSize;
+            sizeClass.blockSize = RoundUp(HeaderSize + config.blockSize);
+            sizeClass.blockCount = config.blockCount;
+            arenaSize += sizeClass.blockSize * sizeClass.blockCount;
+        }
+
+        mArena.reset(new uint8_t[arenaSize + BlockAlignment]);
+        auto base = reinterpret_cast<uintptr_t>(mArena.get());
+        auto block = reinterpret_cast<uint8_t*>(RoundUp(base));
+        for (size_t i = 0; i < mClassCount; ++i)
+        {
+            mClasses[i].Carve(block, static_cast<uint8_t>(i));
+            block += mClasses[i].blockSize * mClasses[i].blockCount;
+        }
+    }
+
+    EventPool(const EventPool&) = delete;
+    EventPool& operator=(const EventPool&) = delete;
+
+    /**
+     * @brief New - construct an EventT in a pool block, with a reference count of 1.
+     * @return nullptr if every class large enough is exhausted.
+     */
+    template<typename EventT, typename... Args>
+    EventT* New(Args&&... args)
+    {
+        static_assert(is_base_of_any<BaseEvent, EventT>::value, "EventT must derive from cms::BaseEvent");
+        static_assert(std::is_trivially_destructible<EventT>::value, "pooled events are never destroyed");
+        static_assert(alignof(EventT) <= BlockAlignment, "EventT alignment is too large");
+
+        void* memory = Allocate(sizeof(EventT));
+        if (memory == nullptr)
+        {
+            return nullptr;
+        }
+
+        return new (memory) EventT(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief AddRef - add references, one per additional receiver.
+     */
+    template<typename EventT>
+    void AddRef(const EventT* event, uint32_t count = 1)
+    {
+        HeaderOf(event)->refCount.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Release - drop one reference, the last reference
+     *        returns the block to its pool.
+     */
+    template<typename EventT>
+    void Release(const EventT* event)
+    {
+        Header* header = HeaderOf(event);
+        if (header->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            mClasses[header->sizeClass].Push(header);
+        }
+    }
+
+    template<typename EventT>
+    static uint32_t RefCount(const EventT* event)
+    {
+        return HeaderOf(event)->refCount.load(std::memory_order_relaxed);
+    }
+
+    size_t ClassCount() const
+    {
+        return mClassCount;
+    }
+
+    EventPoolClassStats Stats(size_t sizeClass) const
+    {
+        assert(sizeClass < mClassCount);
+        return mClasses[sizeClass].Stats();
+    }
+
+    /**
+     * @brief Failures - requests which could not be served by any class.
+     */
+    uint64_t Failures() const
+    {
+        return mFailures.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t BlockAlignment = alignof(std::max_align_t);
+    static constexpr uint32_t NoBlock = UINT32_MAX;
+
+    struct Header
+    {
+        std::atomic<uint32_t> refCount;
+        std::atomic<uint32_t> next; //free list link, while the block is free
+        uint8_t sizeClass;
+    };
+
+    static constexpr size_t RoundUp(size_t size)
+    {
+        return (size + BlockAlignment - 1) & ~(BlockAlignment - 1);
+    }
+
+    static constexpr size_t HeaderSize = (sizeof(Header) + BlockAlignment - 1) & ~(BlockAlignment - 1);
+
+    template<typename EventT>
+    static Header* HeaderOf(const EventT* event)
+    {
+        auto bytes = reinterpret_cast<uint8_t*>(const_cast<EventT*>(event));
+        return reinterpret_cast<Header*>(bytes - HeaderSize);
+    }
+
+    /**
+     * @brief SizeClass - a lock-free (Treiber) stack of free blocks. The
+     *        head packs a block index with a tag incremented by every
+     *        update, which defeats the ABA problem. Each block's link is
+     *        kept in its header, so a class needs no storage of its own.
+     */
+    struct alignas(64) SizeClass
+    {
+        size_t eventSize = 0;
+        size_t blockSize = 0;
+        size_t blockCount = 0;
+        uint8_t* blocks = nullptr;
+        std::atomic<uint64_t> head{NoBlock};
+        std::atomic<size_t> inUse{0};
+        std::atomic<size_t> highWaterMark{0};
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> exhaustions{0};
+
+        void Carve(uint8_t* arena, uint8_t index)
+        {
+            blocks = arena;
+            for (size_t i = 0; i < blockCount; ++i)
+            {
+                auto header = new (BlockAt(i)) Header();
+                header->sizeClass = index;
+                header->next.store((i + 1 < blockCount) ? static_cast<uint32_t>(i + 1) : NoBlock,
+                                   std::memory_order_relaxed);
+            }
+            head.store((blockCount > 0) ? 0 : NoBlock);
+        }
+
+        uint8_t* BlockAt(size_t index) const
+        {
+            return blocks + (index * blockSize);
+        }
+
+        Header* HeaderAt(size_t index) const
+        {
+            return reinterpret_cast<Header*>(BlockAt(index));
+        }
+
+        Header* Pop()
+        {
+            uint64_t current = head.load(std::memory_order_acquire);
+            while (true)
+            {
+                auto index = static_cast<uint32_t>(current);
+                if (index == NoBlock)
+                {
+                    exhaustions.fetch_add(1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+
+                uint64_t tag = (current >> 32) + 1;
+                uint64_t replacement = (tag << 32) | HeaderAt(index)->next.load(std::memory_order_relaxed);
+                if (head.compare_exchange_weak(current, replacement, std::memory_order_acquire))
+                {
+                    OnAllocated();
+                    return HeaderAt(index);
+                }
+            }
+        }
+
+        void Push(Header* header)
+        {
+            auto index = static_cast<uint32_t>((reinterpret_cast<uint8_t*>(header) - blocks) / blockSize);
+            inUse.fetch_sub(1, std::memory_order_relaxed);
+
+            uint64_t current = head.load(std::memory_order_relaxed);
+            while (true)
+            {
+                header->next.store(static_cast<uint32_t>(current), std::memory_order_relaxed);
+                uint64_t tag = (current >> 32) + 1;
+                if (head.compare_exchange_weak(current, (tag << 32) | index, std::memory_order_release))
+                {
+                    return;
+                }
+            }
+        }
+
+        void OnAllocated()
+        {
+            allocations.fetch_add(1, std::memory_order_relaxed);
+            size_t used = inUse.fetch_add(1, std::memory_order_relaxed) + 1;
+            size_t highWater = highWaterMark.load(std::memory_order_relaxed);
+            while ((used > highWater) &&
+                   !highWaterMark.compare_exchange_weak(highWater, used, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        EventPoolClassStats Stats() const
+        {
+            return EventPoolClassStats{ eventSize, blockCount,
+                                        inUse.load(std::memory_order_relaxed),
+                                        highWaterMark.load(std::memory_order_relaxed),
+                                        allocations.load(std::memory_order_relaxed),
+                                        exhaustions.load(std::memory_order_relaxed) };
+        }
+    };
+
+    void* Allocate(size_t size)
+    {
+        for (size_t i = 0; i < mClassCount; ++i)
+        {
+            if (mClasses[i].eventSize < size)
+            {
+                continue;
+            }
+
+            Header* header = mClasses[i].Pop();
+            if (header != nullptr)
+            {
+                header->refCount.store(1, std::memory_order_relaxed);
+                return reinterpret_cast<uint8_t*>(header) + HeaderSize;
+            }
+        }
+
+        mFailures.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    SizeClass mClasses[MaxClasses];
+    size_t mClassCount;
+    std::unique_ptr<uint8_t[]> mArena;
+    std::atomic<uint64_t> mFailures;
+};
+
+} //namespace cms
+
+#endif // CMSEVENTPOOL_HPP
@@ -9,7 +9,8 @@
 typedef enum ExecutionOption
 {
     EXECUTION_OPTION_NORMAL,
-    EXECUTION_OPTION_UNIT_TEST
+    EXECUTION_OPTION_UNIT_TEST,
+    EXECUTION_OPTION_SHARED_SCHEDULER //run on the faux scheduler's worker pool, see fauxScheduler.h
 } ExecutionOptionT;
 
 #endif //ACTIVEOBJECTUNITTESTINGDEMO_CMSEXECUTIONOPTION_H
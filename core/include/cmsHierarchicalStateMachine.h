@@ -0,0 +1,255 @@
+//
+// Hierarchical state machine - the C callable adapter.
+//
+// Extends the flat table driven state machine (cmsTableStateMachine.h)
+// with superstates, initial transitions, shallow and deep history, and
+// entry/exit chains. A signal not handled by a state is handled by its
+// superstate. That inheritance, and each transition's least common
+// ancestor (LCA) exit count and entry path, are resolved once when the
+// table is generated, so dispatch never probes the hierarchy and every
+// transition is bounded by CMS_HSM_MAX_DEPTH.
+//
+// Tables are normally generated at compile time by the C++17
+// cms::HsmTable builder (see cmsHierarchicalStateMachine.hpp).
+//
+
+#ifndef CMSHIERARCHICALSTATEMACHINE_H
+#define CMSHIERARCHICALSTATEMACHINE_H
+
+#include "cmsTableStateMachine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CMS_HSM_MAX_DEPTH 8
+#define CMS_HSM_MAX_STATES 32
+#define CMS_HSM_NO_STATE 0xFF
+
+typedef enum CmsHsmHistory
+{
+    CMS_HSM_HISTORY_NONE,
+    CMS_HSM_HISTORY_SHALLOW, //resume the most recently active direct substate
+    CMS_HSM_HISTORY_DEEP     //resume the most recently active leaf state
+} CmsHsmHistoryT;
+
+typedef struct CmsHsmState
+{
+    uint8_t parent;       //CMS_HSM_NO_STATE for top level states
+    uint8_t initialChild; //CMS_HSM_NO_STATE for leaf states
+    uint8_t history;      //CmsHsmHistoryT
+    uint8_t entryAction;
+    uint8_t exitAction;
+} CmsHsmStateT;
+
+/**
+ * @brief CmsHsmCell - the resolved reaction of a leaf state to a signal.
+ *        A transition exits exitCount states, starting at the active
+ *        leaf state, executes the action, then enters the states of
+ *        entryPath, outermost first. The last state entered, if a
+ *        superstate, then resumes its history (historyOf) or follows
+ *        its initial transitions down to a leaf state.
+ */
+typedef struct CmsHsmCell
+{
+    uint8_t reaction; //CmsSmReactionT
+    uint8_t action;
+    uint8_t exitCount;
+    uint8_t entryCount;
+    uint8_t historyOf;
+    uint8_t entryPath[CMS_HSM_MAX_DEPTH];
+} CmsHsmCellT;
+
+typedef struct CmsHsmTable
+{
+    const CmsHsmStateT* states;  //one per state
+    const CmsHsmCellT* cells;    //stateCount rows of signalCount cells
+    uint8_t stateCount;
+    uint8_t signalCount;         //user signals, starting at CMS_SM_BEGIN_USER_SIGNALS
+} CmsHsmTableT;
+
+typedef struct CmsHsm
+{
+    const CmsHsmTableT* table;
+    const CmsSmActionFunc* actions; //indexed by action, entry 0 is unused
+    void* context;
+    uint8_t state;                  //the active leaf state
+    uint8_t history[CMS_HSM_MAX_STATES];
+} CmsHsmT;
+
+static inline void CmsHsm_Execute(const CmsHsmT* hsm, uint8_t action)
+{
+    if (action != CMS_SM_NO_ACTION)
+    {
+        hsm->actions[action](hsm->context);
+    }
+}
+
+/**
+ * @brief CmsHsm_EnterDown() - follow the initial transitions of an
+ *        already entered state, down to a leaf state.
+ */
+static inline void CmsHsm_EnterDown(CmsHsmT* hsm, uint8_t state)
+{
+    const CmsHsmStateT* states = hsm->table->states;
+    while (states[state].initialChild != CMS_HSM_NO_STATE)
+    {
+        state = states[state].initialChild;
+        CmsHsm_Execute(hsm, states[state].entryAction);
+    }
+    hsm->state = state;
+}
+
+/**
+ * @brief CmsHsm_EnterHistory() - resume the history of an already
+ *        entered superstate, or its initial transition if it has
+ *        no recorded history yet.
+ */
+static inline void CmsHsm_EnterHistory(CmsHsmT* hsm, uint8_t superstate)
+{
+    const CmsHsmStateT* states = hsm->table->states;
+    uint8_t resume = hsm->history[superstate];
+    if (resume == CMS_HSM_NO_STATE)
+    {
+        CmsHsm_EnterDown(hsm, superstate);
+        return;
+    }
+
+    uint8_t path[CMS_HSM_MAX_DEPTH];
+    uint8_t count = 0;
+    for (uint8_t state = resume; state != superstate; state = states[state].parent)
+    {
+        path[count++] = state;
+    }
+
+    while (count > 0)
+    {
+        CmsHsm_Execute(hsm, states[path[--count]].entryAction);
+    }
+    CmsHsm_EnterDown(hsm, resume);
+}
+
+/**
+ * @brief CmsHsm_Initialize() - execute the initialAction, enter
+ *        initialState (and its superstates, outermost first), then
+ *        follow initial transitions down to a leaf state.
+ */
+static inline void CmsHsm_Initialize(CmsHsmT* hsm, const CmsHsmTableT* table, const CmsSmActionFunc* actions,
+                                     void* context, uint8_t initialState, uint8_t initialAction)
+{
+    hsm->table = table;
+    hsm->actions = actions;
+    hsm->context = context;
+    for (size_t i = 0; i < CMS_HSM_MAX_STATES; ++i)
+    {
+        hsm->history[i] = CMS_HSM_NO_STATE;
+    }
+
+    CmsHsm_Execute(hsm, initialAction);
+
+    uint8_t path[CMS_HSM_MAX_DEPTH];
+    uint8_t count = 0;
+    for (uint8_t state = initialState; state != CMS_HSM_NO_STATE; state = table->states[state].parent)
+    {
+        path[count++] = state;
+    }
+
+    while (count > 0)
+    {
+        CmsHsm_Execute(hsm, table->states[path[--count]].entryAction);
+    }
+    CmsHsm_EnterDown(hsm, initialState);
+}
+
+/**
+ * @brief CmsHsm_Dispatch() - O(1) lookup of a user signal, plus at
+ *        most CMS_HSM_MAX_DEPTH exits and entries.
+ * @return false: the signal is outside of the table, nothing happened.
+ */
+static inline bool CmsHsm_Dispatch(CmsHsmT* hsm, uint32_t signal)
+{
+    uint32_t column = signal - CMS_SM_BEGIN_USER_SIGNALS;
+    if ((signal < CMS_SM_BEGIN_USER_SIGNALS) || (column >= hsm->table->signalCount))
+    {
+        return false;
+    }
+
+    const CmsHsmTableT* table = hsm->table;
+    const CmsHsmCellT* cell = &table->cells[((size_t)hsm->state * table->signalCount) + column];
+    if (cell->reaction == CMS_SM_INTERNAL)
+    {
+        CmsHsm_Execute(hsm, cell->action);
+    }
+    else if (cell->reaction == CMS_SM_TRANSITION)
+    {
+        uint8_t leaf = hsm->state;
+        uint8_t child = CMS_HSM_NO_STATE;
+        uint8_t state = leaf;
+        for (uint8_t i = 0; i < cell->exitCount; ++i)
+        {
+            const CmsHsmStateT* exiting = &table->states[state];
+            if (exiting->history == CMS_HSM_HISTORY_SHALLOW)
+            {
+                hsm->history[state] = child;
+            }
+            else if (exiting->history == CMS_HSM_HISTORY_DEEP)
+            {
+                hsm->history[state] = leaf;
+            }
+
+            CmsHsm_Execute(hsm, exiting->exitAction);
+            child = state;
+            state = exiting->parent;
+        }
+
+        CmsHsm_Execute(hsm, cell->action);
+
+        for (uint8_t i = 0; i < cell->entryCount; ++i)
+        {
+            CmsHsm_Execute(hsm, table->states[cell->entryPath[i]].entryAction);
+        }
+
+        uint8_t target = cell->entryPath[cell->entryCount - 1];
+        if (cell->historyOf != CMS_HSM_NO_STATE)
+        {
+            CmsHsm_EnterHistory(hsm, cell->historyOf);
+        }
+        else
+        {
+            CmsHsm_EnterDown(hsm, target);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief CmsHsm_State() - the active leaf state.
+ */
+static inline uint8_t CmsHsm_State(const CmsHsmT* hsm)
+{
+    return hsm->state;
+}
+
+/**
+ * @brief CmsHsm_IsIn() - true if state is the active leaf state,
+ *        or one of its superstates.
+ */
+static inline bool CmsHsm_IsIn(const CmsHsmT* hsm, uint8_t state)
+{
+    for (uint8_t active = hsm->state; active != CMS_HSM_NO_STATE; active = hsm->table->states[active].parent)
+    {
+        if (active == state)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CMSHIERARCHICALSTATEMACHINE_H
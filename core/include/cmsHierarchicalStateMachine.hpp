@@ -0,0 +1,409 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CMSHIERARCHICALSTATEMACHINE_HPP
+#define CMSHIERARCHICALSTATEMACHINE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "cmsStandardSignals.hpp"
+#include "cmsHierarchicalStateMachine.h"
+
+namespace cms
+{
+
+static_assert(CMS_SM_BEGIN_USER_SIGNALS == SM_BEGIN_USER_SIGNALS,
+              "the C adapter's first user signal must match cms::StandardSignals");
+
+/**
+ * @brief HsmTable - a constexpr builder for the hierarchical tables
+ *        executed by CmsHsm_Dispatch(). Describe the hierarchy and each
+ *        state's reactions, call Compile(), statically verify, then
+ *        publish the View(), for example:
+ *
+ *          constexpr auto Build()
+ *          {
+ *              cms::HsmTable<STATE_COUNT, SIGNAL_COUNT> table;
+ *              table.Substate(STATE_ON, STATE_POWERED)
+ *                   .Initial(STATE_POWERED, STATE_ON)
+ *                   .Transition(STATE_POWERED, SIG_POWER_FAIL, STATE_FAULT);
+ *              ...
+ *              return table.Compile();
+ *          }
+ *          static constexpr auto Table = Build();
+ *          static_assert(Table.IsComplete(), "unhandled signal");
+ *          extern "C" const CmsHsmTableT LampTable = Table.View();
+ *
+ *        A signal not described in a state is inherited from the
+ *        nearest superstate which describes it. Transitions are
+ *        external: a transition to the source state itself, or to
+ *        one of its superstates, exits and re-enters that state.
+ *        A transition to a substate of the source does not exit
+ *        the source.
+ */
+template<size_t StateCount, size_t SignalCount>
+class HsmTable
+{
+    static_assert((StateCount > 0) && (StateCount <= CMS_HSM_MAX_STATES), "StateCount must be 1 to CMS_HSM_MAX_STATES");
+    static_assert((SignalCount > 0) && (SignalCount <= UINT8_MAX), "SignalCount must be 1 to 255");
+
+public:
+    constexpr HsmTable() :
+        mStates{},
+        mSpecs{},
+        mCells{},
+        mConsistent(true),
+        mCompiled(false)
+    {
+        for (auto& state : mStates)
+        {
+            state = CmsHsmStateT{ CMS_HSM_NO_STATE, CMS_HSM_NO_STATE, CMS_HSM_HISTORY_NONE,
+                                  CMS_SM_NO_ACTION, CMS_SM_NO_ACTION };
+        }
+    }
+
+    constexpr HsmTable& Substate(size_t state, size_t superstate)
+    {
+        if (!Valid(state) || !Valid(superstate) || (state == superstate))
+        {
+            return Invalid();
+        }
+
+        mStates[state].parent = static_cast<uint8_t>(superstate);
+        return Modified();
+    }
+
+    constexpr HsmTable& Initial(size_t superstate, size_t substate)
+    {
+        if (!Valid(superstate) || !Valid(substate))
+        {
+            return Invalid();
+        }
+
+        mStates[superstate].initialChild = static_cast<uint8_t>(substate);
+        return Modified();
+    }
+
+    constexpr HsmTable& History(size_t superstate, CmsHsmHistoryT history)
+    {
+        if (!Valid(superstate))
+        {
+            return Invalid();
+        }
+
+        mStates[superstate].history = static_cast<uint8_t>(history);
+        return Modified();
+    }
+
+    constexpr HsmTable& OnEntry(size_t state, uint8_t action)
+    {
+        if (!Valid(state))
+        {
+            return Invalid();
+        }
+
+        mStates[state].entryAction = action;
+        return Modified();
+    }
+
+    constexpr HsmTable& OnExit(size_t state, uint8_t action)
+    {
+        if (!Valid(state))
+        {
+            return Invalid();
+        }
+
+        mStates[state].exitAction = action;
+        return Modified();
+    }
+
+    constexpr HsmTable& Transition(size_t state, uint32_t signal, size_t target,
+                                   uint8_t action = CMS_SM_NO_ACTION)
+    {
+        return Set(state, signal, Spec{ CMS_SM_TRANSITION, target, action, false });
+    }
+
+    /**
+     * @brief TransitionToHistory - enter superstate, then resume its
+     *        shallow or deep history.
+     */
+    constexpr HsmTable& TransitionToHistory(size_t state, uint32_t signal, size_t superstate,
+                                            uint8_t action = CMS_SM_NO_ACTION)
+    {
+        return Set(state, signal, Spec{ CMS_SM_TRANSITION, superstate, action, true });
+    }
+
+    constexpr HsmTable& Internal(size_t state, uint32_t signal, uint8_t action)
+    {
+        return Set(state, signal, Spec{ CMS_SM_INTERNAL, state, action, false });
+    }
+
+    constexpr HsmTable& Ignore(size_t state, uint32_t signal)
+    {
+        return Set(state, signal, Spec{ CMS_SM_IGNORED, state, CMS_SM_NO_ACTION, false });
+    }
+
+    /**
+     * @brief Compile - verify the hierarchy, then resolve inherited
+     *        reactions and each transition's exit count and entry path.
+     */
+    constexpr HsmTable& Compile()
+    {
+        mCompiled = VerifyHierarchy();
+        if (!mCompiled)
+        {
+            return *this;
+        }
+
+        for (size_t state = 0; state < StateCount; ++state)
+        {
+            for (size_t column = 0; column < SignalCount; ++column)
+            {
+                mCells[Index(state, column)] = Resolve(state, column);
+            }
+        }
+
+        return *this;
+    }
+
+    /**
+     * @brief IsComplete - true if compiled, consistent, and every
+     *        signal is handled in every leaf state, directly or by a
+     *        superstate.
+     */
+    constexpr bool IsComplete() const
+    {
+        if (!mCompiled || !mConsistent)
+        {
+            return false;
+        }
+
+        for (size_t state = 0; state < StateCount; ++state)
+        {
+            if (mStates[state].initialChild != CMS_HSM_NO_STATE)
+            {
+                continue; //never the active state
+            }
+
+            for (size_t column = 0; column < SignalCount; ++column)
+            {
+                if (mCells[Index(state, column)].reaction == CMS_SM_UNSPECIFIED)
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    constexpr CmsHsmTableT View() const
+    {
+        return CmsHsmTableT{ mStates, mCells, static_cast<uint8_t>(StateCount), static_cast<uint8_t>(SignalCount) };
+    }
+
+private:
+    struct Spec
+    {
+        CmsSmReactionT reaction;
+        size_t target;
+        uint8_t action;
+        bool toHistory;
+    };
+
+    static constexpr bool Valid(size_t state)
+    {
+        return state < StateCount;
+    }
+
+    static constexpr size_t Index(size_t state, size_t column)
+    {
+        return (state * SignalCount) + column;
+    }
+
+    constexpr HsmTable& Invalid()
+    {
+        mConsistent = false;
+        return *this;
+    }
+
+    constexpr HsmTable& Modified()
+    {
+        mCompiled = false;
+        return *this;
+    }
+
+    constexpr HsmTable& Set(size_t state, uint32_t signal, const Spec& spec)
+    {
+        if (!Valid(state) || !Valid(spec.target) || (signal < SM_BEGIN_USER_SIGNALS) ||
+            ((signal - SM_BEGIN_USER_SIGNALS) >= SignalCount))
+        {
+            return Invalid();
+        }
+
+        Spec& cell = mSpecs[Index(state, signal - SM_BEGIN_USER_SIGNALS)];
+        if (cell.reaction != CMS_SM_UNSPECIFIED)
+        {
+            mConsistent = false;
+        }
+
+        cell = spec;
+        return Modified();
+    }
+
+    /**
+     * @brief Depth - the number of states from the top level down
+     *        to state, inclusive. 0 for CMS_HSM_NO_STATE.
+     */
+    constexpr size_t Depth(size_t state) const
+    {
+        size_t depth = 0;
+        while ((state != CMS_HSM_NO_STATE) && (depth <= CMS_HSM_MAX_DEPTH))
+        {
+            ++depth;
+            state = mStates[state].parent;
+        }
+        return depth;
+    }
+
+    constexpr bool IsAncestorOrSelf(size_t ancestor, size_t state) const
+    {
+        while (state != CMS_HSM_NO_STATE)
+        {
+            if (state == ancestor)
+            {
+                return true;
+            }
+            state = mStates[state].parent;
+        }
+        return false;
+    }
+
+    constexpr bool VerifyHierarchy()
+    {
+        for (size_t state = 0; state < StateCount; ++state)
+        {
+            //also rejects a cycle, which never reaches the top level
+            if (Depth(state) > CMS_HSM_MAX_DEPTH)
+            {
+                mConsistent = false;
+            }
+        }
+
+        if (!mConsistent)
+        {
+            return false;
+        }
+
+        for (size_t state = 0; state < StateCount; ++state)
+        {
+            bool hasSubstates = false;
+            for (const auto& other : mStates)
+            {
+                hasSubstates = hasSubstates || (other.parent == state);
+            }
+
+            //a superstate needs an initial transition to one of its own substates,
+            //and only superstates have an initial transition or history.
+            const CmsHsmStateT& info = mStates[state];
+            bool initialOk = hasSubstates ?
+                               ((info.initialChild != CMS_HSM_NO_STATE) &&
+                                (mStates[info.initialChild].parent == state)) :
+                               ((info.initialChild == CMS_HSM_NO_STATE) && (info.history == CMS_HSM_HISTORY_NONE));
+            if (!initialOk)
+            {
+                mConsistent = false;
+            }
+        }
+
+        return mConsistent;
+    }
+
+    constexpr CmsHsmCellT Resolve(size_t leaf, size_t column)
+    {
+        CmsHsmCellT cell{ CMS_SM_UNSPECIFIED, CMS_SM_NO_ACTION, 0, 0, CMS_HSM_NO_STATE, {} };
+
+        size_t source = leaf;
+        while ((source != CMS_HSM_NO_STATE) && (mSpecs[Index(source, column)].reaction == CMS_SM_UNSPECIFIED))
+        {
+            source = mStates[source].parent;
+        }
+
+        if (source == CMS_HSM_NO_STATE)
+        {
+            return cell;
+        }
+
+        const Spec& spec = mSpecs[Index(source, column)];
+        cell.reaction = static_cast<uint8_t>(spec.reaction);
+        cell.action = spec.action;
+        if (spec.reaction != CMS_SM_TRANSITION)
+        {
+            return cell;
+        }
+
+        size_t target = spec.target;
+        if (spec.toHistory)
+        {
+            if (mStates[target].history == CMS_HSM_HISTORY_NONE)
+            {
+                mConsistent = false;
+            }
+            cell.historyOf = static_cast<uint8_t>(target);
+        }
+
+        //least common ancestor: the deepest state containing both source
+        //and target, other than the target itself (which is re-entered).
+        size_t lca = source;
+        while ((lca != CMS_HSM_NO_STATE) && !IsAncestorOrSelf(lca, target))
+        {
+            lca = mStates[lca].parent;
+        }
+        if (lca == target)
+        {
+            lca = mStates[target].parent;
+        }
+
+        cell.exitCount = static_cast<uint8_t>(Depth(leaf) - Depth(lca));
+        cell.entryCount = static_cast<uint8_t>(Depth(target) - Depth(lca));
+        size_t state = target;
+        for (size_t i = cell.entryCount; i > 0; --i)
+        {
+            cell.entryPath[i - 1] = static_cast<uint8_t>(state);
+            state = mStates[state].parent;
+        }
+
+        return cell;
+    }
+
+    CmsHsmStateT mStates[StateCount];
+    Spec mSpecs[StateCount * SignalCount];
+    CmsHsmCellT mCells[StateCount * SignalCount];
+    bool mConsistent;
+    bool mCompiled;
+};
+
+} //namespace cms
+
+#endif // CMSHIERARCHICALSTATEMACHINE_HPP
@@ -0,0 +1,226 @@
+/*
+MIT License
+
+Copyright (c) <2019-2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CMSSTDACTIVEOBJECT_HPP
+#define CMSSTDACTIVEOBJECT_HPP
+
+#include <array>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include "cmsBaseEvent.hpp"
+#include "cmsExecutionOption.h"
+#include "cmsTypeUtils.hpp"
+
+namespace cms
+{
+
+/**
+ * @brief StdActiveObject - a C++ active object base class, built from
+ *        standard portable C++ components. Events are stored by value in
+ *        a fixed ring sized at compile time, so no heap is used by the
+ *        queue, and events are never type erased.
+ *
+ *        Derived classes implement Initialize() (typically the initial
+ *        state machine transition) and ProcessEvent(), and publish their
+ *        own async API which calls Post() or PostUrgent().
+ *
+ * @note: derived classes must call Stop() in their destructor, as the
+ *        internal thread calls into the derived class.
+ */
+template<typename EventT, size_t QueueDepth>
+class StdActiveObject
+{
+    static_assert(is_base_of_any<BaseEvent, EventT>::value, "EventT must derive from cms::BaseEvent");
+    static_assert(QueueDepth > 0, "QueueDepth must be greater than zero");
+
+public:
+    using LockGuard = std::unique_lock<std::mutex>;
+
+    StdActiveObject() :
+        mEvents(),
+        mHead(0),
+        mCount(0),
+        mExitRequested(false),
+        mMutex(),
+        mCondVar(),
+        mThread()
+    {
+    }
+
+    virtual ~StdActiveObject()
+    {
+        assert(!mThread.joinable() && "derived class must call Stop()");
+    }
+
+    StdActiveObject(const StdActiveObject&) = delete;
+    StdActiveObject& operator=(const StdActiveObject&) = delete;
+
+    /**
+     * @brief Start() will start behavior.
+     * @param option EXECUTION_OPTION_NORMAL - create the internal thread.
+     *               EXECUTION_OPTION_UNIT_TEST - initialize only, events are
+     *               then processed via ProcessOneEvent().
+     */
+    void Start(ExecutionOptionT option)
+    {
+        assert(!mThread.joinable());
+        if (EXECUTION_OPTION_NORMAL == option)
+        {
+            mThread = std::thread([this]() { Task(); });
+        }
+        else
+        {
+            Initialize();
+        }
+    }
+
+    /**
+     * @brief Stop() will stop the internal thread, if any, after it
+     *        completes the event currently being processed.
+     */
+    void Stop()
+    {
+        {
+            LockGuard lock(mMutex);
+            mExitRequested = true;
+        }
+        mCondVar.notify_one();
+
+        if (mThread.joinable())
+        {
+            mThread.join();
+        }
+    }
+
+    size_t EventsWaiting() const
+    {
+        LockGuard lock(mMutex);
+        return mCount;
+    }
+
+    /**
+     * @brief ProcessOneEvent() - used by the internal thread, and
+     *        provided for unit testing access.
+     *
+     * @param option EXECUTION_OPTION_NORMAL - block until an event is available.
+     *               EXECUTION_OPTION_UNIT_TEST - never block.
+     *
+     * @return true: an event was processed.
+     *         false: queue was empty (unit test), or Stop() was requested.
+     */
+    bool ProcessOneEvent(ExecutionOptionT option)
+    {
+        EventT event;
+        {
+            LockGuard lock(mMutex);
+            if (EXECUTION_OPTION_NORMAL == option)
+            {
+                mCondVar.wait(lock, [this]() { return (mCount != 0) || mExitRequested; });
+            }
+
+            if (mExitRequested || (mCount == 0))
+            {
+                return false;
+            }
+
+            event = mEvents[mHead];
+            mHead = (mHead + 1 == QueueDepth) ? 0 : (mHead + 1);
+            --mCount;
+        }
+
+        ProcessEvent(event);
+        return true;
+    }
+
+protected:
+    /**
+     * @brief Post() - add an event to the back of the queue.
+     * @return false: the queue was full.
+     */
+    bool Post(const EventT& event)
+    {
+        LockGuard lock(mMutex);
+        if (mCount == QueueDepth)
+        {
+            return false;
+        }
+
+        size_t tail = mHead + mCount;
+        if (tail >= QueueDepth)
+        {
+            tail -= QueueDepth;
+        }
+
+        mEvents[tail] = event;
+        ++mCount;
+        lock.unlock();
+        mCondVar.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief PostUrgent() - add an event to the front of the queue.
+     * @return false: the queue was full.
+     */
+    bool PostUrgent(const EventT& event)
+    {
+        LockGuard lock(mMutex);
+        if (mCount == QueueDepth)
+        {
+            return false;
+        }
+
+        mHead = (mHead == 0) ? (QueueDepth - 1) : (mHead - 1);
+        mEvents[mHead] = event;
+        ++mCount;
+        lock.unlock();
+        mCondVar.notify_one();
+        return true;
+    }
+
+    virtual void Initialize() = 0;
+    virtual void ProcessEvent(const EventT& event) = 0;
+
+private:
+    void Task()
+    {
+        Initialize();
+        while (ProcessOneEvent(EXECUTION_OPTION_NORMAL)) {}
+    }
+
+    std::array<EventT, QueueDepth> mEvents;
+    size_t mHead;
+    size_t mCount;
+    bool mExitRequested;
+    mutable std::mutex mMutex;
+    std::condition_variable mCondVar;
+    std::thread mThread;
+};
+
+} //namespace cms
+
+#endif // CMSSTDACTIVEOBJECT_HPP
@@ -0,0 +1,131 @@
+//
+// Table driven state machine - the C callable adapter.
+//
+// A state machine is described by a flat table of cells, one per
+// state and user signal, plus per state entry and exit actions.
+// Dispatch is a single table lookup, there is no per state handler
+// function and no void* state return value to compare.
+//
+// Tables are normally generated at compile time by the C++17
+// cms::StateTable builder (see cmsTableStateMachine.hpp), which also
+// verifies that every signal is handled in every state.
+//
+
+#ifndef CMSTABLESTATEMACHINE_H
+#define CMSTABLESTATEMACHINE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief the first user signal, must match cms::SM_BEGIN_USER_SIGNALS.
+ *        Table columns start at this signal.
+ */
+#define CMS_SM_BEGIN_USER_SIGNALS 3
+
+/**
+ * @brief action index 0 is reserved for "no action".
+ */
+#define CMS_SM_NO_ACTION 0
+
+typedef enum CmsSmReaction
+{
+    CMS_SM_UNSPECIFIED, //not described, rejected by the table's static verification
+    CMS_SM_IGNORED,     //signal consumed, nothing happens
+    CMS_SM_INTERNAL,    //action executes, no state change, no exit or entry
+    CMS_SM_TRANSITION   //source exit action, then the action, then the target entry action
+} CmsSmReactionT;
+
+typedef struct CmsSmCell
+{
+    uint8_t reaction;
+    uint8_t target;
+    uint8_t action;
+} CmsSmCellT;
+
+typedef struct CmsSmTable
+{
+    const CmsSmCellT* cells;      //stateCount rows of signalCount cells
+    const uint8_t* entryActions;  //one per state
+    const uint8_t* exitActions;   //one per state
+    uint8_t stateCount;
+    uint8_t signalCount;          //user signals, starting at CMS_SM_BEGIN_USER_SIGNALS
+} CmsSmTableT;
+
+typedef void (*CmsSmActionFunc)(void* context);
+
+typedef struct CmsSm
+{
+    const CmsSmTableT* table;
+    const CmsSmActionFunc* actions; //indexed by action, entry 0 is unused
+    void* context;
+    uint8_t state;
+} CmsSmT;
+
+static inline void CmsSm_Execute(const CmsSmT* sm, uint8_t action)
+{
+    if (action != CMS_SM_NO_ACTION)
+    {
+        sm->actions[action](sm->context);
+    }
+}
+
+/**
+ * @brief CmsSm_Initialize() - execute the initial transition: the
+ *        initialAction, then the entry action of initialState.
+ */
+static inline void CmsSm_Initialize(CmsSmT* sm, const CmsSmTableT* table, const CmsSmActionFunc* actions,
+                                    void* context, uint8_t initialState, uint8_t initialAction)
+{
+    sm->table = table;
+    sm->actions = actions;
+    sm->context = context;
+    sm->state = initialState;
+    CmsSm_Execute(sm, initialAction);
+    CmsSm_Execute(sm, table->entryActions[initialState]);
+}
+
+/**
+ * @brief CmsSm_Dispatch() - O(1) dispatch of a user signal.
+ * @return false: the signal is outside of the table, nothing happened.
+ */
+static inline bool CmsSm_Dispatch(CmsSmT* sm, uint32_t signal)
+{
+    uint32_t column = signal - CMS_SM_BEGIN_USER_SIGNALS;
+    if ((signal < CMS_SM_BEGIN_USER_SIGNALS) || (column >= sm->table->signalCount))
+    {
+        return false;
+    }
+
+    const CmsSmTableT* table = sm->table;
+    const CmsSmCellT cell = table->cells[((size_t)sm->state * table->signalCount) + column];
+    if (cell.reaction == CMS_SM_TRANSITION)
+    {
+        CmsSm_Execute(sm, table->exitActions[sm->state]);
+        CmsSm_Execute(sm, cell.action);
+        sm->state = cell.target;
+        CmsSm_Execute(sm, table->entryActions[cell.target]);
+    }
+    else if (cell.reaction == CMS_SM_INTERNAL)
+    {
+        CmsSm_Execute(sm, cell.action);
+    }
+
+    return true;
+}
+
+static inline uint8_t CmsSm_State(const CmsSmT* sm)
+{
+    return sm->state;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CMSTABLESTATEMACHINE_H
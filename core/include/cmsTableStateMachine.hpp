@@ -0,0 +1,178 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef CMSTABLESTATEMACHINE_HPP
+#define CMSTABLESTATEMACHINE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "cmsStandardSignals.hpp"
+#include "cmsTableStateMachine.h"
+
+namespace cms
+{
+
+static_assert(CMS_SM_BEGIN_USER_SIGNALS == SM_BEGIN_USER_SIGNALS,
+              "the C adapter's first user signal must match cms::StandardSignals");
+
+/**
+ * @brief StateTable - a constexpr builder for the flat transition
+ *        tables executed by CmsSm_Dispatch(). Build the table in a
+ *        constexpr function, statically verify it, then publish its
+ *        View() to C or C++ code, for example:
+ *
+ *          constexpr auto Build()
+ *          {
+ *              cms::StateTable<STATE_COUNT, SIGNAL_COUNT> table;
+ *              table.OnEntry(STATE_ON, ACTION_LAMP_ON)
+ *                   .Transition(STATE_ON, SIG_TOGGLE, STATE_OFF)
+ *                   .Ignore(STATE_ON, SIG_TIMEOUT);
+ *              ...
+ *              return table;
+ *          }
+ *          static constexpr auto Table = Build();
+ *          static_assert(Table.IsComplete(), "unhandled signal");
+ *          extern "C" const CmsSmTableT LampTable = Table.View();
+ *
+ *        Signals are the absolute signal values, i.e. starting at
+ *        SM_BEGIN_USER_SIGNALS. Describing a cell outside of the table,
+ *        or describing a cell twice, also fails IsComplete().
+ */
+template<size_t StateCount, size_t SignalCount>
+class StateTable
+{
+    static_assert((StateCount > 0) && (StateCount <= UINT8_MAX), "StateCount must be 1 to 255");
+    static_assert((SignalCount > 0) && (SignalCount <= UINT8_MAX), "SignalCount must be 1 to 255");
+
+public:
+    constexpr StateTable() :
+        mCells{},
+        mEntryActions{},
+        mExitActions{},
+        mConsistent(true)
+    {
+    }
+
+    constexpr StateTable& Transition(size_t state, uint32_t signal, size_t target,
+                                     uint8_t action = CMS_SM_NO_ACTION)
+    {
+        if (target >= StateCount)
+        {
+            mConsistent = false;
+        }
+
+        return Set(state, signal, CMS_SM_TRANSITION, target, action);
+    }
+
+    constexpr StateTable& Internal(size_t state, uint32_t signal, uint8_t action)
+    {
+        return Set(state, signal, CMS_SM_INTERNAL, state, action);
+    }
+
+    constexpr StateTable& Ignore(size_t state, uint32_t signal)
+    {
+        return Set(state, signal, CMS_SM_IGNORED, state, CMS_SM_NO_ACTION);
+    }
+
+    constexpr StateTable& OnEntry(size_t state, uint8_t action)
+    {
+        SetAction(mEntryActions, state, action);
+        return *this;
+    }
+
+    constexpr StateTable& OnExit(size_t state, uint8_t action)
+    {
+        SetAction(mExitActions, state, action);
+        return *this;
+    }
+
+    /**
+     * @brief IsComplete - true if every signal is described exactly
+     *        once in every state, and every transition target exists.
+     */
+    constexpr bool IsComplete() const
+    {
+        if (!mConsistent)
+        {
+            return false;
+        }
+
+        for (const auto& cell : mCells)
+        {
+            if (cell.reaction == CMS_SM_UNSPECIFIED)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    constexpr CmsSmTableT View() const
+    {
+        return CmsSmTableT{ mCells, mEntryActions, mExitActions,
+                            static_cast<uint8_t>(StateCount), static_cast<uint8_t>(SignalCount) };
+    }
+
+private:
+    constexpr StateTable& Set(size_t state, uint32_t signal, CmsSmReactionT reaction, size_t target,
+                              uint8_t action)
+    {
+        if ((state >= StateCount) || (signal < SM_BEGIN_USER_SIGNALS) ||
+            ((signal - SM_BEGIN_USER_SIGNALS) >= SignalCount))
+        {
+            mConsistent = false;
+            return *this;
+        }
+
+        CmsSmCellT& cell = mCells[(state * SignalCount) + (signal - SM_BEGIN_USER_SIGNALS)];
+        if (cell.reaction != CMS_SM_UNSPECIFIED)
+        {
+            mConsistent = false;
+        }
+
+        cell = CmsSmCellT{ static_cast<uint8_t>(reaction), static_cast<uint8_t>(target), action };
+        return *this;
+    }
+
+    constexpr void SetAction(uint8_t (&actions)[StateCount], size_t state, uint8_t action)
+    {
+        if (state >= StateCount)
+        {
+            mConsistent = false;
+            return;
+        }
+
+        actions[state] = action;
+    }
+
+    CmsSmCellT mCells[StateCount * SignalCount];
+    uint8_t mEntryActions[StateCount];
+    uint8_t mExitActions[StateCount];
+    bool mConsistent;
+};
+
+} //namespace cms
+
+#endif // CMSTABLESTATEMACHINE_HPP
@@ -0,0 +1,217 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "cmsEventPool.hpp"
+#include "CppUTest/TestHarness.h"
+#include "fauxQueue.h"
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+struct SmallEvent : public cms::BaseEvent<uint32_t>
+{
+    SmallEvent(uint32_t sig, uint32_t v) : cms::BaseEvent<uint32_t>(sig), value(v) {}
+    uint32_t value;
+};
+
+struct LargeEvent : public cms::BaseEvent<uint32_t>
+{
+    explicit LargeEvent(uint32_t sig) : cms::BaseEvent<uint32_t>(sig), payload{} {}
+    uint8_t payload[200];
+};
+
+} //namespace
+
+TEST_GROUP(EventPoolTests)
+{
+    void setup() final
+    {
+    }
+
+    void teardown() final
+    {
+    }
+};
+
+TEST(EventPoolTests, new_event_is_constructed_in_the_smallest_class_which_fits)
+{
+    cms::EventPool pool({{32, 2}, {256, 1}});
+
+    auto small = pool.New<SmallEvent>(1u, 42u);
+    CHECK_TRUE(small != nullptr);
+    CHECK_EQUAL(1u, small->signal);
+    CHECK_EQUAL(42u, small->value);
+    CHECK_EQUAL(1u, cms::EventPool::RefCount(small));
+    CHECK_EQUAL(1u, pool.Stats(0).inUse);
+    CHECK_EQUAL(0u, pool.Stats(1).inUse);
+
+    auto large = pool.New<LargeEvent>(2u);
+    CHECK_TRUE(large != nullptr);
+    CHECK_EQUAL(1u, pool.Stats(1).inUse);
+
+    pool.Release(small);
+    pool.Release(large);
+    CHECK_EQUAL(0u, pool.Stats(0).inUse);
+    CHECK_EQUAL(0u, pool.Stats(1).inUse);
+}
+
+TEST(EventPoolTests, multicast_block_is_recycled_only_by_the_last_release)
+{
+    cms::EventPool pool({{256, 1}});
+
+    auto event = pool.New<LargeEvent>(1u);
+    CHECK_TRUE(event != nullptr);
+    event->payload[0] = 0xA5;
+
+    //three receivers share the same payload
+    pool.AddRef(event, 2);
+    CHECK_EQUAL(3u, cms::EventPool::RefCount(event));
+
+    pool.Release(event);
+    pool.Release(event);
+    CHECK_EQUAL(1u, pool.Stats(0).inUse);
+    CHECK_TRUE(pool.New<LargeEvent>(2u) == nullptr);
+    CHECK_EQUAL(0xA5, event->payload[0]);
+
+    pool.Release(event);
+    CHECK_EQUAL(0u, pool.Stats(0).inUse);
+
+    auto recycled = pool.New<LargeEvent>(3u);
+    POINTERS_EQUAL(event, recycled);
+    pool.Release(recycled);
+}
+
+TEST(EventPoolTests, event_posted_to_two_queues_is_recycled_after_both_receivers_release)
+{
+    cms::EventPool pool({{256, 1}});
+    QueueHandle_t first = xQueueCreate(1, sizeof(LargeEvent*));
+    QueueHandle_t second = xQueueCreate(1, sizeof(LargeEvent*));
+
+    //only the pointer is posted, one reference per receiver
+    auto event = pool.New<LargeEvent>(1u);
+    CHECK_TRUE(event != nullptr);
+    event->payload[0] = 0x5A;
+    pool.AddRef(event);
+    CHECK_TRUE(xQueueSendToBack(first, &event));
+    CHECK_TRUE(xQueueSendToBack(second, &event));
+
+    LargeEvent* received = nullptr;
+    CHECK_TRUE(xQueueReceiveTimed(first, &received, 0));
+    POINTERS_EQUAL(event, received);
+    CHECK_EQUAL(0x5A, received->payload[0]);
+    pool.Release(received);
+    CHECK_EQUAL(1u, pool.Stats(0).inUse);
+    CHECK_TRUE(pool.New<LargeEvent>(2u) == nullptr);
+
+    received = nullptr;
+    CHECK_TRUE(xQueueReceiveTimed(second, &received, 0));
+    POINTERS_EQUAL(event, received);
+    CHECK_EQUAL(0x5A, received->payload[0]);
+    pool.Release(received);
+    CHECK_EQUAL(0u, pool.Stats(0).inUse);
+
+    auto recycled = pool.New<LargeEvent>(3u);
+    POINTERS_EQUAL(event, recycled);
+    pool.Release(recycled);
+
+    vQueueDelete(first);
+    vQueueDelete(second);
+}
+
+TEST(EventPoolTests, exhausted_class_falls_back_to_larger_class_and_is_counted)
+{
+    cms::EventPool pool({{32, 1}, {256, 1}});
+
+    auto first = pool.New<SmallEvent>(1u, 1u);
+    auto second = pool.New<SmallEvent>(1u, 2u);
+    auto third = pool.New<SmallEvent>(1u, 3u);
+    CHECK_TRUE(first != nullptr);
+    CHECK_TRUE(second != nullptr);
+    CHECK_TRUE(third == nullptr);
+
+    auto smallStats = pool.Stats(0);
+    CHECK_EQUAL(32u, smallStats.blockSize);
+    CHECK_EQUAL(1u, smallStats.allocations);
+    CHECK_EQUAL(2u, smallStats.exhaustions);
+    CHECK_EQUAL(1u, smallStats.highWaterMark);
+
+    auto largeStats = pool.Stats(1);
+    CHECK_EQUAL(1u, largeStats.allocations);
+    CHECK_EQUAL(1u, largeStats.exhaustions);
+    CHECK_EQUAL(1u, pool.Failures());
+
+    pool.Release(first);
+    pool.Release(second);
+    CHECK_EQUAL(1u, pool.Stats(0).highWaterMark);
+    CHECK_EQUAL(0u, pool.Stats(0).inUse);
+}
+
+TEST(EventPoolTests, concurrent_allocate_and_release_never_loses_a_block)
+{
+    constexpr size_t BlockCount = 16;
+    constexpr int Iterations = 20000;
+    cms::EventPool pool({{32, BlockCount}});
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&pool, t]()
+        {
+            for (int i = 0; i < Iterations; ++i)
+            {
+                auto event = pool.New<SmallEvent>(t, static_cast<uint32_t>(i));
+                if (event == nullptr)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                //a second receiver, as if multicast
+                pool.AddRef(event);
+                CHECK_EQUAL(static_cast<uint32_t>(i), event->value);
+                pool.Release(event);
+                pool.Release(event);
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    CHECK_EQUAL(0u, pool.Stats(0).inUse);
+    std::vector<SmallEvent*> all;
+    for (size_t i = 0; i < BlockCount; ++i)
+    {
+        all.push_back(pool.New<SmallEvent>(1u, 0u));
+        CHECK_TRUE(all.back() != nullptr);
+    }
+    CHECK_TRUE(pool.New<SmallEvent>(1u, 0u) == nullptr);
+    for (auto event : all)
+    {
+        pool.Release(event);
+    }
+}
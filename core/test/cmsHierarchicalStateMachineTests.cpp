@@ -0,0 +1,269 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "cmsHierarchicalStateMachine.hpp"
+#include "CppUTest/TestHarness.h"
+#include <vector>
+
+namespace
+{
+
+enum TestSignal : uint32_t
+{
+    SIG_NEXT = cms::SM_BEGIN_USER_SIGNALS,
+    SIG_TO_T,
+    SIG_BACK,
+    SIG_SELF,
+    SIG_INTERNAL,
+    SIG_END
+};
+
+constexpr size_t TestSignalCount = SIG_END - cms::SM_BEGIN_USER_SIGNALS;
+
+// S (initial S1)
+//   S1 (initial S11)
+//     S11
+//     S12
+//   S2
+// T
+enum TestState : uint8_t
+{
+    STATE_S,
+    STATE_S1,
+    STATE_S11,
+    STATE_S12,
+    STATE_S2,
+    STATE_T,
+    STATE_COUNT
+};
+
+enum TestAction : uint8_t
+{
+    ACTION_NONE = CMS_SM_NO_ACTION,
+    ENTER_S,
+    EXIT_S,
+    ENTER_S1,
+    EXIT_S1,
+    ENTER_S11,
+    EXIT_S11,
+    ENTER_S12,
+    EXIT_S12,
+    ENTER_T,
+    EXIT_T,
+    ACTION_TO_T,
+    ACTION_INTERNAL,
+    ACTION_COUNT
+};
+
+using TestTable = cms::HsmTable<STATE_COUNT, TestSignalCount>;
+
+constexpr TestTable DescribeTestTable(CmsHsmHistoryT history)
+{
+    TestTable table;
+    table.Substate(STATE_S1, STATE_S)
+         .Substate(STATE_S2, STATE_S)
+         .Substate(STATE_S11, STATE_S1)
+         .Substate(STATE_S12, STATE_S1)
+         .Initial(STATE_S, STATE_S1)
+         .Initial(STATE_S1, STATE_S11)
+         .History(STATE_S, history);
+
+    table.OnEntry(STATE_S, ENTER_S)
+         .OnExit(STATE_S, EXIT_S)
+         .Transition(STATE_S, SIG_TO_T, STATE_T, ACTION_TO_T)
+         .Internal(STATE_S, SIG_INTERNAL, ACTION_INTERNAL)
+         .Ignore(STATE_S, SIG_NEXT)
+         .Ignore(STATE_S, SIG_BACK)
+         .Ignore(STATE_S, SIG_SELF);
+
+    table.OnEntry(STATE_S1, ENTER_S1)
+         .OnExit(STATE_S1, EXIT_S1)
+         .Transition(STATE_S1, SIG_SELF, STATE_S1);
+
+    table.OnEntry(STATE_S11, ENTER_S11)
+         .OnExit(STATE_S11, EXIT_S11)
+         .Transition(STATE_S11, SIG_NEXT, STATE_S12);
+
+    table.OnEntry(STATE_S12, ENTER_S12)
+         .OnExit(STATE_S12, EXIT_S12);
+
+    table.OnEntry(STATE_T, ENTER_T)
+         .OnExit(STATE_T, EXIT_T)
+         .TransitionToHistory(STATE_T, SIG_BACK, STATE_S)
+         .Ignore(STATE_T, SIG_NEXT)
+         .Ignore(STATE_T, SIG_TO_T)
+         .Ignore(STATE_T, SIG_SELF)
+         .Ignore(STATE_T, SIG_INTERNAL);
+    return table;
+}
+
+constexpr TestTable BuildTestTable(CmsHsmHistoryT history)
+{
+    TestTable table = DescribeTestTable(history);
+    return table.Compile();
+}
+
+constexpr TestTable DeepTable = BuildTestTable(CMS_HSM_HISTORY_DEEP);
+constexpr TestTable ShallowTable = BuildTestTable(CMS_HSM_HISTORY_SHALLOW);
+static_assert(DeepTable.IsComplete(), "test table must be complete");
+static_assert(ShallowTable.IsComplete(), "test table must be complete");
+
+constexpr bool NotCompiledIsIncomplete()
+{
+    return !DescribeTestTable(CMS_HSM_HISTORY_DEEP).IsComplete();
+}
+static_assert(NotCompiledIsIncomplete(), "an uncompiled table must be detected");
+
+constexpr bool UnhandledLeafSignalIsIncomplete()
+{
+    TestTable table;
+    table.Ignore(STATE_T, SIG_NEXT);
+    return !table.Compile().IsComplete();
+}
+static_assert(UnhandledLeafSignalIsIncomplete(), "an unhandled signal must be detected");
+
+constexpr bool BadHierarchyIsIncomplete()
+{
+    TestTable noInitial = DescribeTestTable(CMS_HSM_HISTORY_DEEP);
+    noInitial.Initial(STATE_S1, STATE_S2);
+    TestTable cycle = DescribeTestTable(CMS_HSM_HISTORY_DEEP);
+    cycle.Substate(STATE_S, STATE_S11);
+    TestTable noHistory = DescribeTestTable(CMS_HSM_HISTORY_NONE);
+    return !noInitial.Compile().IsComplete() && !cycle.Compile().IsComplete() &&
+           !noHistory.Compile().IsComplete();
+}
+static_assert(BadHierarchyIsIncomplete(), "a bad hierarchy must be detected");
+
+const CmsHsmTableT DeepTableView = DeepTable.View();
+const CmsHsmTableT ShallowTableView = ShallowTable.View();
+
+std::vector<uint8_t> s_actions;
+
+template<uint8_t Action>
+void Record(void* context)
+{
+    (void)context;
+    s_actions.push_back(Action);
+}
+
+const CmsSmActionFunc TestActions[ACTION_COUNT] = {
+  nullptr,
+  Record<ENTER_S>, Record<EXIT_S>,
+  Record<ENTER_S1>, Record<EXIT_S1>,
+  Record<ENTER_S11>, Record<EXIT_S11>,
+  Record<ENTER_S12>, Record<EXIT_S12>,
+  Record<ENTER_T>, Record<EXIT_T>,
+  Record<ACTION_TO_T>,
+  Record<ACTION_INTERNAL>
+};
+
+} // namespace
+
+TEST_GROUP(HierarchicalStateMachineTests)
+{
+    CmsHsmT mUnderTest = {};
+
+    void setup() final
+    {
+        Start(&DeepTableView);
+    }
+
+    void Start(const CmsHsmTableT* table)
+    {
+        s_actions.clear();
+        CmsHsm_Initialize(&mUnderTest, table, TestActions, nullptr, STATE_S, ACTION_NONE);
+    }
+
+    void Dispatch(uint32_t signal)
+    {
+        CHECK_TRUE(CmsHsm_Dispatch(&mUnderTest, signal));
+    }
+
+    void CheckActions(const std::vector<uint8_t>& expected)
+    {
+        UNSIGNED_LONGS_EQUAL(expected.size(), s_actions.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+        {
+            UNSIGNED_LONGS_EQUAL(expected[i], s_actions[i]);
+        }
+        s_actions.clear();
+    }
+};
+
+TEST(HierarchicalStateMachineTests, given_initialize_then_superstates_are_entered_outermost_first_down_to_a_leaf)
+{
+    CheckActions({ ENTER_S, ENTER_S1, ENTER_S11 });
+    UNSIGNED_LONGS_EQUAL(STATE_S11, CmsHsm_State(&mUnderTest));
+    CHECK_TRUE(CmsHsm_IsIn(&mUnderTest, STATE_S));
+    CHECK_TRUE(CmsHsm_IsIn(&mUnderTest, STATE_S1));
+    CHECK_FALSE(CmsHsm_IsIn(&mUnderTest, STATE_S12));
+}
+
+TEST(HierarchicalStateMachineTests, given_signal_handled_by_superstate_then_exit_chain_runs_innermost_first)
+{
+    s_actions.clear();
+    Dispatch(SIG_TO_T);
+    CheckActions({ EXIT_S11, EXIT_S1, EXIT_S, ACTION_TO_T, ENTER_T });
+    UNSIGNED_LONGS_EQUAL(STATE_T, CmsHsm_State(&mUnderTest));
+
+    Dispatch(SIG_INTERNAL);
+    CheckActions({});
+}
+
+TEST(HierarchicalStateMachineTests, given_inherited_internal_signal_then_no_exit_or_entry)
+{
+    s_actions.clear();
+    Dispatch(SIG_INTERNAL);
+    CheckActions({ ACTION_INTERNAL });
+    UNSIGNED_LONGS_EQUAL(STATE_S11, CmsHsm_State(&mUnderTest));
+}
+
+TEST(HierarchicalStateMachineTests, given_self_transition_of_superstate_then_it_is_exited_and_reentered)
+{
+    Dispatch(SIG_NEXT);
+    s_actions.clear();
+    Dispatch(SIG_SELF);
+    CheckActions({ EXIT_S12, EXIT_S1, ENTER_S1, ENTER_S11 });
+    UNSIGNED_LONGS_EQUAL(STATE_S11, CmsHsm_State(&mUnderTest));
+}
+
+TEST(HierarchicalStateMachineTests, given_deep_history_then_the_last_active_leaf_is_resumed)
+{
+    Dispatch(SIG_NEXT);
+    Dispatch(SIG_TO_T);
+    s_actions.clear();
+    Dispatch(SIG_BACK);
+    CheckActions({ EXIT_T, ENTER_S, ENTER_S1, ENTER_S12 });
+    UNSIGNED_LONGS_EQUAL(STATE_S12, CmsHsm_State(&mUnderTest));
+}
+
+TEST(HierarchicalStateMachineTests, given_shallow_history_then_the_last_active_substate_is_resumed_via_its_initial)
+{
+    Start(&ShallowTableView);
+    Dispatch(SIG_NEXT);
+    Dispatch(SIG_TO_T);
+    s_actions.clear();
+    Dispatch(SIG_BACK);
+    CheckActions({ EXIT_T, ENTER_S, ENTER_S1, ENTER_S11 });
+    UNSIGNED_LONGS_EQUAL(STATE_S11, CmsHsm_State(&mUnderTest));
+}
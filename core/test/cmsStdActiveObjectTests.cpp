@@ -0,0 +1,139 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "cmsStdActiveObject.hpp"
+#include "CppUTest/TestHarness.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+
+struct TestEvent : public cms::BaseEvent<uint16_t>
+{
+    TestEvent() = default;
+    explicit TestEvent(uint16_t sig) : BaseEvent(sig) {}
+};
+
+static constexpr size_t TestQueueDepth = 3;
+
+class TestActiveObject : public cms::StdActiveObject<TestEvent, TestQueueDepth>
+{
+public:
+    ~TestActiveObject() override
+    {
+        Stop();
+    }
+
+    bool Send(uint16_t sig) { return Post(TestEvent(sig)); }
+    bool SendUrgent(uint16_t sig) { return PostUrgent(TestEvent(sig)); }
+
+    bool mInitialized = false;
+    std::vector<uint16_t> mProcessed;
+    std::atomic<size_t> mProcessedCount{0};
+
+protected:
+    void Initialize() override
+    {
+        mInitialized = true;
+    }
+
+    void ProcessEvent(const TestEvent& event) override
+    {
+        mProcessed.push_back(event.signal);
+        mProcessedCount++;
+    }
+};
+
+} // namespace
+
+TEST_GROUP(StdActiveObjectTests)
+{
+    TestActiveObject mUnderTest;
+
+    void GiveProcessingTime()
+    {
+        while (mUnderTest.ProcessOneEvent(EXECUTION_OPTION_UNIT_TEST)) {}
+    }
+};
+
+TEST(StdActiveObjectTests, given_unit_test_start_then_initialized_without_thread)
+{
+    mUnderTest.Start(EXECUTION_OPTION_UNIT_TEST);
+    CHECK_TRUE(mUnderTest.mInitialized);
+    CHECK_FALSE(mUnderTest.ProcessOneEvent(EXECUTION_OPTION_UNIT_TEST));
+}
+
+TEST(StdActiveObjectTests, given_posted_events_then_processed_in_order_with_urgent_first)
+{
+    mUnderTest.Start(EXECUTION_OPTION_UNIT_TEST);
+    CHECK_TRUE(mUnderTest.Send(1));
+    CHECK_TRUE(mUnderTest.Send(2));
+    CHECK_TRUE(mUnderTest.SendUrgent(3));
+    UNSIGNED_LONGS_EQUAL(3, mUnderTest.EventsWaiting());
+    GiveProcessingTime();
+
+    UNSIGNED_LONGS_EQUAL(3, mUnderTest.mProcessed.size());
+    UNSIGNED_LONGS_EQUAL(3, mUnderTest.mProcessed[0]);
+    UNSIGNED_LONGS_EQUAL(1, mUnderTest.mProcessed[1]);
+    UNSIGNED_LONGS_EQUAL(2, mUnderTest.mProcessed[2]);
+}
+
+TEST(StdActiveObjectTests, given_full_queue_when_post_then_post_fails)
+{
+    mUnderTest.Start(EXECUTION_OPTION_UNIT_TEST);
+    for (uint16_t sig = 1; sig <= TestQueueDepth; ++sig)
+    {
+        CHECK_TRUE(mUnderTest.Send(sig));
+    }
+
+    CHECK_FALSE(mUnderTest.Send(99));
+    CHECK_FALSE(mUnderTest.SendUrgent(99));
+    GiveProcessingTime();
+    UNSIGNED_LONGS_EQUAL(TestQueueDepth, mUnderTest.mProcessed.size());
+}
+
+TEST(StdActiveObjectTests, given_real_thread_then_posted_events_are_processed_and_stop_joins)
+{
+    mUnderTest.Start(EXECUTION_OPTION_NORMAL);
+    for (uint16_t sig = 1; sig <= 100; ++sig)
+    {
+        while (!mUnderTest.Send(sig))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((mUnderTest.mProcessedCount < 100) && (std::chrono::steady_clock::now() < deadline))
+    {
+        std::this_thread::yield();
+    }
+    mUnderTest.Stop();
+
+    UNSIGNED_LONGS_EQUAL(100, mUnderTest.mProcessed.size());
+    CHECK_TRUE(mUnderTest.mInitialized);
+    UNSIGNED_LONGS_EQUAL(100, mUnderTest.mProcessed.back());
+}
@@ -0,0 +1,179 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "cmsTableStateMachine.hpp"
+#include "CppUTest/TestHarness.h"
+#include <vector>
+
+namespace
+{
+
+enum TestSignal : uint32_t
+{
+    SIG_A = cms::SM_BEGIN_USER_SIGNALS,
+    SIG_B,
+    SIG_OUT_OF_TABLE
+};
+
+constexpr size_t TestSignalCount = SIG_OUT_OF_TABLE - cms::SM_BEGIN_USER_SIGNALS;
+
+enum TestState : uint8_t
+{
+    STATE_ONE,
+    STATE_TWO,
+    STATE_COUNT
+};
+
+enum TestAction : uint8_t
+{
+    ACTION_NONE = CMS_SM_NO_ACTION,
+    ACTION_INITIAL,
+    ACTION_ENTER_ONE,
+    ACTION_EXIT_ONE,
+    ACTION_ENTER_TWO,
+    ACTION_TRANSITION,
+    ACTION_INTERNAL,
+    ACTION_COUNT
+};
+
+using TestTable = cms::StateTable<STATE_COUNT, TestSignalCount>;
+
+constexpr TestTable BuildTestTable()
+{
+    TestTable table;
+    table.OnEntry(STATE_ONE, ACTION_ENTER_ONE)
+         .OnExit(STATE_ONE, ACTION_EXIT_ONE)
+         .Transition(STATE_ONE, SIG_A, STATE_TWO, ACTION_TRANSITION)
+         .Internal(STATE_ONE, SIG_B, ACTION_INTERNAL);
+
+    table.OnEntry(STATE_TWO, ACTION_ENTER_TWO)
+         .Transition(STATE_TWO, SIG_A, STATE_ONE)
+         .Ignore(STATE_TWO, SIG_B);
+    return table;
+}
+
+constexpr TestTable CompleteTable = BuildTestTable();
+static_assert(CompleteTable.IsComplete(), "test table must be complete");
+
+constexpr bool MissingCellIsIncomplete()
+{
+    TestTable table;
+    table.Ignore(STATE_ONE, SIG_A).Ignore(STATE_ONE, SIG_B).Ignore(STATE_TWO, SIG_A);
+    return !table.IsComplete();
+}
+static_assert(MissingCellIsIncomplete(), "a missing cell must be detected");
+
+constexpr bool DuplicateCellIsIncomplete()
+{
+    TestTable table = BuildTestTable();
+    table.Ignore(STATE_TWO, SIG_B);
+    return !table.IsComplete();
+}
+static_assert(DuplicateCellIsIncomplete(), "a cell described twice must be detected");
+
+constexpr bool OutOfTableIsIncomplete()
+{
+    TestTable badSignal = BuildTestTable();
+    badSignal.Ignore(STATE_ONE, SIG_OUT_OF_TABLE);
+    TestTable badTarget = BuildTestTable();
+    badTarget.OnEntry(STATE_COUNT, ACTION_ENTER_ONE);
+    return !badSignal.IsComplete() && !badTarget.IsComplete();
+}
+static_assert(OutOfTableIsIncomplete(), "cells outside of the table must be detected");
+
+const CmsSmTableT TestTableView = CompleteTable.View();
+
+std::vector<uint8_t> s_actions;
+
+template<uint8_t Action>
+void Record(void* context)
+{
+    (void)context;
+    s_actions.push_back(Action);
+}
+
+const CmsSmActionFunc TestActions[ACTION_COUNT] = {
+  nullptr,
+  Record<ACTION_INITIAL>,
+  Record<ACTION_ENTER_ONE>,
+  Record<ACTION_EXIT_ONE>,
+  Record<ACTION_ENTER_TWO>,
+  Record<ACTION_TRANSITION>,
+  Record<ACTION_INTERNAL>
+};
+
+} // namespace
+
+TEST_GROUP(TableStateMachineTests)
+{
+    CmsSmT mUnderTest = {};
+
+    void setup() final
+    {
+        s_actions.clear();
+        CmsSm_Initialize(&mUnderTest, &TestTableView, TestActions, nullptr, STATE_ONE, ACTION_INITIAL);
+    }
+};
+
+TEST(TableStateMachineTests, given_initialize_then_initial_action_then_entry_action_execute)
+{
+    UNSIGNED_LONGS_EQUAL(STATE_ONE, CmsSm_State(&mUnderTest));
+    UNSIGNED_LONGS_EQUAL(2, s_actions.size());
+    UNSIGNED_LONGS_EQUAL(ACTION_INITIAL, s_actions[0]);
+    UNSIGNED_LONGS_EQUAL(ACTION_ENTER_ONE, s_actions[1]);
+}
+
+TEST(TableStateMachineTests, given_transition_then_exit_then_action_then_entry_execute)
+{
+    s_actions.clear();
+    CHECK_TRUE(CmsSm_Dispatch(&mUnderTest, SIG_A));
+    UNSIGNED_LONGS_EQUAL(STATE_TWO, CmsSm_State(&mUnderTest));
+    UNSIGNED_LONGS_EQUAL(3, s_actions.size());
+    UNSIGNED_LONGS_EQUAL(ACTION_EXIT_ONE, s_actions[0]);
+    UNSIGNED_LONGS_EQUAL(ACTION_TRANSITION, s_actions[1]);
+    UNSIGNED_LONGS_EQUAL(ACTION_ENTER_TWO, s_actions[2]);
+}
+
+TEST(TableStateMachineTests, given_internal_or_ignored_signal_then_state_is_unchanged_and_no_entry_or_exit)
+{
+    s_actions.clear();
+    CHECK_TRUE(CmsSm_Dispatch(&mUnderTest, SIG_B));
+    UNSIGNED_LONGS_EQUAL(STATE_ONE, CmsSm_State(&mUnderTest));
+    UNSIGNED_LONGS_EQUAL(1, s_actions.size());
+    UNSIGNED_LONGS_EQUAL(ACTION_INTERNAL, s_actions[0]);
+
+    CHECK_TRUE(CmsSm_Dispatch(&mUnderTest, SIG_A));
+    s_actions.clear();
+    CHECK_TRUE(CmsSm_Dispatch(&mUnderTest, SIG_B));
+    UNSIGNED_LONGS_EQUAL(STATE_TWO, CmsSm_State(&mUnderTest));
+    CHECK_TRUE(s_actions.empty());
+}
+
+TEST(TableStateMachineTests, given_signal_outside_of_table_then_dispatch_returns_false)
+{
+    s_actions.clear();
+    CHECK_FALSE(CmsSm_Dispatch(&mUnderTest, SIG_OUT_OF_TABLE));
+    CHECK_FALSE(CmsSm_Dispatch(&mUnderTest, cms::SM_ENTER));
+    UNSIGNED_LONGS_EQUAL(STATE_ONE, CmsSm_State(&mUnderTest));
+    CHECK_TRUE(s_actions.empty());
+}
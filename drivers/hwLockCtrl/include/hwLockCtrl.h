@@ -27,12 +27,15 @@ SOFTWARE.
  *        This driver controls a physical electronic
  *        controlled hardware lock.
  *
- *        The driver API is fully synchronous.
+ *        Each operation is available synchronously, and asynchronously
+ *        with a completion callback, so the caller need not block while
+ *        a slow motor or self test is in progress.
  */
 #ifndef ACTIVEOBJECTUNITTESTINGDEMO_HWLOCKCTRL_H
 #define ACTIVEOBJECTUNITTESTINGDEMO_HWLOCKCTRL_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -49,6 +52,13 @@ typedef enum HwLockCtrlSelfTestResult
     HW_LOCK_CTRL_SELF_TEST_FAILED_MOTOR,
 } HwLockCtrlSelfTestResultT;
 
+/**
+ * @brief HwLockIdT identifies one lock of a bank of locks.
+ *        The functions without a lock ID control the default lock.
+ */
+typedef uint32_t HwLockIdT;
+#define HW_LOCK_CTRL_DEFAULT_LOCK_ID 0
+
 /**
  * @brief HwLockCtrlInit initializes the driver. Lock state is undefined.
  * @return true - initialization completed successfully.
@@ -78,6 +88,50 @@ bool HwLockCtrlUnlock();
  */
 bool HwLockCtrlSelfTest(HwLockCtrlSelfTestResultT* outResult);
 
+/**
+ * @brief as above, for the lock identified by lockId.
+ */
+bool HwLockCtrlInitById(HwLockIdT lockId);
+bool HwLockCtrlLockById(HwLockIdT lockId);
+bool HwLockCtrlUnlockById(HwLockIdT lockId);
+bool HwLockCtrlSelfTestById(HwLockIdT lockId, HwLockCtrlSelfTestResultT* outResult);
+
+typedef enum HwLockCtrlOperation
+{
+    HW_LOCK_CTRL_OPERATION_LOCK,
+    HW_LOCK_CTRL_OPERATION_UNLOCK,
+    HW_LOCK_CTRL_OPERATION_SELF_TEST
+} HwLockCtrlOperationT;
+
+/**
+ * @brief HwLockCtrlCompletion - the outcome of an asynchronous operation.
+ */
+typedef struct HwLockCtrlCompletion
+{
+    HwLockIdT lockId;
+    HwLockCtrlOperationT operation;
+    bool ok;                                  //as the synchronous function's return value
+    HwLockCtrlSelfTestResultT selfTestResult; //self test only, valid when ok
+} HwLockCtrlCompletionT;
+
+/**
+ * @brief HwLockCtrlCompletionCallback - called from the driver's context,
+ *        as an interrupt handler would be. It should do no more than post
+ *        the completion into the requester's queue.
+ */
+typedef void (*HwLockCtrlCompletionCallback)(void* context, const HwLockCtrlCompletionT* completion);
+
+/**
+ * @brief asynchronous versions of the above. Each starts the operation and
+ *        returns, the callback reports its completion, possibly before the
+ *        function returns. Only one operation per lock may be in progress.
+ * @return true - the operation started, the callback will be called once.
+ *         false - the operation did not start, the callback is not called.
+ */
+bool HwLockCtrlLockAsync(HwLockIdT lockId, HwLockCtrlCompletionCallback callback, void* context);
+bool HwLockCtrlUnlockAsync(HwLockIdT lockId, HwLockCtrlCompletionCallback callback, void* context);
+bool HwLockCtrlSelfTestAsync(HwLockIdT lockId, HwLockCtrlCompletionCallback callback, void* context);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,29 +5,49 @@
  *   this fake hardware driver module.
  */
 #include "hwLockCtrl.h"
-#include <stdio.h>
+#include "fauxLog.h"
 
 bool HwLockCtrlInit()
 {
-    printf("%s() executed\n", __FUNCTION__);
-    return true;
+    return HwLockCtrlInitById(HW_LOCK_CTRL_DEFAULT_LOCK_ID);
 }
 
 bool HwLockCtrlLock()
 {
-    printf("%s() executed\n", __FUNCTION__);
-    return true;
+    return HwLockCtrlLockById(HW_LOCK_CTRL_DEFAULT_LOCK_ID);
 }
 
 bool HwLockCtrlUnlock()
 {
-    printf("%s() executed\n", __FUNCTION__);
-    return true;
+    return HwLockCtrlUnlockById(HW_LOCK_CTRL_DEFAULT_LOCK_ID);
 }
 
 bool HwLockCtrlSelfTest(HwLockCtrlSelfTestResultT* outResult)
 {
-    printf("%s() executed\n", __FUNCTION__);
+    return HwLockCtrlSelfTestById(HW_LOCK_CTRL_DEFAULT_LOCK_ID, outResult);
+}
+
+bool HwLockCtrlInitById(HwLockIdT lockId)
+{
+    FAUX_LOG_INFO("%s(%u) executed", __FUNCTION__, (unsigned)lockId);
+    return true;
+}
+
+bool HwLockCtrlLockById(HwLockIdT lockId)
+{
+    FAUX_LOG_INFO("%s(%u) executed", __FUNCTION__, (unsigned)lockId);
+    return true;
+}
+
+bool HwLockCtrlUnlockById(HwLockIdT lockId)
+{
+    FAUX_LOG_INFO("%s(%u) executed", __FUNCTION__, (unsigned)lockId);
+    return true;
+}
+
+bool HwLockCtrlSelfTestById(HwLockIdT lockId, HwLockCtrlSelfTestResultT* outResult)
+{
+    FAUX_LOG_INFO("%s(%u) executed", __FUNCTION__, (unsigned)lockId);
     if (outResult)
     {
         *outResult = HW_LOCK_CTRL_SELF_TEST_PASSED;
@@ -35,7 +55,35 @@ bool HwLockCtrlSelfTest(HwLockCtrlSelfTestResultT* outResult)
     }
     else
     {
-        printf("%s() executed with nullptr arg\n", __FUNCTION__);
+        FAUX_LOG_WARNING("%s() executed with nullptr arg", __FUNCTION__);
         return false;
     }
 }
+
+/**
+ * @brief the fake hardware completes each asynchronous
+ *        operation at once, from the caller's context.
+ */
+bool HwLockCtrlLockAsync(HwLockIdT lockId, HwLockCtrlCompletionCallback callback, void* context)
+{
+    HwLockCtrlCompletionT completion = { lockId, HW_LOCK_CTRL_OPERATION_LOCK, false, HW_LOCK_CTRL_SELF_TEST_PASSED };
+    completion.ok = HwLockCtrlLockById(lockId);
+    callback(context, &completion);
+    return true;
+}
+
+bool HwLockCtrlUnlockAsync(HwLockIdT lockId, HwLockCtrlCompletionCallback callback, void* context)
+{
+    HwLockCtrlCompletionT completion = { lockId, HW_LOCK_CTRL_OPERATION_UNLOCK, false, HW_LOCK_CTRL_SELF_TEST_PASSED };
+    completion.ok = HwLockCtrlUnlockById(lockId);
+    callback(context, &completion);
+    return true;
+}
+
+bool HwLockCtrlSelfTestAsync(HwLockIdT lockId, HwLockCtrlCompletionCallback callback, void* context)
+{
+    HwLockCtrlCompletionT completion = { lockId, HW_LOCK_CTRL_OPERATION_SELF_TEST, false, HW_LOCK_CTRL_SELF_TEST_PASSED };
+    completion.ok = HwLockCtrlSelfTestById(lockId, &completion.selfTestResult);
+    callback(context, &completion);
+    return true;
+}
@@ -0,0 +1,118 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @brief a simulated Hw Lock Ctrl driver, implementing hwLockCtrl.h for
+ *        any number of lock IDs, where each operation takes time, as a
+ *        motor or self test would, and may fail. Used to load test the
+ *        services with slow or flaky hardware. Link it in place of the
+ *        hwLockCtrl library.
+ *
+ *        Synchronous operations block the caller for the operation's
+ *        latency. Asynchronous operations complete from the simulator's
+ *        own thread, as an interrupt handler would, once their latency
+ *        has elapsed.
+ */
+#ifndef ACTIVEOBJECTUNITTESTINGDEMO_HWLOCKCTRLSIM_H
+#define ACTIVEOBJECTUNITTESTINGDEMO_HWLOCKCTRLSIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "hwLockCtrl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum HwLockCtrlSimDistribution
+{
+    HW_LOCK_CTRL_SIM_LATENCY_FIXED,       //always minUs
+    HW_LOCK_CTRL_SIM_LATENCY_UNIFORM,     //minUs to maxUs
+    HW_LOCK_CTRL_SIM_LATENCY_EXPONENTIAL  //minUs plus an exponential tail of mean meanUs, up to maxUs
+} HwLockCtrlSimDistributionT;
+
+/**
+ * @brief HwLockCtrlSimProfile - the latency and failure model of one
+ *        kind of operation.
+ */
+typedef struct HwLockCtrlSimProfile
+{
+    HwLockCtrlSimDistributionT distribution;
+    uint32_t minUs;
+    uint32_t meanUs;    //exponential only
+    uint32_t maxUs;     //uniform: at least minUs. exponential: 0 for no limit
+    double failureRate; //0 to 1, the chance the operation fails, as 'ok' false
+} HwLockCtrlSimProfileT;
+
+/**
+ * @brief HwLockCtrlSimSetProfile() - the model of all later operations
+ *        of the given kind. Initially, all operations complete at once.
+ * @return false: bad arguments.
+ */
+bool HwLockCtrlSimSetProfile(HwLockCtrlOperationT operation, const HwLockCtrlSimProfileT* profile);
+bool HwLockCtrlSimGetProfile(HwLockCtrlOperationT operation, HwLockCtrlSimProfileT* profile);
+
+/**
+ * @brief HwLockCtrlSimSetLatencyUs() - shorthand for a fixed latency,
+ *        keeping the operation's failure rate.
+ */
+void HwLockCtrlSimSetLatencyUs(HwLockCtrlOperationT operation, uint32_t latencyUs);
+
+/**
+ * @brief HwLockCtrlSimSetSelfTestFailureRates() - of the self tests which
+ *        run, the chance each reports HW_LOCK_CTRL_SELF_TEST_FAILED_POWER
+ *        or HW_LOCK_CTRL_SELF_TEST_FAILED_MOTOR.
+ * @return false: a rate is outside 0 to 1, or they sum above 1.
+ */
+bool HwLockCtrlSimSetSelfTestFailureRates(double powerRate, double motorRate);
+
+/**
+ * @brief HwLockCtrlSimSeed() - reseed the latency and failure draws,
+ *        so a single threaded run can be repeated.
+ */
+void HwLockCtrlSimSeed(uint64_t seed);
+
+/**
+ * @brief HwLockCtrlSimReset() - restore the initial profiles and rates,
+ *        and clear the statistics. Pending operations still complete.
+ */
+void HwLockCtrlSimReset(void);
+
+typedef struct HwLockCtrlSimStats
+{
+    uint64_t started[HW_LOCK_CTRL_OPERATION_SELF_TEST + 1];  //per HwLockCtrlOperationT
+    uint64_t failed[HW_LOCK_CTRL_OPERATION_SELF_TEST + 1];   //completed with 'ok' false
+    uint64_t selfTestPowerFailures;
+    uint64_t selfTestMotorFailures;
+    size_t pending;     //asynchronous operations whose callback has not yet returned
+    size_t maxPending;
+} HwLockCtrlSimStatsT;
+
+bool HwLockCtrlSimGetStats(HwLockCtrlSimStatsT* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //ACTIVEOBJECTUNITTESTINGDEMO_HWLOCKCTRLSIM_H
@@ -0,0 +1,429 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "hwLockCtrlSim.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+constexpr size_t OperationCount = HW_LOCK_CTRL_OPERATION_SELF_TEST + 1;
+constexpr uint64_t DefaultSeed = 1;
+constexpr HwLockCtrlSimProfileT ImmediateProfile = { HW_LOCK_CTRL_SIM_LATENCY_FIXED, 0, 0, 0, 0.0 };
+
+bool IsRate(double rate)
+{
+    return (rate >= 0.0) && (rate <= 1.0);
+}
+
+/**
+ * @brief Simulator - draws each operation's latency and outcome, then
+ *        completes asynchronous operations from its own thread, in order
+ *        of their due time, then in the order they were started.
+ */
+class Simulator
+{
+public:
+    static Simulator& Instance()
+    {
+        static Simulator simulator;
+        return simulator;
+    }
+
+    ~Simulator()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mCondition.notify_one();
+        if (mThread.joinable())
+        {
+            mThread.join();
+        }
+    }
+
+    Simulator(const Simulator&) = delete;
+    Simulator& operator=(const Simulator&) = delete;
+
+    bool SetProfile(HwLockCtrlOperationT operation, const HwLockCtrlSimProfileT& profile)
+    {
+        bool valid = (static_cast<size_t>(operation) < OperationCount) && IsRate(profile.failureRate);
+        switch (profile.distribution)
+        {
+        case HW_LOCK_CTRL_SIM_LATENCY_FIXED:
+            break;
+        case HW_LOCK_CTRL_SIM_LATENCY_UNIFORM:
+            valid = valid && (profile.maxUs >= profile.minUs);
+            break;
+        case HW_LOCK_CTRL_SIM_LATENCY_EXPONENTIAL:
+            valid = valid && ((profile.maxUs == 0) || (profile.maxUs >= profile.minUs));
+            break;
+        default:
+            valid = false;
+            break;
+        }
+
+        if (valid)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mProfiles[operation] = profile;
+        }
+        return valid;
+    }
+
+    bool GetProfile(HwLockCtrlOperationT operation, HwLockCtrlSimProfileT& profile)
+    {
+        if (static_cast<size_t>(operation) >= OperationCount)
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        profile = mProfiles[operation];
+        return true;
+    }
+
+    bool SetSelfTestFailureRates(double powerRate, double motorRate)
+    {
+        if (!IsRate(powerRate) || !IsRate(motorRate) || ((powerRate + motorRate) > 1.0))
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mPowerFailureRate = powerRate;
+        mMotorFailureRate = motorRate;
+        return true;
+    }
+
+    void Seed(uint64_t seed)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRandom.seed(seed);
+    }
+
+    void Reset()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (auto& profile : mProfiles)
+        {
+            profile = ImmediateProfile;
+        }
+        mPowerFailureRate = 0.0;
+        mMotorFailureRate = 0.0;
+        mRandom.seed(DefaultSeed);
+        mStats = HwLockCtrlSimStatsT{};
+        mStats.pending = mOperations.size() + mCompleting;
+        mStats.maxPending = mStats.pending;
+    }
+
+    HwLockCtrlSimStatsT Stats()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mStats;
+    }
+
+    /**
+     * @brief Perform - the operation's outcome, after blocking the caller
+     *        for the operation's latency.
+     */
+    HwLockCtrlCompletionT Perform(HwLockIdT lockId, HwLockCtrlOperationT operation)
+    {
+        Operation drawn;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            drawn = Draw(lockId, operation);
+        }
+        std::this_thread::sleep_until(drawn.due);
+        return drawn.completion;
+    }
+
+    bool Start(HwLockIdT lockId, HwLockCtrlOperationT operation,
+               HwLockCtrlCompletionCallback callback, void* context)
+    {
+        if (callback == nullptr)
+        {
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (!mThread.joinable())
+            {
+                mThread = std::thread(&Simulator::Run, this);
+            }
+
+            Operation started = Draw(lockId, operation);
+            started.callback = callback;
+            started.context = context;
+            mOperations.push(started);
+            if (++mStats.pending > mStats.maxPending)
+            {
+                mStats.maxPending = mStats.pending;
+            }
+        }
+        mCondition.notify_one();
+        return true;
+    }
+
+private:
+    struct Operation
+    {
+        Clock::time_point due;
+        uint64_t sequence;
+        HwLockCtrlCompletionCallback callback;
+        void* context;
+        HwLockCtrlCompletionT completion;
+    };
+
+    struct Later
+    {
+        bool operator()(const Operation& a, const Operation& b) const
+        {
+            return (a.due != b.due) ? (a.due > b.due) : (a.sequence > b.sequence);
+        }
+    };
+
+    Simulator()
+    {
+        Reset();
+    }
+
+    /**
+     * @brief Draw - the latency and outcome of an operation starting now.
+     *        Called with the mutex held.
+     */
+    Operation Draw(HwLockIdT lockId, HwLockCtrlOperationT operation)
+    {
+        const HwLockCtrlSimProfileT& profile = mProfiles[operation];
+        double latencyUs = profile.minUs;
+        switch (profile.distribution)
+        {
+        case HW_LOCK_CTRL_SIM_LATENCY_UNIFORM:
+            latencyUs = std::uniform_real_distribution<double>(profile.minUs, profile.maxUs)(mRandom);
+            break;
+        case HW_LOCK_CTRL_SIM_LATENCY_EXPONENTIAL:
+            if (profile.meanUs > 0)
+            {
+                latencyUs += std::exponential_distribution<double>(1.0 / profile.meanUs)(mRandom);
+            }
+            if ((profile.maxUs != 0) && (latencyUs > profile.maxUs))
+            {
+                latencyUs = profile.maxUs;
+            }
+            break;
+        case HW_LOCK_CTRL_SIM_LATENCY_FIXED: //purposeful fallthrough
+        default:
+            break;
+        }
+
+        HwLockCtrlCompletionT completion = { lockId, operation, true, HW_LOCK_CTRL_SELF_TEST_PASSED };
+        std::uniform_real_distribution<double> chance(0.0, 1.0);
+        ++mStats.started[operation];
+        if (chance(mRandom) < profile.failureRate)
+        {
+            completion.ok = false;
+            ++mStats.failed[operation];
+        }
+        else if (operation == HW_LOCK_CTRL_OPERATION_SELF_TEST)
+        {
+            double draw = chance(mRandom);
+            if (draw < mPowerFailureRate)
+            {
+                completion.selfTestResult = HW_LOCK_CTRL_SELF_TEST_FAILED_POWER;
+                ++mStats.selfTestPowerFailures;
+            }
+            else if (draw < (mPowerFailureRate + mMotorFailureRate))
+            {
+                completion.selfTestResult = HW_LOCK_CTRL_SELF_TEST_FAILED_MOTOR;
+                ++mStats.selfTestMotorFailures;
+            }
+        }
+
+        auto latency = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::micro>(latencyUs));
+        return Operation{ Clock::now() + latency, mSequence++, nullptr, nullptr, completion };
+    }
+
+    void Run()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (!mStop)
+        {
+            if (mOperations.empty())
+            {
+                mCondition.wait(lock);
+                continue;
+            }
+
+            Operation next = mOperations.top();
+            if (Clock::now() < next.due)
+            {
+                mCondition.wait_until(lock, next.due);
+                continue;
+            }
+
+            mOperations.pop();
+            ++mCompleting;
+            lock.unlock();
+            next.callback(next.context, &next.completion);
+            lock.lock();
+            --mCompleting;
+            if (mStats.pending > 0)
+            {
+                --mStats.pending;
+            }
+        }
+    }
+
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    HwLockCtrlSimProfileT mProfiles[OperationCount] = {};
+    double mPowerFailureRate = 0.0;
+    double mMotorFailureRate = 0.0;
+    std::mt19937_64 mRandom{DefaultSeed};
+    HwLockCtrlSimStatsT mStats = {};
+    std::priority_queue<Operation, std::vector<Operation>, Later> mOperations;
+    size_t mCompleting = 0;
+    uint64_t mSequence = 0;
+    bool mStop = false;
+    std::thread mThread;
+};
+
+} // namespace
+
+bool HwLockCtrlSimSetProfile(HwLockCtrlOperationT operation, const HwLockCtrlSimProfileT* profile)
+{
+    return (profile != nullptr) && Simulator::Instance().SetProfile(operation, *profile);
+}
+
+bool HwLockCtrlSimGetProfile(HwLockCtrlOperationT operation, HwLockCtrlSimProfileT* profile)
+{
+    return (profile != nullptr) && Simulator::Instance().GetProfile(operation, *profile);
+}
+
+void HwLockCtrlSimSetLatencyUs(HwLockCtrlOperationT operation, uint32_t latencyUs)
+{
+    HwLockCtrlSimProfileT profile;
+    if (Simulator::Instance().GetProfile(operation, profile))
+    {
+        profile.distribution = HW_LOCK_CTRL_SIM_LATENCY_FIXED;
+        profile.minUs = latencyUs;
+        Simulator::Instance().SetProfile(operation, profile);
+    }
+}
+
+bool HwLockCtrlSimSetSelfTestFailureRates(double powerRate, double motorRate)
+{
+    return Simulator::Instance().SetSelfTestFailureRates(powerRate, motorRate);
+}
+
+void HwLockCtrlSimSeed(uint64_t seed)
+{
+    Simulator::Instance().Seed(seed);
+}
+
+void HwLockCtrlSimReset(void)
+{
+    Simulator::Instance().Reset();
+}
+
+bool HwLockCtrlSimGetStats(HwLockCtrlSimStatsT* stats)
+{
+    if (stats == nullptr)
+    {
+        return false;
+    }
+
+    *stats = Simulator::Instance().Stats();
+    return true;
+}
+bool HwLockCtrlInit()
+{
+    return HwLockCtrlInitById(HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+}
+
+bool HwLockCtrlLock()
+{
+    return HwLockCtrlLockById(HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+}
+
+bool HwLockCtrlUnlock()
+{
+    return HwLockCtrlUnlockById(HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+}
+
+bool HwLockCtrlSelfTest(HwLockCtrlSelfTestResultT* outResult)
+{
+    return HwLockCtrlSelfTestById(HW_LOCK_CTRL_DEFAULT_LOCK_ID, outResult);
+}
+
+bool HwLockCtrlInitById(HwLockIdT lockId)
+{
+    (void)lockId;
+    return true;
+}
+
+bool HwLockCtrlLockById(HwLockIdT lockId)
+{
+    return Simulator::Instance().Perform(lockId, HW_LOCK_CTRL_OPERATION_LOCK).ok;
+}
+
+bool HwLockCtrlUnlockById(HwLockIdT lockId)
+{
+    return Simulator::Instance().Perform(lockId, HW_LOCK_CTRL_OPERATION_UNLOCK).ok;
+}
+
+bool HwLockCtrlSelfTestById(HwLockIdT lockId, HwLockCtrlSelfTestResultT* outResult)
+{
+    if (outResult == nullptr)
+    {
+        return false;
+    }
+
+    HwLockCtrlCompletionT completion = Simulator::Instance().Perform(lockId, HW_LOCK_CTRL_OPERATION_SELF_TEST);
+    *outResult = completion.selfTestResult;
+    return completion.ok;
+}
+
+bool HwLockCtrlLockAsync(HwLockIdT lockId, HwLockCtrlCompletionCallback callback, void* context)
+{
+    return Simulator::Instance().Start(lockId, HW_LOCK_CTRL_OPERATION_LOCK, callback, context);
+}
+
+bool HwLockCtrlUnlockAsync(HwLockIdT lockId, HwLockCtrlCompletionCallback callback, void* context)
+{
+    return Simulator::Instance().Start(lockId, HW_LOCK_CTRL_OPERATION_UNLOCK, callback, context);
+}
+
+bool HwLockCtrlSelfTestAsync(HwLockIdT lockId, HwLockCtrlCompletionCallback callback, void* context)
+{
+    return Simulator::Instance().Start(lockId, HW_LOCK_CTRL_OPERATION_SELF_TEST, callback, context);
+}
@@ -0,0 +1,104 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @brief the ServicesEventBus (SEB) delivers events published by the services,
+ *        such as the HwLockCtrlService's lock state changes, to any number of
+ *        subscribers. Each subscriber provides its own queue, events are copied
+ *        into it with a non-blocking send, and are processed in the subscriber's
+ *        own thread context. A slow subscriber never stalls the publisher.
+ *
+ * @note: this file represents the public facing C API of the bus, see
+ *        cmsEventBus.hpp for the underlying C++ implementation.
+ */
+
+#ifndef ACTIVEOBJECTDEMO_SERVICESEVENTBUS_H
+#define ACTIVEOBJECTDEMO_SERVICESEVENTBUS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "fauxQueue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief published signals are distinct from each active object's
+ *        own signals, so a subscriber may receive published events
+ *        in the same queue as its other events.
+ */
+#define SEB_PUBLISHED_SIGNALS_BEGIN 0x100
+
+typedef enum SEB_Signal
+{
+    SEB_SIG_LOCK_STATE_CHANGED = SEB_PUBLISHED_SIGNALS_BEGIN, //value: HLCS_LockStateT
+    SEB_SIG_SELF_TEST_RESULT,                                 //value: HLCS_SelfTestResultT
+    SEB_SIG_END
+} SEB_SignalT;
+
+typedef struct SEB_Event
+{
+    uint32_t signal;
+    int32_t value;
+} SEB_EventT;
+
+typedef int32_t SEB_SubscriberT;
+#define SEB_INVALID_SUBSCRIBER (-1)
+
+/**
+ * @brief SEB_AddSubscriber() - register a queue of SEB_EventT items.
+ *        The subscriber is initially subscribed to nothing.
+ * @return the subscriber, SEB_INVALID_SUBSCRIBER if too many subscribers exist.
+ */
+SEB_SubscriberT SEB_AddSubscriber(QueueHandle_t queue);
+
+/**
+ * @brief SEB_RemoveSubscriber() - unsubscribe from everything. Once this
+ *        returns, no further events are sent and the queue may be deleted.
+ */
+void SEB_RemoveSubscriber(SEB_SubscriberT subscriber);
+
+bool SEB_Subscribe(SEB_SubscriberT subscriber, SEB_SignalT signal);
+bool SEB_Unsubscribe(SEB_SubscriberT subscriber, SEB_SignalT signal);
+
+/**
+ * @brief SEB_Publish() - copy the event into the queue of every subscriber
+ *        of its signal. Never blocks, an event is dropped for a subscriber
+ *        whose queue is full.
+ * @return the number of subscribers the event was delivered to.
+ */
+size_t SEB_Publish(SEB_SignalT signal, int32_t value);
+
+/**
+ * @brief SEB_GetDroppedCount() - events dropped due to full subscriber queues.
+ */
+uint64_t SEB_GetDroppedCount();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //ACTIVEOBJECTDEMO_SERVICESEVENTBUS_H
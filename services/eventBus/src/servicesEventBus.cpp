@@ -0,0 +1,83 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "servicesEventBus.h"
+#include "cmsEventBus.hpp"
+
+namespace
+{
+
+struct PublishedEvent : public cms::BaseEvent<uint32_t>
+{
+    int32_t value;
+};
+
+static_assert(sizeof(PublishedEvent) == sizeof(SEB_EventT), "PublishedEvent must match SEB_EventT");
+
+using ServicesEventBus = cms::EventBus<PublishedEvent, SEB_PUBLISHED_SIGNALS_BEGIN,
+                                       SEB_SIG_END - SEB_PUBLISHED_SIGNALS_BEGIN>;
+
+ServicesEventBus s_bus;
+
+ServicesEventBus::SubscriberId ToId(SEB_SubscriberT subscriber)
+{
+    return (subscriber < 0) ? ServicesEventBus::InvalidSubscriber :
+                              static_cast<ServicesEventBus::SubscriberId>(subscriber);
+}
+
+} // namespace
+
+SEB_SubscriberT SEB_AddSubscriber(QueueHandle_t queue)
+{
+    auto id = s_bus.AddSubscriber(queue);
+    return (id == ServicesEventBus::InvalidSubscriber) ? SEB_INVALID_SUBSCRIBER : static_cast<SEB_SubscriberT>(id);
+}
+
+void SEB_RemoveSubscriber(SEB_SubscriberT subscriber)
+{
+    s_bus.RemoveSubscriber(ToId(subscriber));
+}
+
+bool SEB_Subscribe(SEB_SubscriberT subscriber, SEB_SignalT signal)
+{
+    return s_bus.Subscribe(ToId(subscriber), signal);
+}
+
+bool SEB_Unsubscribe(SEB_SubscriberT subscriber, SEB_SignalT signal)
+{
+    return s_bus.Unsubscribe(ToId(subscriber), signal);
+}
+
+size_t SEB_Publish(SEB_SignalT signal, int32_t value)
+{
+    PublishedEvent event;
+    event.signal = signal;
+    event.value = value;
+    return s_bus.Publish(event);
+}
+
+uint64_t SEB_GetDroppedCount()
+{
+    return s_bus.Dropped();
+}
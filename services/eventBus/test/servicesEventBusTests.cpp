@@ -0,0 +1,155 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "servicesEventBus.h"
+#include "CppUTest/TestHarness.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+static constexpr size_t TestQueueDepth = 2;
+
+TEST_GROUP(ServicesEventBusTests)
+{
+    QueueHandle_t mQueueA = nullptr;
+    QueueHandle_t mQueueB = nullptr;
+    SEB_SubscriberT mSubscriberA = SEB_INVALID_SUBSCRIBER;
+    SEB_SubscriberT mSubscriberB = SEB_INVALID_SUBSCRIBER;
+
+    void setup() final
+    {
+        mQueueA = xQueueCreate(TestQueueDepth, sizeof(SEB_EventT));
+        mQueueB = xQueueCreate(TestQueueDepth, sizeof(SEB_EventT));
+        mSubscriberA = SEB_AddSubscriber(mQueueA);
+        mSubscriberB = SEB_AddSubscriber(mQueueB);
+        CHECK_TRUE(mSubscriberA != SEB_INVALID_SUBSCRIBER);
+        CHECK_TRUE(mSubscriberB != SEB_INVALID_SUBSCRIBER);
+    }
+
+    void teardown() final
+    {
+        SEB_RemoveSubscriber(mSubscriberA);
+        SEB_RemoveSubscriber(mSubscriberB);
+        vQueueDelete(mQueueA);
+        vQueueDelete(mQueueB);
+    }
+
+    static void ReceiveAndCheck(QueueHandle_t queue, SEB_SignalT signal, int32_t value)
+    {
+        SEB_EventT event = { 0, 0 };
+        CHECK_TRUE(xQueueReceiveTimed(queue, &event, 0));
+        UNSIGNED_LONGS_EQUAL(signal, event.signal);
+        LONGS_EQUAL(value, event.value);
+    }
+};
+
+TEST(ServicesEventBusTests, given_no_subscriptions_then_publish_delivers_nothing)
+{
+    UNSIGNED_LONGS_EQUAL(0, SEB_Publish(SEB_SIG_LOCK_STATE_CHANGED, 1));
+    UNSIGNED_LONGS_EQUAL(0, uxQueueMessagesWaiting(mQueueA));
+    UNSIGNED_LONGS_EQUAL(0, uxQueueMessagesWaiting(mQueueB));
+}
+
+TEST(ServicesEventBusTests, given_subscriptions_then_each_subscriber_receives_only_its_signals)
+{
+    CHECK_TRUE(SEB_Subscribe(mSubscriberA, SEB_SIG_LOCK_STATE_CHANGED));
+    CHECK_TRUE(SEB_Subscribe(mSubscriberB, SEB_SIG_LOCK_STATE_CHANGED));
+    CHECK_TRUE(SEB_Subscribe(mSubscriberB, SEB_SIG_SELF_TEST_RESULT));
+
+    UNSIGNED_LONGS_EQUAL(2, SEB_Publish(SEB_SIG_LOCK_STATE_CHANGED, 7));
+    UNSIGNED_LONGS_EQUAL(1, SEB_Publish(SEB_SIG_SELF_TEST_RESULT, 3));
+
+    ReceiveAndCheck(mQueueA, SEB_SIG_LOCK_STATE_CHANGED, 7);
+    UNSIGNED_LONGS_EQUAL(0, uxQueueMessagesWaiting(mQueueA));
+    ReceiveAndCheck(mQueueB, SEB_SIG_LOCK_STATE_CHANGED, 7);
+    ReceiveAndCheck(mQueueB, SEB_SIG_SELF_TEST_RESULT, 3);
+
+    CHECK_TRUE(SEB_Unsubscribe(mSubscriberB, SEB_SIG_LOCK_STATE_CHANGED));
+    UNSIGNED_LONGS_EQUAL(1, SEB_Publish(SEB_SIG_LOCK_STATE_CHANGED, 8));
+    ReceiveAndCheck(mQueueA, SEB_SIG_LOCK_STATE_CHANGED, 8);
+    UNSIGNED_LONGS_EQUAL(0, uxQueueMessagesWaiting(mQueueB));
+}
+
+TEST(ServicesEventBusTests, given_full_subscriber_queue_then_publish_does_not_block_and_counts_the_drop)
+{
+    CHECK_TRUE(SEB_Subscribe(mSubscriberA, SEB_SIG_LOCK_STATE_CHANGED));
+    CHECK_TRUE(SEB_Subscribe(mSubscriberB, SEB_SIG_LOCK_STATE_CHANGED));
+    for (int32_t i = 0; i < static_cast<int32_t>(TestQueueDepth); ++i)
+    {
+        UNSIGNED_LONGS_EQUAL(2, SEB_Publish(SEB_SIG_LOCK_STATE_CHANGED, i));
+    }
+    ReceiveAndCheck(mQueueB, SEB_SIG_LOCK_STATE_CHANGED, 0);
+
+    uint64_t dropped = SEB_GetDroppedCount();
+    UNSIGNED_LONGS_EQUAL(1, SEB_Publish(SEB_SIG_LOCK_STATE_CHANGED, 99));
+    UNSIGNED_LONGS_EQUAL(dropped + 1, SEB_GetDroppedCount());
+    ReceiveAndCheck(mQueueB, SEB_SIG_LOCK_STATE_CHANGED, 1);
+    ReceiveAndCheck(mQueueB, SEB_SIG_LOCK_STATE_CHANGED, 99);
+}
+
+TEST(ServicesEventBusTests, given_removed_subscriber_then_it_receives_nothing_and_cannot_subscribe)
+{
+    CHECK_TRUE(SEB_Subscribe(mSubscriberA, SEB_SIG_LOCK_STATE_CHANGED));
+    SEB_RemoveSubscriber(mSubscriberA);
+    UNSIGNED_LONGS_EQUAL(0, SEB_Publish(SEB_SIG_LOCK_STATE_CHANGED, 1));
+    CHECK_FALSE(SEB_Subscribe(mSubscriberA, SEB_SIG_LOCK_STATE_CHANGED));
+    CHECK_FALSE(SEB_Subscribe(mSubscriberB, SEB_SIG_END));
+    CHECK_FALSE(SEB_Subscribe(SEB_INVALID_SUBSCRIBER, SEB_SIG_LOCK_STATE_CHANGED));
+    mSubscriberA = SEB_INVALID_SUBSCRIBER;
+}
+
+TEST(ServicesEventBusTests, given_steady_publishing_from_several_threads_then_remove_subscriber_returns)
+{
+    CHECK_TRUE(SEB_Subscribe(mSubscriberA, SEB_SIG_SELF_TEST_RESULT));
+    CHECK_TRUE(SEB_Subscribe(mSubscriberB, SEB_SIG_SELF_TEST_RESULT));
+
+    //publishes always overlap, full queues drop without blocking
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> publishers;
+    for (int i = 0; i < 3; ++i)
+    {
+        publishers.emplace_back([&stop]() {
+            while (!stop.load())
+            {
+                SEB_Publish(SEB_SIG_SELF_TEST_RESULT, 1);
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    SEB_RemoveSubscriber(mSubscriberA);
+
+    //nothing further is sent to the removed subscriber's queue
+    SEB_EventT event;
+    while (xQueueReceiveTimed(mQueueA, &event, 0)) {}
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    UNSIGNED_LONGS_EQUAL(0, uxQueueMessagesWaiting(mQueueA));
+
+    stop = true;
+    for (auto& publisher : publishers)
+    {
+        publisher.join();
+    }
+    mSubscriberA = SEB_INVALID_SUBSCRIBER;
+}
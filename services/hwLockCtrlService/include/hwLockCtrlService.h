@@ -37,7 +37,11 @@ SOFTWARE.
 #define ACTIVEOBJECTDEMO_HWLOCKCTRLSERVICE_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include "cmsExecutionOption.h"
+#include "fauxQueue.h"
+#include "fauxThread.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -56,6 +60,47 @@ typedef enum HLCS_SelfTestResult
     HLCS_SELF_TEST_RESULT_FAIL
 } HLCS_SelfTestResultT;
 
+/**
+ * @brief HLCS_Delivery - how observer callbacks are executed. Posted
+ *        deliveries coalesce rapid changes to the latest state, and the
+ *        latest self test result, so a slow observer sees fewer, later,
+ *        notifications, rather than delaying lock and unlock handling.
+ */
+typedef enum HLCS_Delivery
+{
+    HLCS_DELIVERY_INLINE,     //on the service's thread or worker, the default
+    HLCS_DELIVERY_DISPATCHER, //on a dispatcher thread of the instance
+    HLCS_DELIVERY_QUEUE       //posted to a caller supplied queue, see HLCS_DeliverNotification()
+} HLCS_DeliveryT;
+
+/**
+ * @brief HLCS_Status - a consistent snapshot of the service's status,
+ *        as of the last event it processed.
+ */
+typedef struct HLCS_Status
+{
+    HLCS_LockStateT lockState;             //as HLCS_GetState()
+    HLCS_LockStateT historyState;          //the lock state resumed after a self test
+    HLCS_SelfTestResultT lastSelfTestResult; //valid once selfTestCount is not 0
+    bool operationInProgress;              //a driver operation is in progress
+    bool selfTestInProgress;
+    size_t queueDepth;                     //events waiting once the last event was processed
+    uint64_t eventsProcessed;
+    uint64_t transitions;                  //changes of the state machine's active state
+    uint64_t lockCount;                    //times the locked state was reported
+    uint64_t unlockCount;                  //times the unlocked state was reported
+    uint64_t selfTestCount;
+    uint64_t selfTestFailures;
+    uint64_t driverFailures;               //driver lock or unlock operations which failed
+    uint64_t operationTimeouts;            //driver operations failed as they did not complete in time
+} HLCS_StatusT;
+
+/**
+ * @note: the functions below, without a handle, control a single default
+ *        instance of the service, for hardware lock HW_LOCK_CTRL_DEFAULT_LOCK_ID.
+ *        See HLCS_Create() for a service instance per lock of a bank of locks.
+ */
+
 /**
  *  @brief HLCS_Init() will initialize the module and associated RTOS
  *         components. The module will be idle and not actually started.
@@ -73,9 +118,20 @@ void HLCS_Destroy();
 
 /**
  * @brief HLCS_Start() will start behavior. Init() must have been called.
+ * @param option EXECUTION_OPTION_NORMAL - create a dedicated internal thread.
+ *               EXECUTION_OPTION_SHARED_SCHEDULER - process events on the
+ *                 faux scheduler's worker pool, which must be running.
+ *               EXECUTION_OPTION_UNIT_TEST - see HLCS_ProcessOneEvent().
  */
 void HLCS_Start(ExecutionOptionT option);
 
+/**
+ * @brief HLCS_SetTaskOptions() selects the priority and CPU affinity
+ *        of the internal thread, for example, to pin this service to
+ *        an isolated core. Must be called after Init() and before Start().
+ */
+void HLCS_SetTaskOptions(const TaskOptionsT* options);
+
 /**
  * @brief HLCS_GetState() provides a thread safe synchronous API to
  *            determine the current state of this module.
@@ -83,12 +139,23 @@ void HLCS_Start(ExecutionOptionT option);
  */
 HLCS_LockStateT HLCS_GetState();
 
+/**
+ * @brief HLCS_GetStatusSnapshot() copies a consistent snapshot of the
+ *        status, published by the service with a sequence lock. Never
+ *        takes a lock, and never delays the service, so it may be polled
+ *        at a high rate from any number of threads.
+ * @return false: not initialized, or bad arguments.
+ */
+bool HLCS_GetStatusSnapshot(HLCS_StatusT* status);
+
 typedef void (*HLCS_ChangeStateCallback)(HLCS_LockStateT state);
 /**
  * @brief HLCS_RegisterChangeStateCallback() provides a method to enable
  *        a single external observer of this module's state.
  * @note: The callback will be executed in another thread context.
  *        The provided callback should be "fast" with minimal blocking.
+ *        Any number of observers may instead subscribe to
+ *        SEB_SIG_LOCK_STATE_CHANGED, see servicesEventBus.h.
  */
 void HLCS_RegisterChangeStateCallback(HLCS_ChangeStateCallback callback);
 
@@ -98,9 +165,19 @@ typedef void (*HLCS_SelfTestResultCallback)(HLCS_SelfTestResultT result);
  *        a single external observer of this module's self test behavior.
  * @note: The callback will be executed in another thread context.
  *        The provided callback should be "fast" with minimal blocking.
+ *        Any number of observers may instead subscribe to
+ *        SEB_SIG_SELF_TEST_RESULT, see servicesEventBus.h.
  */
 void HLCS_RegisterSelfTestResultCallback(HLCS_SelfTestResultCallback callback);
 
+/**
+ * @brief HLCS_SetCallbackDelivery() selects HLCS_DELIVERY_INLINE or
+ *        HLCS_DELIVERY_DISPATCHER for the callbacks above, for example,
+ *        for observers which block on console I/O. Must be called after
+ *        Init() and before Start().
+ */
+void HLCS_SetCallbackDelivery(HLCS_DeliveryT delivery);
+
 /**
  * @brief HLCS_RequestLockedAsync() issue an asynchronous request to this module
  *        to lock the hardware lock.
@@ -135,6 +212,130 @@ void HLCS_RequestSelfTestAsync();
  */
 bool HLCS_ProcessOneEvent(ExecutionOptionT option);
 
+/**
+ * @brief HLCS_ProcessEventBatch() - drain all pending events from the
+ *        internal queue with a single receive, then process them in order.
+ *        Used by the internal thread, and provided for unit testing access.
+ *
+ * @param option EXECUTION_OPTION_NORMAL - internal, normal thread use, blocks
+ *                                         until at least one event is available.
+ *               EXECUTION_OPTION_UNIT_TEST - for unit testing, never blocks.
+ *
+ * @return the number of events processed.
+ */
+size_t HLCS_ProcessEventBatch(ExecutionOptionT option);
+
+/****************************************************************************/
+/*****  Multiple instances, one per hardware lock                   *********/
+/****************************************************************************/
+
+typedef struct HLCS_Instance* HLCS_Handle;
+
+typedef void (*HLCS_InstanceChangeStateCallback)(void* context, HLCS_Handle handle, HLCS_LockStateT state);
+typedef void (*HLCS_InstanceSelfTestResultCallback)(void* context, HLCS_Handle handle, HLCS_SelfTestResultT result);
+
+typedef enum HLCS_NotificationKind
+{
+    HLCS_NOTIFICATION_STATE_CHANGED,   //value: HLCS_LockStateT
+    HLCS_NOTIFICATION_SELF_TEST_RESULT //value: HLCS_SelfTestResultT
+} HLCS_NotificationKindT;
+
+/**
+ * @brief HLCS_Notification - an observer notification, as posted with
+ *        HLCS_DELIVERY_QUEUE. The kind leads, as the queue's coalescing
+ *        signal, see xQueueSetCoalescing().
+ */
+typedef struct HLCS_Notification
+{
+    uint32_t kind; //HLCS_NotificationKindT
+    int32_t value;
+    HLCS_Handle handle;
+} HLCS_NotificationT;
+
+/**
+ * @brief the defaults of HLCS_Config operationTimeoutMs and lockRetryDelayMs.
+ */
+#define HLCS_DEFAULT_OPERATION_TIMEOUT_MS 2000
+#define HLCS_DEFAULT_LOCK_RETRY_DELAY_MS 500
+
+typedef struct HLCS_Config
+{
+    uint32_t lockId;           //the hwLockCtrl driver lock ID
+    const char* name;          //thread and trace name, up to 15 characters, NULL selects "HLCS"
+    const TaskOptionsT* taskOptions; //EXECUTION_OPTION_NORMAL only, NULL selects the defaults
+    HLCS_InstanceChangeStateCallback changeStateCallback;        //optional
+    HLCS_InstanceSelfTestResultCallback selfTestResultCallback;  //optional
+    void* callbackContext;
+    bool publishToEventBus;    //SEB_SIG_* events do not identify the lock, so
+                               //a bank of locks usually relies on the callbacks
+    HLCS_DeliveryT delivery;   //of the callbacks, event bus events are always posted
+    QueueHandle_t notificationQueue; //HLCS_DELIVERY_QUEUE only, a QUEUE_MODE_STANDARD queue
+                                     //of HLCS_NotificationT, of at least 2 items, dedicated
+                                     //to this instance, as notifications coalesce by kind
+    uint32_t operationTimeoutMs; //a driver operation not completed in time fails, 0 selects
+                                 //HLCS_DEFAULT_OPERATION_TIMEOUT_MS. Only enforced if the timer
+                                 //service is running when created, see xTimerServiceStart()
+    uint32_t lockRetryDelayMs;   //a failed lock is retried, up to HLCS_LOCK_RETRY_LIMIT times, after
+                                 //this delay, 0 selects HLCS_DEFAULT_LOCK_RETRY_DELAY_MS. As above,
+                                 //only with the timer service
+} HLCS_ConfigT;
+
+/**
+ * @brief consecutive lock retries, see HLCS_Config lockRetryDelayMs.
+ */
+#define HLCS_LOCK_RETRY_LIMIT 3
+
+/**
+ * @brief HLCS_Create() - create an idle service instance, as HLCS_Init().
+ *        All instance state lives in one cache line aligned allocation.
+ *        With the timer service running, it must keep running until the
+ *        instance is deleted.
+ * @return NULL: bad arguments or out of memory.
+ */
+HLCS_Handle HLCS_Create(const HLCS_ConfigT* config);
+
+/**
+ * @brief HLCS_DeliverNotification() - execute the callback of a notification
+ *        received from an HLCS_DELIVERY_QUEUE queue, in the caller's context.
+ *        The instance must not have been deleted meanwhile.
+ * @return false: bad arguments.
+ */
+bool HLCS_DeliverNotification(const HLCS_NotificationT* notification);
+
+/**
+ * @brief HLCS_Delete() - stop and release the instance, as HLCS_Destroy().
+ *        A driver operation in progress is abandoned. Should the driver
+ *        not return from its completion within the operation timeout,
+ *        the instance is leaked rather than released under the driver.
+ */
+void HLCS_Delete(HLCS_Handle handle);
+
+/**
+ * @brief HLCS_InstanceStart() - as HLCS_Start(). Many instances share a
+ *        thread, or a worker pool, with EXECUTION_OPTION_SHARED_SCHEDULER,
+ *        see xSchedulerStart(), rather than each creating its own thread.
+ */
+void HLCS_InstanceStart(HLCS_Handle handle, ExecutionOptionT option);
+
+HLCS_LockStateT HLCS_InstanceGetState(HLCS_Handle handle);
+bool HLCS_InstanceGetStatusSnapshot(HLCS_Handle handle, HLCS_StatusT* status);
+uint32_t HLCS_InstanceGetLockId(HLCS_Handle handle);
+void HLCS_InstanceRequestLockedAsync(HLCS_Handle handle);
+void HLCS_InstanceRequestUnlockedAsync(HLCS_Handle handle);
+void HLCS_InstanceRequestSelfTestAsync(HLCS_Handle handle);
+
+/**
+ * @brief HLCS_InstanceGetQueueStats() - a snapshot of the instance's
+ *        event queue statistics, see xQueueGetStats().
+ */
+bool HLCS_InstanceGetQueueStats(HLCS_Handle handle, QueueStatsT* stats);
+
+/**
+ * @brief as HLCS_ProcessOneEvent() and HLCS_ProcessEventBatch().
+ */
+bool HLCS_InstanceProcessOneEvent(HLCS_Handle handle, ExecutionOptionT option);
+size_t HLCS_InstanceProcessEventBatch(HLCS_Handle handle, ExecutionOptionT option);
+
 #ifdef __cplusplus
 }
 #endif
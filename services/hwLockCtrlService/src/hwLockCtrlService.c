@@ -24,115 +24,260 @@ SOFTWARE.
 #include <stdatomic.h>
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "hwLockCtrlService.h"
 #include "hwLockCtrl.h"
 #include "fauxQueue.h"
 #include "fauxThread.h"
+#include "fauxTimer.h"
+#include "fauxScheduler.h"
+#include "fauxLog.h"
+#include "fauxTrace.h"
+#include "servicesEventBus.h"
+#include "hwLockCtrlServiceStateTable.h"
 
-typedef enum Signal
-{
-    SM_ENTER,
-    SM_EXIT,
-    SIG_REQUEST_LOCKED,
-    SIG_REQUEST_UNLOCKED,
-    SIG_REQUEST_SELF_TEST,
-    SIG_REQUEST_THREAD_EXIT
-} SignalT;
+#define HLCS_CACHE_LINE_SIZE 64
+#define HLCS_NAME_LENGTH 16 //as a thread name, including the terminator
+#define HLCS_STATUS_WORDS ((sizeof(HLCS_StatusT) + sizeof(uint64_t) - 1) / sizeof(uint64_t))
+
+//depths of the internal queue's lanes, see HLCS_Lane
+#define HLCS_REQUESTS_LANE_DEPTH 10
+#define HLCS_DEFERRED_LANE_DEPTH 2 //a lock or unlock request, and a self test request
+#define HLCS_COMPLETIONS_LANE_DEPTH 2 //a completion, and the timeout of the same operation
+#define HLCS_EXIT_LANE_DEPTH 1
+#define HLCS_QUEUE_CAPACITY (HLCS_REQUESTS_LANE_DEPTH + HLCS_DEFERRED_LANE_DEPTH + \
+                             HLCS_COMPLETIONS_LANE_DEPTH + HLCS_EXIT_LANE_DEPTH)
 
 typedef struct HLCS_EventType
 {
     SignalT signal;
+    int32_t value; //driver completions only, 0 for requests
 } HLCS_EventTypeT;
 
+//priority lanes of the internal queue, the highest lane is received first.
+typedef enum HLCS_Lane
+{
+    HLCS_LANE_REQUESTS,         //external requests, FIFO
+    HLCS_LANE_DEFERRED,         //requests deferred while busy, ahead of newer requests
+    HLCS_LANE_COMPLETIONS,      //driver completions and timeouts, at most one operation is in progress
+    HLCS_LANE_EXIT,             //overtakes pending requests
+    HLCS_LANE_COUNT
+} HLCS_LaneT;
+
+//the driver operation, shared by the service and the driver's completion
+typedef enum HLCS_OperationState
+{
+    HLCS_OPERATION_IDLE,
+    HLCS_OPERATION_RUNNING,
+    HLCS_OPERATION_ABANDONED //timed out, the driver has yet to complete it
+} HLCS_OperationStateT;
+
+/**
+ * @brief HLCS_Instance - all state of one service instance. The fields
+ *        written by the service, and read by other threads, start on
+ *        their own cache line, apart from those fixed once created.
+ */
+struct HLCS_Instance
+{
+    //fixed once created, read by requesting threads
+    _Alignas(HLCS_CACHE_LINE_SIZE) QueueHandle_t eventQueue;
+    HwLockIdT lockId;
+    bool publishToEventBus;
+    HLCS_InstanceChangeStateCallback changeStateCallback;
+    HLCS_InstanceSelfTestResultCallback selfTestResultCallback;
+    void* callbackContext;
+    HLCS_DeliveryT delivery;
+    QueueHandle_t notificationQueue;  //posted deliveries only
+    TaskHandle_t notifier;            //HLCS_DELIVERY_DISPATCHER only
+    TaskOptionsT taskOptions;
+    char name[HLCS_NAME_LENGTH];
+    char queueName[HLCS_NAME_LENGTH + 8];
+    char notifierName[HLCS_NAME_LENGTH];
+    TickType_t operationTimeout;
+    TimerHandle_t operationTimer;     //NULL without the timer service
+    TickType_t lockRetryDelay;
+    TimerHandle_t lockRetryTimer;     //NULL without the timer service
+
+    //written by the service, read by any thread
+    _Alignas(HLCS_CACHE_LINE_SIZE) _Atomic HLCS_LockStateT lockState;
+    atomic_bool exitThread;
+    atomic_size_t operationsInFlight; //driver operations not yet completed
+    _Atomic HLCS_OperationStateT operationState;
+
+    //published by the service, read by any thread, see HLCS_PublishStatus()
+    _Alignas(HLCS_CACHE_LINE_SIZE) _Atomic uint32_t statusSequence; //odd while being written
+    _Atomic uint64_t statusWords[HLCS_STATUS_WORDS];
+
+    //only accessed by the thread or worker executing the service
+    TaskHandle_t thread;
+    ScheduledObjectHandle_t scheduledObject;
+    int32_t eventValue;               //of the event being dispatched
+    HwLockCtrlOperationT operation;   //the latest driver operation started
+    uint8_t lockRetries;              //since the lock was last locked or unlocked
+    HLCS_LockStateT deferredState;    //latest request while busy, UNKNOWN if none
+    bool deferredSelfTest;
+    HLCS_StatusT status;              //as of the last publication
+    CmsHsmT stateMachine;
+};
+
+typedef struct HLCS_Instance HLCS_InstanceT;
+
 //internal prototypes
-typedef void* StateRtn;
-typedef StateRtn (*HLCS_StateMachineFunc)(const HLCS_EventTypeT * const event);
-static void HLCS_PerformSelfTest();
-static void HLCS_NotifyChangedState(HLCS_LockStateT state);
-static void HLCS_PushEvent(SignalT sig);
-static void HLCS_PushUrgentEvent(SignalT sig);
-static void HLCS_SmProcess(const HLCS_EventTypeT * event);
-static void  HLCS_SmInitialize();
-static void* HLCS_SmInitialPseudoState(const HLCS_EventTypeT* const event);
-static void* HLCS_SmLocked(const HLCS_EventTypeT* const event);
-static void* HLCS_SmUnlocked(const HLCS_EventTypeT* const event);
-static void* HLCS_SmSelfTest(const HLCS_EventTypeT* const event);
-static void HLCS_Task(void);
+static void HLCS_NotifyChangedState(HLCS_InstanceT* me, HLCS_LockStateT state);
+static void HLCS_NotifySelfTestResult(HLCS_InstanceT* me, HLCS_SelfTestResultT result);
+static void HLCS_DeliverCallback(HLCS_InstanceT* me, HLCS_NotificationKindT kind, int32_t value);
+static void HLCS_InvokeCallback(const HLCS_NotificationT* notification);
+static bool HLCS_SetNotificationCoalescing(QueueHandle_t queue);
+static void HLCS_StartDispatcher(HLCS_InstanceT* me);
+static void HLCS_StopDispatcher(HLCS_InstanceT* me);
+static void HLCS_DispatcherTask(void* parameters);
+static void HLCS_PushEvent(HLCS_InstanceT* me, SignalT sig);
+static void HLCS_PushLaneEvent(HLCS_InstanceT* me, SignalT sig, int32_t value, HLCS_LaneT lane);
+static bool HLCS_HasPriorityEvents(HLCS_InstanceT* me);
+static void HLCS_ReportSendFailure(HLCS_InstanceT* me, SignalT sig, HLCS_LaneT lane);
+static bool HLCS_ProcessReceivedEvent(HLCS_InstanceT* me, const HLCS_EventTypeT* event);
+static void HLCS_SmProcess(HLCS_InstanceT* me, const HLCS_EventTypeT * event);
+static void HLCS_SmInitialize(HLCS_InstanceT* me);
+static void HLCS_PublishStatus(HLCS_InstanceT* me);
+static HLCS_LockStateT HLCS_HistoryState(const HLCS_InstanceT* me);
+static void HLCS_StartOperation(HLCS_InstanceT* me, HwLockCtrlOperationT operation);
+static void HLCS_OnDriverCompletion(void* context, const HwLockCtrlCompletionT* completion);
+static void HLCS_OnOperationTimeout(HLCS_InstanceT* me);
+static void HLCS_PostCompletion(HLCS_InstanceT* me, const HwLockCtrlCompletionT* completion);
+static void HLCS_PostFailure(HLCS_InstanceT* me, HwLockCtrlOperationT operation);
+static bool HLCS_IsCompletion(SignalT sig);
+static bool HLCS_CreateTimers(HLCS_InstanceT* me);
+static void HLCS_DeleteTimers(HLCS_InstanceT* me);
+static void HLCS_EnterLockState(HLCS_InstanceT* me, HLCS_LockStateT state);
+static void HLCS_ActionInitDriver(void* context);
+static void HLCS_ActionStartLock(void* context);
+static void HLCS_ActionStartUnlock(void* context);
+static void HLCS_ActionStartSelfTest(void* context);
+static void HLCS_ActionEnterLocked(void* context);
+static void HLCS_ActionEnterUnlocked(void* context);
+static void HLCS_ActionEnterFailed(void* context);
+static void HLCS_ActionEnterLockFailed(void* context);
+static void HLCS_ActionStopLockRetry(void* context);
+static void HLCS_ActionNotifySelfTestResult(void* context);
+static void HLCS_ActionDeferLock(void* context);
+static void HLCS_ActionDeferUnlock(void* context);
+static void HLCS_ActionDeferSelfTest(void* context);
+static void HLCS_Task(void* parameters);
+static bool HLCS_Dispatch(void* context);
+static void HLCS_DefaultChangeStateCallback(void* context, HLCS_Handle handle, HLCS_LockStateT state);
+static void HLCS_DefaultSelfTestResultCallback(void* context, HLCS_Handle handle, HLCS_SelfTestResultT result);
 
 //constants
-static const size_t QueueDepth = 10;
-static const HLCS_EventTypeT ExitEvent = { .signal = SM_EXIT};
-static const HLCS_EventTypeT EnterEvent = { .signal = SM_ENTER};
-
-//module static variables
-static _Atomic HLCS_LockStateT s_lockState = HLCS_LOCK_STATE_UNKNOWN;
-static atomic_bool s_exitThread = false;
-static TaskHandle_t s_thread = NULL;
-static QueueHandle_t s_eventQueue = NULL;
+static const size_t LaneDepths[HLCS_LANE_COUNT] =
+  {
+    [HLCS_LANE_REQUESTS] = HLCS_REQUESTS_LANE_DEPTH,
+    [HLCS_LANE_DEFERRED] = HLCS_DEFERRED_LANE_DEPTH,
+    [HLCS_LANE_COMPLETIONS] = HLCS_COMPLETIONS_LANE_DEPTH,
+    [HLCS_LANE_EXIT] = HLCS_EXIT_LANE_DEPTH
+  };
+static const TickType_t PushEventTimeout = pdMS_TO_TICKS(100);
+//one pending notification of each kind, and the dispatcher's exit
+static const size_t NotificationQueueDepth = 3;
+static const uint32_t DispatcherExitKind = HLCS_NOTIFICATION_SELF_TEST_RESULT + 1;
+static const size_t TaskStackDepth = 4096;
+//lock and unlock requests share a coalescing class, so a storm of
+//requests leaves at most one pending, carrying the latest request.
+static const uint8_t LockRequestCoalesceClass = 0;
+static const uint8_t SelfTestRequestCoalesceClass = 1;
+static const TaskOptionsT DefaultTaskOptions = { .policy = TASK_SCHED_NORMAL, .priority = 0, .cpuAffinityMask = 0 };
+static const CmsSmActionFunc StateMachineActions[HLCS_ACTION_COUNT] =
+  {
+    [HLCS_ACTION_NONE] = NULL,
+    [HLCS_ACTION_INIT_DRIVER] = HLCS_ActionInitDriver,
+    [HLCS_ACTION_START_LOCK] = HLCS_ActionStartLock,
+    [HLCS_ACTION_START_UNLOCK] = HLCS_ActionStartUnlock,
+    [HLCS_ACTION_START_SELF_TEST] = HLCS_ActionStartSelfTest,
+    [HLCS_ACTION_ENTER_LOCKED] = HLCS_ActionEnterLocked,
+    [HLCS_ACTION_ENTER_UNLOCKED] = HLCS_ActionEnterUnlocked,
+    [HLCS_ACTION_ENTER_FAILED] = HLCS_ActionEnterFailed,
+    [HLCS_ACTION_ENTER_LOCK_FAILED] = HLCS_ActionEnterLockFailed,
+    [HLCS_ACTION_STOP_LOCK_RETRY] = HLCS_ActionStopLockRetry,
+    [HLCS_ACTION_NOTIFY_SELF_TEST_RESULT] = HLCS_ActionNotifySelfTestResult,
+    [HLCS_ACTION_DEFER_LOCK] = HLCS_ActionDeferLock,
+    [HLCS_ACTION_DEFER_UNLOCK] = HLCS_ActionDeferUnlock,
+    [HLCS_ACTION_DEFER_SELF_TEST] = HLCS_ActionDeferSelfTest
+  };
+
+//module static variables, the default instance
+static HLCS_InstanceT* s_default = NULL;
 static HLCS_ChangeStateCallback s_stateChangedCallback = NULL;
 static HLCS_SelfTestResultCallback s_selfTestResultCallback = NULL;
-static HLCS_StateMachineFunc s_currentState = NULL;
-static HLCS_StateMachineFunc s_stateHistory = NULL;
-
-//internal macros for state machine readability
-#define TransitionTo(x) (x)
-#define Handled() (s_currentState)
+static TaskOptionsT s_taskOptions = { .policy = TASK_SCHED_NORMAL, .priority = 0, .cpuAffinityMask = 0 };
+static HLCS_DeliveryT s_delivery = HLCS_DELIVERY_INLINE;
 
 void HLCS_Init()
 {
     //ensure Init is being called appropriately
-    assert(s_lockState == HLCS_LOCK_STATE_UNKNOWN);
-    assert(s_thread == NULL);
-    assert(s_eventQueue == NULL);
+    assert(s_default == NULL);
     assert(s_stateChangedCallback == NULL);
     assert(s_selfTestResultCallback == NULL);
-    assert(s_currentState == NULL);
-    assert(s_stateHistory == NULL);
-    assert(s_exitThread == false);
 
-    s_eventQueue = xQueueCreate(QueueDepth, sizeof(HLCS_EventTypeT));
+    HLCS_ConfigT config =
+      {
+        .lockId = HW_LOCK_CTRL_DEFAULT_LOCK_ID,
+        .name = "HLCS",
+        .taskOptions = &s_taskOptions,
+        .changeStateCallback = HLCS_DefaultChangeStateCallback,
+        .selfTestResultCallback = HLCS_DefaultSelfTestResultCallback,
+        .callbackContext = NULL,
+        .publishToEventBus = true
+      };
+    s_default = HLCS_Create(&config);
+    assert(s_default != NULL);
 
     //thread is created in Start()
 }
 
 void HLCS_Destroy()
 {
-    if (s_eventQueue != NULL)
+    if (s_default != NULL)
     {
-        s_exitThread = true;
-        HLCS_PushUrgentEvent(SIG_REQUEST_THREAD_EXIT);
-        vTaskDelete(s_thread);
-        vQueueDelete(s_eventQueue);
+        HLCS_Delete(s_default);
+        s_default = NULL;
     }
-    s_lockState = HLCS_LOCK_STATE_UNKNOWN;
-    s_eventQueue = NULL;
+
     s_stateChangedCallback = NULL;
     s_selfTestResultCallback = NULL;
-    s_currentState = NULL;
-    s_stateHistory = NULL;
-    s_exitThread = false;
-    s_thread = NULL;
+    s_taskOptions = DefaultTaskOptions;
+    s_delivery = HLCS_DELIVERY_INLINE;
 }
 
 void HLCS_Start(ExecutionOptionT option)
 {
-    assert(s_currentState == NULL);
-    assert(s_thread == NULL);
+    assert(s_default != NULL);
+    s_default->taskOptions = s_taskOptions;
+    s_default->delivery = s_delivery;
+    HLCS_InstanceStart(s_default, option);
+}
 
-    if (EXECUTION_OPTION_NORMAL == option)
-    {
-        bool ok = xTaskCreate(HLCS_Task, "HLCS", 2000, &s_thread);
-        assert(ok == true);
-    }
-    else
-    {
-        HLCS_SmInitialize();
-    }
+void HLCS_SetTaskOptions(const TaskOptionsT* options)
+{
+    assert((s_default == NULL) || (s_default->thread == NULL));
+    assert(options != NULL);
+    s_taskOptions = *options;
+}
+
+void HLCS_SetCallbackDelivery(HLCS_DeliveryT delivery)
+{
+    assert((s_default == NULL) || (s_default->thread == NULL));
+    assert((delivery == HLCS_DELIVERY_INLINE) || (delivery == HLCS_DELIVERY_DISPATCHER));
+    s_delivery = delivery;
 }
 
 HLCS_LockStateT HLCS_GetState()
 {
-    return atomic_load(&s_lockState);
+    return (s_default != NULL) ? HLCS_InstanceGetState(s_default) : HLCS_LOCK_STATE_UNKNOWN;
+}
+
+bool HLCS_GetStatusSnapshot(HLCS_StatusT* status)
+{
+    return HLCS_InstanceGetStatusSnapshot(s_default, status);
 }
 
 void HLCS_RegisterChangeStateCallback(HLCS_ChangeStateCallback callback)
@@ -147,239 +292,887 @@ void HLCS_RegisterSelfTestResultCallback(HLCS_SelfTestResultCallback callback)
 
 void HLCS_RequestLockedAsync()
 {
-    HLCS_PushEvent(SIG_REQUEST_LOCKED);
+    HLCS_InstanceRequestLockedAsync(s_default);
 }
 
 void HLCS_RequestUnlockedAsync()
 {
-    HLCS_PushEvent(SIG_REQUEST_UNLOCKED);
+    HLCS_InstanceRequestUnlockedAsync(s_default);
 }
 
 void HLCS_RequestSelfTestAsync()
 {
-    HLCS_PushEvent(SIG_REQUEST_SELF_TEST);
+    HLCS_InstanceRequestSelfTestAsync(s_default);
 }
 
 bool HLCS_ProcessOneEvent(ExecutionOptionT option)
 {
-    if ((EXECUTION_OPTION_UNIT_TEST == option) &&
-        (0 == uxQueueMessagesWaiting(s_eventQueue)))
+    return HLCS_InstanceProcessOneEvent(s_default, option);
+}
+
+size_t HLCS_ProcessEventBatch(ExecutionOptionT option)
+{
+    return HLCS_InstanceProcessEventBatch(s_default, option);
+}
+
+void HLCS_DefaultChangeStateCallback(void* context, HLCS_Handle handle, HLCS_LockStateT state)
+{
+    (void)context;
+    (void)handle;
+    if (s_stateChangedCallback)
+    {
+        s_stateChangedCallback(state);
+    }
+}
+
+void HLCS_DefaultSelfTestResultCallback(void* context, HLCS_Handle handle, HLCS_SelfTestResultT result)
+{
+    (void)context;
+    (void)handle;
+    if (s_selfTestResultCallback)
+    {
+        s_selfTestResultCallback(result);
+    }
+}
+
+HLCS_Handle HLCS_Create(const HLCS_ConfigT* config)
+{
+    if ((config == NULL) || (config->delivery > HLCS_DELIVERY_QUEUE))
+    {
+        return NULL;
+    }
+
+    if ((config->delivery == HLCS_DELIVERY_QUEUE) && !HLCS_SetNotificationCoalescing(config->notificationQueue))
+    {
+        return NULL;
+    }
+
+    //sizeof() is a multiple of the alignment, as aligned_alloc() requires
+    HLCS_InstanceT* me = aligned_alloc(_Alignof(HLCS_InstanceT), sizeof(HLCS_InstanceT));
+    if (me == NULL)
+    {
+        return NULL;
+    }
+    memset(me, 0, sizeof(*me));
+
+    me->lockId = config->lockId;
+    me->publishToEventBus = config->publishToEventBus;
+    me->changeStateCallback = config->changeStateCallback;
+    me->selfTestResultCallback = config->selfTestResultCallback;
+    me->callbackContext = config->callbackContext;
+    me->delivery = config->delivery;
+    me->notificationQueue = (config->delivery == HLCS_DELIVERY_QUEUE) ? config->notificationQueue : NULL;
+    me->taskOptions = (config->taskOptions != NULL) ? *config->taskOptions : DefaultTaskOptions;
+    snprintf(me->name, sizeof(me->name), "%s", (config->name != NULL) ? config->name : "HLCS");
+    snprintf(me->queueName, sizeof(me->queueName), "%s queue", me->name);
+    //the dispatcher thread, kept apart from the service thread in traces
+    snprintf(me->notifierName, sizeof(me->notifierName), "%.8s notify", me->name);
+    me->operationTimeout = pdMS_TO_TICKS((config->operationTimeoutMs != 0) ? config->operationTimeoutMs :
+                                         HLCS_DEFAULT_OPERATION_TIMEOUT_MS);
+    me->lockRetryDelay = pdMS_TO_TICKS((config->lockRetryDelayMs != 0) ? config->lockRetryDelayMs :
+                                       HLCS_DEFAULT_LOCK_RETRY_DELAY_MS);
+    atomic_init(&me->lockState, HLCS_LOCK_STATE_UNKNOWN);
+    atomic_init(&me->exitThread, false);
+    atomic_init(&me->operationsInFlight, 0);
+    atomic_init(&me->operationState, HLCS_OPERATION_IDLE);
+    atomic_init(&me->statusSequence, 0);
+    for (size_t i = 0; i < HLCS_STATUS_WORDS; ++i)
+    {
+        atomic_init(&me->statusWords[i], 0);
+    }
+    me->deferredState = HLCS_LOCK_STATE_UNKNOWN;
+
+    me->eventQueue = xQueueCreateWithLanes(HLCS_LANE_COUNT, LaneDepths, sizeof(HLCS_EventTypeT));
+    if (me->eventQueue == NULL)
+    {
+        free(me);
+        return NULL;
+    }
+    vQueueEnableStats(me->eventQueue, true);
+
+    //the requests are idempotent: only the most recent lock or unlock
+    //request matters, and a self test already pending covers a new
+    //request. The latest lock request may thereby overtake a pending
+    //self test request, which is harmless, as history is restored.
+    bool ok = xQueueSetCoalescing(me->eventQueue, SIG_REQUEST_LOCKED,
+                                  QUEUE_COALESCE_LAST_VALUE_WINS, LockRequestCoalesceClass);
+    ok = ok && xQueueSetCoalescing(me->eventQueue, SIG_REQUEST_UNLOCKED,
+                                   QUEUE_COALESCE_LAST_VALUE_WINS, LockRequestCoalesceClass);
+    ok = ok && xQueueSetCoalescing(me->eventQueue, SIG_REQUEST_SELF_TEST,
+                                   QUEUE_COALESCE_DROP_IF_PENDING, SelfTestRequestCoalesceClass);
+    assert(ok);
+    (void)ok;
+
+    if (xTimerServiceIsRunning() && !HLCS_CreateTimers(me))
+    {
+        HLCS_DeleteTimers(me);
+        vQueueDelete(me->eventQueue);
+        free(me);
+        return NULL;
+    }
+
+    vTraceSetObjectName(me->eventQueue, me->queueName);
+    vTraceSetObjectName(&me->stateMachine, me->name);
+    return me;
+}
+
+void HLCS_Delete(HLCS_Handle handle)
+{
+    HLCS_InstanceT* me = handle;
+    if (me == NULL)
+    {
+        return;
+    }
+
+    if (me->scheduledObject != NULL)
+    {
+        vSchedulerUnregister(me->scheduledObject);
+        me->scheduledObject = NULL;
+    }
+
+    me->exitThread = true;
+    HLCS_PushLaneEvent(me, SIG_REQUEST_THREAD_EXIT, 0, HLCS_LANE_EXIT);
+    vTaskDelete(me->thread);
+    HLCS_DeleteTimers(me);
+
+    //abandon any operation in progress, so a late completion only
+    //touches the atomics, then let the driver return from a completion
+    //callback in progress.
+    HLCS_OperationStateT running = HLCS_OPERATION_RUNNING;
+    bool abandoned = atomic_compare_exchange_strong(&me->operationState, &running, HLCS_OPERATION_ABANDONED);
+    for (TickType_t waited = 0; (atomic_load(&me->operationsInFlight) > 0) && (waited < me->operationTimeout); ++waited)
+    {
+        vTaskDelay(1);
+    }
+
+    HLCS_StopDispatcher(me);
+    if (atomic_load(&me->operationsInFlight) > 0)
+    {
+        FAUX_LOG_ERROR("%s deleted with a driver operation in progress, leaking it", me->name);
+        vLogFlush();
+        if (abandoned)
+        {
+            vQueueDelete(me->eventQueue);
+        }
+        return;
+    }
+
+    vQueueDelete(me->eventQueue);
+    free(me);
+}
+
+/**
+ * @brief HLCS_CreateTimers() - the operation timeout overtakes pending
+ *        requests, as a completion would, a lock retry queues behind them.
+ */
+bool HLCS_CreateTimers(HLCS_InstanceT* me)
+{
+    HLCS_EventTypeT timeout = { .signal = SIG_OPERATION_TIMEOUT, .value = 0 };
+    me->operationTimer = xTimerCreate(me->name, me->operationTimeout, false, me->eventQueue,
+                                      &timeout, sizeof(timeout));
+    HLCS_EventTypeT retry = { .signal = SIG_RETRY_LOCK, .value = 0 };
+    me->lockRetryTimer = xTimerCreate(me->name, me->lockRetryDelay, false, me->eventQueue,
+                                      &retry, sizeof(retry));
+    return (me->operationTimer != NULL) && (me->lockRetryTimer != NULL) &&
+           xTimerSetQueueLane(me->operationTimer, HLCS_LANE_COMPLETIONS);
+}
+
+void HLCS_DeleteTimers(HLCS_InstanceT* me)
+{
+    vTimerDelete(me->operationTimer);
+    vTimerDelete(me->lockRetryTimer);
+    me->operationTimer = NULL;
+    me->lockRetryTimer = NULL;
+}
+
+void HLCS_InstanceStart(HLCS_Handle handle, ExecutionOptionT option)
+{
+    HLCS_InstanceT* me = handle;
+    assert(me != NULL);
+    assert(me->stateMachine.table == NULL);
+    assert(me->thread == NULL);
+    assert(me->scheduledObject == NULL);
+
+    //the initial transition already notifies the observers
+    if (me->delivery == HLCS_DELIVERY_DISPATCHER)
+    {
+        HLCS_StartDispatcher(me);
+    }
+
+    if (EXECUTION_OPTION_NORMAL == option)
+    {
+        bool ok = xTaskCreateWithParameters(HLCS_Task, me->name, TaskStackDepth, me, &me->taskOptions, &me->thread);
+        assert(ok == true);
+        (void)ok;
+    }
+    else if (EXECUTION_OPTION_SHARED_SCHEDULER == option)
+    {
+        //the initial transition executes in the caller's context,
+        //all later events execute on the scheduler's workers.
+        assert(xSchedulerIsRunning());
+        HLCS_SmInitialize(me);
+        me->scheduledObject = xSchedulerRegister(me->eventQueue, HLCS_Dispatch, me);
+        assert(me->scheduledObject != NULL);
+    }
+    else
+    {
+        HLCS_SmInitialize(me);
+    }
+}
+
+HLCS_LockStateT HLCS_InstanceGetState(HLCS_Handle handle)
+{
+    return atomic_load(&handle->lockState);
+}
+
+bool HLCS_InstanceGetStatusSnapshot(HLCS_Handle handle, HLCS_StatusT* status)
+{
+    if ((handle == NULL) || (status == NULL))
     {
         return false;
     }
 
+    //retry until no publication overlapped the copy
+    uint64_t words[HLCS_STATUS_WORDS];
+    while (true)
+    {
+        uint32_t before = atomic_load_explicit(&handle->statusSequence, memory_order_acquire);
+        if ((before & 1U) != 0)
+        {
+            vTaskYield();
+            continue;
+        }
+
+        for (size_t i = 0; i < HLCS_STATUS_WORDS; ++i)
+        {
+            words[i] = atomic_load_explicit(&handle->statusWords[i], memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if (atomic_load_explicit(&handle->statusSequence, memory_order_relaxed) == before)
+        {
+            break;
+        }
+    }
+
+    memcpy(status, words, sizeof(*status));
+    return true;
+}
+
+uint32_t HLCS_InstanceGetLockId(HLCS_Handle handle)
+{
+    return handle->lockId;
+}
+
+bool HLCS_InstanceGetQueueStats(HLCS_Handle handle, QueueStatsT* stats)
+{
+    return (handle != NULL) && xQueueGetStats(handle->eventQueue, stats);
+}
+
+void HLCS_InstanceRequestLockedAsync(HLCS_Handle handle)
+{
+    HLCS_PushEvent(handle, SIG_REQUEST_LOCKED);
+}
+
+void HLCS_InstanceRequestUnlockedAsync(HLCS_Handle handle)
+{
+    HLCS_PushEvent(handle, SIG_REQUEST_UNLOCKED);
+}
+
+void HLCS_InstanceRequestSelfTestAsync(HLCS_Handle handle)
+{
+    HLCS_PushEvent(handle, SIG_REQUEST_SELF_TEST);
+}
+
+bool HLCS_InstanceProcessOneEvent(HLCS_Handle handle, ExecutionOptionT option)
+{
+    HLCS_InstanceT* me = handle;
+
+    //only the internal thread waits for work.
+    TickType_t ticksToWait = (EXECUTION_OPTION_NORMAL == option) ? portMAX_DELAY : 0;
+
     HLCS_EventTypeT event;
-    bool ok = xQueueReceive(s_eventQueue, &event);
+    bool ok = xQueueReceiveTimed(me->eventQueue, &event, ticksToWait);
     if (!ok)
     {
         return false;
     }
 
-    if (event.signal == SIG_REQUEST_THREAD_EXIT)
+    return HLCS_ProcessReceivedEvent(me, &event);
+}
+
+size_t HLCS_InstanceProcessEventBatch(HLCS_Handle handle, ExecutionOptionT option)
+{
+    HLCS_InstanceT* me = handle;
+    TickType_t ticksToWait = (EXECUTION_OPTION_NORMAL == option) ? portMAX_DELAY : 0;
+
+    //a full queue, all lanes, drains in a single receive
+    HLCS_EventTypeT events[HLCS_QUEUE_CAPACITY];
+    size_t count = 0;
+    bool ok = xQueueReceiveBatchTimed(me->eventQueue, events, HLCS_QUEUE_CAPACITY, &count, ticksToWait);
+    if (!ok)
+    {
+        return 0;
+    }
+
+    size_t processed = 0;
+    for (size_t i = 0; i < count; ++i)
     {
-        s_exitThread = true;
+        if (!HLCS_ProcessReceivedEvent(me, &events[i]))
+        {
+            break;
+        }
+        ++processed;
+
+        //an event posted to a higher lane, by the state machine itself or
+        //by the driver, must be handled before the remainder of the batch,
+        //exactly as it would have been had the batch remained in the queue.
+        while (HLCS_HasPriorityEvents(me))
+        {
+            if (!HLCS_InstanceProcessOneEvent(me, EXECUTION_OPTION_UNIT_TEST)) //never blocks
+            {
+                return processed;
+            }
+            ++processed;
+        }
+    }
+
+    return processed;
+}
+
+bool HLCS_ProcessReceivedEvent(HLCS_InstanceT* me, const HLCS_EventTypeT* event)
+{
+    if (event->signal == SIG_REQUEST_THREAD_EXIT)
+    {
+        me->exitThread = true;
         return false;
     }
 
-    HLCS_SmProcess(&event);
+    if (event->signal == SIG_OPERATION_TIMEOUT)
+    {
+        HLCS_OnOperationTimeout(me);
+        return true;
+    }
+
+    if (HLCS_IsCompletion(event->signal))
+    {
+        xTimerStop(me->operationTimer);
+    }
+
+    HLCS_SmProcess(me, event);
     return true;
 }
 
-void HLCS_PushEvent(SignalT sig)
+bool HLCS_IsCompletion(SignalT sig)
+{
+    switch (sig)
+    {
+    case SIG_LOCK_DONE:
+    case SIG_LOCK_FAILED:
+    case SIG_UNLOCK_DONE:
+    case SIG_UNLOCK_FAILED:
+    case SIG_SELF_TEST_DONE:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void HLCS_PushEvent(HLCS_InstanceT* me, SignalT sig)
 {
     HLCS_EventTypeT event =
       {
         .signal = sig
       };
-    bool ok = xQueueSendToBack(s_eventQueue, &event);
+    //a full queue applies backpressure to the caller for a
+    //short while, rather than immediately failing.
+    bool ok = xQueueSendToBackTimed(me->eventQueue, &event, PushEventTimeout);
     if (!ok)
     {
-        fprintf(stderr, "HLCS queue send failed for sig %d!\n", sig);
+        HLCS_ReportSendFailure(me, sig, HLCS_LANE_REQUESTS);
         assert(false);
     }
 }
 
-void HLCS_PushUrgentEvent(SignalT sig)
+void HLCS_PushLaneEvent(HLCS_InstanceT* me, SignalT sig, int32_t value, HLCS_LaneT lane)
 {
     HLCS_EventTypeT event =
       {
-        .signal = sig
+        .signal = sig,
+        .value = value
       };
-    bool ok = xQueueSendToFront(s_eventQueue, &event);
+    bool ok = xQueueSendToLane(me->eventQueue, &event, lane);
     if (!ok)
     {
-        fprintf(stderr, "HLCS queue send failed for sig %d!\n", sig);
+        HLCS_ReportSendFailure(me, sig, lane);
         assert(false);
     }
 }
 
-void HLCS_SmProcess(const HLCS_EventTypeT * event)
+bool HLCS_HasPriorityEvents(HLCS_InstanceT* me)
 {
-    void* rtn = s_currentState(event);
-    if (rtn != (void*)s_currentState)
+    return xQueueHasItemsAboveLane(me->eventQueue, HLCS_LANE_REQUESTS);
+}
+
+/**
+ * @brief HLCS_ReportSendFailure() - the depth and capacity of the lane
+ *        which rejected the send, then the totals of all lanes.
+ */
+void HLCS_ReportSendFailure(HLCS_InstanceT* me, SignalT sig, HLCS_LaneT lane)
+{
+    QueueStatsT stats;
+    if (!xQueueGetStats(me->eventQueue, &stats))
     {
-        s_currentState(&ExitEvent);
-        s_currentState = rtn;
-        s_currentState(&EnterEvent);
+        FAUX_LOG_ERROR("%s queue send failed for sig %d!", me->name, sig);
+        vLogFlush();
+        return;
     }
+
+    FAUX_LOG_ERROR("%s queue send failed for sig %d! lane %d depth %zu of %zu, "
+                   "all lanes depth %zu of %zu, high water %zu, "
+                   "full rejections %llu, coalesced %llu, posts %llu (urgent %llu), receives %llu, "
+                   "p99 latency %llu ns",
+            me->name, sig, lane, uxQueueLaneMessagesWaiting(me->eventQueue, lane), LaneDepths[lane],
+            stats.currentDepth, (size_t)HLCS_QUEUE_CAPACITY, stats.highWaterMark,
+            (unsigned long long)stats.fullRejections,
+            (unsigned long long)stats.coalescedPosts,
+            (unsigned long long)(stats.normalPosts + stats.urgentPosts),
+            (unsigned long long)stats.urgentPosts,
+            (unsigned long long)stats.receives,
+            (unsigned long long)uxQueueStatsLatencyPercentileNs(&stats, 99.0));
+
+    //the caller asserts next, so write the message out now
+    vLogFlush();
 }
 
-void HLCS_NotifyChangedState(HLCS_LockStateT state)
+void HLCS_SmProcess(HLCS_InstanceT* me, const HLCS_EventTypeT * event)
 {
-    s_lockState = state;
-    if (s_stateChangedCallback)
+    uint8_t source = CmsHsm_State(&me->stateMachine);
+    vTraceRecord(TRACE_EVENT_DISPATCH_BEGIN, &me->stateMachine, event->signal, 0, 0);
+    me->eventValue = event->value;
+
+    bool ok = CmsHsm_Dispatch(&me->stateMachine, event->signal);
+    assert(ok);
+    (void)ok;
+
+    uint8_t target = CmsHsm_State(&me->stateMachine);
+    if (target != source)
     {
-        s_stateChangedCallback(s_lockState);
+        vTraceRecord(TRACE_EVENT_STATE_TRANSITION, &me->stateMachine, source, target, event->signal);
+        ++me->status.transitions;
     }
+    vTraceRecord(TRACE_EVENT_DISPATCH_END, &me->stateMachine, event->signal, target, 0);
+
+    bool driverFailed = (event->signal == SIG_LOCK_FAILED) || (event->signal == SIG_UNLOCK_FAILED);
+    me->status.driverFailures += driverFailed ? 1 : 0;
+    ++me->status.eventsProcessed;
+    HLCS_PublishStatus(me);
 }
 
-void HLCS_NotifySelfTestResult(HLCS_SelfTestResultT result)
+void HLCS_NotifyChangedState(HLCS_InstanceT* me, HLCS_LockStateT state)
 {
-    if (s_selfTestResultCallback)
+    me->lockState = state;
+    vTraceRecord(TRACE_EVENT_CALLBACK, &me->stateMachine, SEB_SIG_LOCK_STATE_CHANGED, (uint32_t)state, 0);
+    HLCS_DeliverCallback(me, HLCS_NOTIFICATION_STATE_CHANGED, (int32_t)state);
+
+    if (me->publishToEventBus)
     {
-        s_selfTestResultCallback(result);
+        SEB_Publish(SEB_SIG_LOCK_STATE_CHANGED, (int32_t)state);
     }
 }
 
-void  HLCS_SmInitialize()
+void HLCS_NotifySelfTestResult(HLCS_InstanceT* me, HLCS_SelfTestResultT result)
 {
-    //get the initial desired state
-    s_currentState = HLCS_SmInitialPseudoState;
-    s_currentState = s_currentState(&EnterEvent);
+    me->status.lastSelfTestResult = result;
+    ++me->status.selfTestCount;
+    me->status.selfTestFailures += (result != HLCS_SELF_TEST_RESULT_PASS) ? 1 : 0;
+    vTraceRecord(TRACE_EVENT_CALLBACK, &me->stateMachine, SEB_SIG_SELF_TEST_RESULT, (uint32_t)result, 0);
+    HLCS_DeliverCallback(me, HLCS_NOTIFICATION_SELF_TEST_RESULT, (int32_t)result);
 
-    //now enter the initial desired state
-    s_currentState(&EnterEvent);
+    if (me->publishToEventBus)
+    {
+        SEB_Publish(SEB_SIG_SELF_TEST_RESULT, (int32_t)result);
+    }
 }
 
-void* HLCS_SmInitialPseudoState(const HLCS_EventTypeT* const event)
+void HLCS_DeliverCallback(HLCS_InstanceT* me, HLCS_NotificationKindT kind, int32_t value)
 {
-    (void)event;
+    HLCS_NotificationT notification = { .kind = kind, .value = value, .handle = me };
+    if (me->notificationQueue == NULL)
+    {
+        HLCS_InvokeCallback(&notification);
+    }
+    else if (!xQueueSendToBack(me->notificationQueue, &notification))
+    {
+        //only a caller supplied queue, shared with other items, fills up
+        FAUX_LOG_WARNING("%s notification %u dropped, queue full", me->name, (unsigned)kind);
+    }
+}
 
-    HwLockCtrlInit();
-    return TransitionTo(HLCS_SmLocked);
+void HLCS_InvokeCallback(const HLCS_NotificationT* notification)
+{
+    HLCS_InstanceT* me = notification->handle;
+    if ((notification->kind == HLCS_NOTIFICATION_STATE_CHANGED) && me->changeStateCallback)
+    {
+        me->changeStateCallback(me->callbackContext, me, (HLCS_LockStateT)notification->value);
+    }
+    else if ((notification->kind == HLCS_NOTIFICATION_SELF_TEST_RESULT) && me->selfTestResultCallback)
+    {
+        me->selfTestResultCallback(me->callbackContext, me, (HLCS_SelfTestResultT)notification->value);
+    }
 }
 
-void* HLCS_SmLocked(const HLCS_EventTypeT* const event)
+bool HLCS_DeliverNotification(const HLCS_NotificationT* notification)
 {
-    StateRtn rtn;
-    switch (event->signal)
+    if ((notification == NULL) || (notification->handle == NULL) ||
+        (notification->kind > HLCS_NOTIFICATION_SELF_TEST_RESULT))
     {
-    case SM_ENTER:
-        HwLockCtrlLock();
-        HLCS_NotifyChangedState(HLCS_LOCK_STATE_LOCKED);
-        rtn = Handled();
-        break;
-    case SM_EXIT:
-        rtn = Handled();
-        s_stateHistory = HLCS_SmLocked;
-        break;
-    case SIG_REQUEST_LOCKED:
-        rtn = Handled();
-        break;
-    case SIG_REQUEST_UNLOCKED:
-        rtn = TransitionTo(HLCS_SmUnlocked);
-        break;
-    case SIG_REQUEST_SELF_TEST:
-        rtn = TransitionTo(HLCS_SmSelfTest);
-        break;
-    default:
-        rtn = Handled();
-        break;
+        return false;
+    }
+
+    HLCS_InvokeCallback(notification);
+    return true;
+}
+
+bool HLCS_SetNotificationCoalescing(QueueHandle_t queue)
+{
+    //only the latest state, and the latest self test result, matter
+    return (queue != NULL) &&
+           xQueueSetCoalescing(queue, HLCS_NOTIFICATION_STATE_CHANGED, QUEUE_COALESCE_LAST_VALUE_WINS, 0) &&
+           xQueueSetCoalescing(queue, HLCS_NOTIFICATION_SELF_TEST_RESULT, QUEUE_COALESCE_LAST_VALUE_WINS, 1);
+}
+
+void HLCS_StartDispatcher(HLCS_InstanceT* me)
+{
+    me->notificationQueue = xQueueCreate(NotificationQueueDepth, sizeof(HLCS_NotificationT));
+    bool ok = HLCS_SetNotificationCoalescing(me->notificationQueue);
+    ok = ok && xTaskCreateWithParameters(HLCS_DispatcherTask, me->notifierName, TaskStackDepth, me, NULL, &me->notifier);
+    assert(ok == true);
+    (void)ok;
+}
+
+void HLCS_StopDispatcher(HLCS_InstanceT* me)
+{
+    if (me->notifier == NULL)
+    {
+        return;
     }
 
-    return rtn;
+    //queued behind, and never coalesced with, the pending notifications
+    HLCS_NotificationT exit = { .kind = DispatcherExitKind, .value = 0, .handle = me };
+    bool ok = xQueueSendToBack(me->notificationQueue, &exit);
+    assert(ok);
+    (void)ok;
+    vTaskDelete(me->notifier);
+    vQueueDelete(me->notificationQueue);
+    me->notifier = NULL;
+    me->notificationQueue = NULL;
 }
 
-void* HLCS_SmUnlocked(const HLCS_EventTypeT* const event)
+void HLCS_DispatcherTask(void* parameters)
 {
-    StateRtn rtn;
-    switch (event->signal)
+    HLCS_InstanceT* me = parameters;
+    HLCS_NotificationT notification;
+    while (xQueueReceive(me->notificationQueue, &notification) && (notification.kind != DispatcherExitKind))
     {
-    case SM_ENTER:
-        rtn = Handled();
-        HwLockCtrlUnlock();
-        HLCS_NotifyChangedState(HLCS_LOCK_STATE_UNLOCKED);
-        break;
-    case SM_EXIT:
-        rtn = Handled();
-        s_stateHistory = HLCS_SmUnlocked;
-        break;
-    case SIG_REQUEST_LOCKED:
-        rtn = TransitionTo(HLCS_SmLocked);
-        break;
-    case SIG_REQUEST_UNLOCKED:
-        rtn = Handled();
+        HLCS_InvokeCallback(&notification);
+    }
+}
+
+void HLCS_SmInitialize(HLCS_InstanceT* me)
+{
+    CmsHsm_Initialize(&me->stateMachine, &HLCS_StateTable, StateMachineActions, me,
+                      HLCS_STATE_ACTIVE, HLCS_ACTION_INIT_DRIVER);
+    HLCS_PublishStatus(me);
+}
+
+/**
+ * @brief HLCS_PublishStatus() - a sequence lock, with the service as the
+ *        only writer: wait free for the service, and lock free for readers,
+ *        who retry should a publication overlap their copy.
+ */
+void HLCS_PublishStatus(HLCS_InstanceT* me)
+{
+    uint8_t state = CmsHsm_State(&me->stateMachine);
+    me->status.lockState = atomic_load(&me->lockState);
+    me->status.historyState = HLCS_HistoryState(me);
+    me->status.selfTestInProgress = (state == HLCS_STATE_SELF_TEST);
+    me->status.operationInProgress = (state == HLCS_STATE_LOCKING) || (state == HLCS_STATE_UNLOCKING) ||
+                                     (state == HLCS_STATE_SELF_TEST);
+    me->status.queueDepth = uxQueueMessagesWaiting(me->eventQueue);
+
+    uint64_t words[HLCS_STATUS_WORDS] = { 0 };
+    memcpy(words, &me->status, sizeof(me->status));
+
+    uint32_t sequence = atomic_load_explicit(&me->statusSequence, memory_order_relaxed);
+    atomic_store_explicit(&me->statusSequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    for (size_t i = 0; i < HLCS_STATUS_WORDS; ++i)
+    {
+        atomic_store_explicit(&me->statusWords[i], words[i], memory_order_relaxed);
+    }
+    atomic_store_explicit(&me->statusSequence, sequence + 2, memory_order_release);
+}
+
+/**
+ * @brief HLCS_HistoryState() - the lock mode the service is in, or,
+ *        during a self test, the one recorded as its history.
+ */
+HLCS_LockStateT HLCS_HistoryState(const HLCS_InstanceT* me)
+{
+    uint8_t state = CmsHsm_State(&me->stateMachine);
+    uint8_t mode = (state == HLCS_STATE_SELF_TEST) ? me->stateMachine.history[HLCS_STATE_ACTIVE] :
+                   me->stateMachine.table->states[state].parent;
+    if (mode == HLCS_STATE_LOCK_MODE)
+    {
+        return HLCS_LOCK_STATE_LOCKED;
+    }
+    return (mode == HLCS_STATE_UNLOCK_MODE) ? HLCS_LOCK_STATE_UNLOCKED : HLCS_LOCK_STATE_UNKNOWN;
+}
+
+void HLCS_ActionInitDriver(void* context)
+{
+    HLCS_InstanceT* me = context;
+    HwLockCtrlInitById(me->lockId);
+}
+
+void HLCS_ActionStartLock(void* context)
+{
+    HLCS_StartOperation(context, HW_LOCK_CTRL_OPERATION_LOCK);
+}
+
+void HLCS_ActionStartUnlock(void* context)
+{
+    HLCS_StartOperation(context, HW_LOCK_CTRL_OPERATION_UNLOCK);
+}
+
+void HLCS_ActionStartSelfTest(void* context)
+{
+    HLCS_StartOperation(context, HW_LOCK_CTRL_OPERATION_SELF_TEST);
+}
+
+void HLCS_ActionEnterLocked(void* context)
+{
+    HLCS_EnterLockState(context, HLCS_LOCK_STATE_LOCKED);
+}
+
+void HLCS_ActionEnterUnlocked(void* context)
+{
+    HLCS_EnterLockState(context, HLCS_LOCK_STATE_UNLOCKED);
+}
+
+void HLCS_ActionEnterFailed(void* context)
+{
+    HLCS_EnterLockState(context, HLCS_LOCK_STATE_UNKNOWN);
+}
+
+void HLCS_ActionEnterLockFailed(void* context)
+{
+    HLCS_InstanceT* me = context;
+    HLCS_EnterLockState(me, HLCS_LOCK_STATE_UNKNOWN);
+    if ((me->lockRetryTimer != NULL) && (me->lockRetries < HLCS_LOCK_RETRY_LIMIT))
+    {
+        ++me->lockRetries;
+        xTimerStart(me->lockRetryTimer);
+    }
+}
+
+void HLCS_ActionStopLockRetry(void* context)
+{
+    HLCS_InstanceT* me = context;
+    xTimerStop(me->lockRetryTimer);
+}
+
+void HLCS_ActionNotifySelfTestResult(void* context)
+{
+    HLCS_InstanceT* me = context;
+    HLCS_NotifySelfTestResult(me, (HLCS_SelfTestResultT)me->eventValue);
+}
+
+void HLCS_ActionDeferLock(void* context)
+{
+    HLCS_InstanceT* me = context;
+    me->deferredState = HLCS_LOCK_STATE_LOCKED;
+}
+
+void HLCS_ActionDeferUnlock(void* context)
+{
+    HLCS_InstanceT* me = context;
+    me->deferredState = HLCS_LOCK_STATE_UNLOCKED;
+}
+
+void HLCS_ActionDeferSelfTest(void* context)
+{
+    HLCS_InstanceT* me = context;
+    me->deferredSelfTest = true;
+}
+
+void HLCS_StartOperation(HLCS_InstanceT* me, HwLockCtrlOperationT operation)
+{
+    //the driver allows one operation per lock, and still owns the one which timed out
+    if (atomic_load(&me->operationState) == HLCS_OPERATION_ABANDONED)
+    {
+        FAUX_LOG_WARNING("%s driver busy, operation %d failed", me->name, (int)operation);
+        HLCS_PostFailure(me, operation);
+        return;
+    }
+
+    me->operation = operation;
+    atomic_store(&me->operationState, HLCS_OPERATION_RUNNING);
+    atomic_fetch_add(&me->operationsInFlight, 1);
+
+    bool started;
+    switch (operation)
+    {
+    case HW_LOCK_CTRL_OPERATION_LOCK:
+        started = HwLockCtrlLockAsync(me->lockId, HLCS_OnDriverCompletion, me);
         break;
-    case SIG_REQUEST_SELF_TEST:
-        rtn = TransitionTo(HLCS_SmSelfTest);
+    case HW_LOCK_CTRL_OPERATION_UNLOCK:
+        started = HwLockCtrlUnlockAsync(me->lockId, HLCS_OnDriverCompletion, me);
         break;
+    case HW_LOCK_CTRL_OPERATION_SELF_TEST: //purposeful fallthrough
     default:
-        rtn = Handled();
+        started = HwLockCtrlSelfTestAsync(me->lockId, HLCS_OnDriverCompletion, me);
         break;
     }
 
-    return rtn;
+    if (!started)
+    {
+        //no completion follows, complete as failed, rather than wait
+        //forever in an in progress state
+        atomic_store(&me->operationState, HLCS_OPERATION_IDLE);
+        atomic_fetch_sub(&me->operationsInFlight, 1);
+        HLCS_PostFailure(me, operation);
+        return;
+    }
+
+    //the completion may already be queued, it stops the timer once processed
+    if (me->operationTimer != NULL)
+    {
+        xTimerStart(me->operationTimer);
+    }
 }
 
-void* HLCS_SmSelfTest(const HLCS_EventTypeT* const event)
+/**
+ * @brief HLCS_OnDriverCompletion() - executes in the driver's context,
+ *        and only posts the completion to the service's own queue.
+ *        A completion of an operation which timed out is dropped.
+ */
+void HLCS_OnDriverCompletion(void* context, const HwLockCtrlCompletionT* completion)
 {
-    StateRtn rtn;
-    switch (event->signal)
+    HLCS_InstanceT* me = context;
+    HLCS_OperationStateT running = HLCS_OPERATION_RUNNING;
+    if (atomic_compare_exchange_strong(&me->operationState, &running, HLCS_OPERATION_IDLE))
     {
-    case SM_ENTER:
-        HLCS_PerformSelfTest();
-        rtn = Handled();
-        break;
-    case SIG_REQUEST_LOCKED:
-        rtn = TransitionTo(HLCS_SmLocked);
+        HLCS_PostCompletion(me, completion);
+    }
+    else
+    {
+        atomic_store(&me->operationState, HLCS_OPERATION_IDLE);
+    }
+
+    //last, once this is zero the instance may be deleted.
+    atomic_fetch_sub(&me->operationsInFlight, 1);
+}
+
+/**
+ * @brief HLCS_OnOperationTimeout() - unless the driver completed
+ *        meanwhile, abandon the operation, and complete it as failed.
+ */
+void HLCS_OnOperationTimeout(HLCS_InstanceT* me)
+{
+    HLCS_OperationStateT running = HLCS_OPERATION_RUNNING;
+    if (!atomic_compare_exchange_strong(&me->operationState, &running, HLCS_OPERATION_ABANDONED))
+    {
+        return; //the completion is queued already
+    }
+
+    FAUX_LOG_ERROR("%s driver operation %d timed out", me->name, (int)me->operation);
+    ++me->status.operationTimeouts;
+    HLCS_PostFailure(me, me->operation);
+}
+
+void HLCS_PostFailure(HLCS_InstanceT* me, HwLockCtrlOperationT operation)
+{
+    HwLockCtrlCompletionT failed =
+      {
+        .lockId = me->lockId,
+        .operation = operation,
+        .ok = false,
+        .selfTestResult = HW_LOCK_CTRL_SELF_TEST_FAILED_POWER
+      };
+    HLCS_PostCompletion(me, &failed);
+}
+
+void HLCS_PostCompletion(HLCS_InstanceT* me, const HwLockCtrlCompletionT* completion)
+{
+    SignalT sig;
+    int32_t value = 0;
+    switch (completion->operation)
+    {
+    case HW_LOCK_CTRL_OPERATION_LOCK:
+        sig = completion->ok ? SIG_LOCK_DONE : SIG_LOCK_FAILED;
         break;
-    case SIG_REQUEST_UNLOCKED:
-        rtn = TransitionTo(HLCS_SmUnlocked);
+    case HW_LOCK_CTRL_OPERATION_UNLOCK:
+        sig = completion->ok ? SIG_UNLOCK_DONE : SIG_UNLOCK_FAILED;
         break;
-
-    case SIG_REQUEST_SELF_TEST: //purposeful fallthrough
+    case HW_LOCK_CTRL_OPERATION_SELF_TEST: //purposeful fallthrough
     default:
-        rtn = Handled();
+        sig = SIG_SELF_TEST_DONE;
+        value = (completion->ok && (completion->selfTestResult == HW_LOCK_CTRL_SELF_TEST_PASSED)) ?
+                HLCS_SELF_TEST_RESULT_PASS : HLCS_SELF_TEST_RESULT_FAIL;
         break;
     }
 
-    return rtn;
+    HLCS_PushLaneEvent(me, sig, value, HLCS_LANE_COMPLETIONS);
 }
 
-void HLCS_PerformSelfTest()
+/**
+ * @brief HLCS_EnterLockState() - the driver completed locking or
+ *        unlocking: notify, then replay any request deferred meanwhile.
+ *        A failed operation enters HLCS_LOCK_STATE_UNKNOWN, and is
+ *        not counted as a lock or unlock.
+ */
+void HLCS_EnterLockState(HLCS_InstanceT* me, HLCS_LockStateT state)
 {
-    HwLockCtrlSelfTestResultT result;
-    bool ok = HwLockCtrlSelfTest(&result);
-    if (ok && (result == HW_LOCK_CTRL_SELF_TEST_PASSED))
+    if (state == HLCS_LOCK_STATE_LOCKED)
     {
-        HLCS_NotifySelfTestResult(HLCS_SELF_TEST_RESULT_PASS);
+        ++me->status.lockCount;
+        me->lockRetries = 0;
     }
-    else
+    else if (state == HLCS_LOCK_STATE_UNLOCKED)
     {
-        HLCS_NotifySelfTestResult(HLCS_SELF_TEST_RESULT_FAIL);
+        ++me->status.unlockCount;
+        me->lockRetries = 0;
     }
+    HLCS_NotifyChangedState(me, state);
 
-    //remind self to transition back to
-    //history per this service's requirements
-    //note the use of "PostUrgent" as per:
-    //
-    // https://covemountainsoftware.com/2020/03/08/uml-statechart-handling-errors-when-entering-a-state/
-    //
-    if (s_stateHistory == HLCS_SmUnlocked)
+    //deferred requests coalesce only within their own lane, so a replay
+    //never replaces a newer lock request still waiting in the requests lane.
+    if ((me->deferredState != HLCS_LOCK_STATE_UNKNOWN) && (me->deferredState != state))
     {
-        HLCS_PushUrgentEvent(SIG_REQUEST_UNLOCKED);
+        SignalT sig = (me->deferredState == HLCS_LOCK_STATE_LOCKED) ? SIG_REQUEST_LOCKED : SIG_REQUEST_UNLOCKED;
+        HLCS_PushLaneEvent(me, sig, 0, HLCS_LANE_DEFERRED);
     }
-    else
+    me->deferredState = HLCS_LOCK_STATE_UNKNOWN;
+
+    if (me->deferredSelfTest)
     {
-        HLCS_PushUrgentEvent(SIG_REQUEST_LOCKED);
+        me->deferredSelfTest = false;
+        HLCS_PushLaneEvent(me, SIG_REQUEST_SELF_TEST, 0, HLCS_LANE_DEFERRED);
     }
 }
 
-void HLCS_Task(void)
+bool HLCS_Dispatch(void* context)
+{
+    return HLCS_InstanceProcessOneEvent(context, EXECUTION_OPTION_SHARED_SCHEDULER);
+}
+
+void HLCS_Task(void* parameters)
 {
-    HLCS_SmInitialize();
-    while (!s_exitThread)
+    HLCS_InstanceT* me = parameters;
+    HLCS_SmInitialize(me);
+    while (!me->exitThread)
     {
-        HLCS_ProcessOneEvent(EXECUTION_OPTION_NORMAL);
+        HLCS_InstanceProcessEventBatch(me, EXECUTION_OPTION_NORMAL);
     }
 }
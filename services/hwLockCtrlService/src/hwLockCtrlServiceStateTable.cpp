@@ -0,0 +1,125 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "hwLockCtrlServiceStateTable.h"
+#include "cmsHierarchicalStateMachine.hpp"
+
+namespace
+{
+
+using HLCS_Table = cms::HsmTable<HLCS_STATE_COUNT, HLCS_SM_SIGNAL_COUNT>;
+
+constexpr HLCS_Table BuildStateTable()
+{
+    HLCS_Table table;
+
+    //lock requests are handled once, by the active superstate, and
+    //its shallow history remembers whether the lock or unlock mode
+    //was last active when a self test preempted it. Each mode first
+    //waits for the driver to complete its operation.
+    table.Substate(HLCS_STATE_LOCK_MODE, HLCS_STATE_ACTIVE)
+         .Substate(HLCS_STATE_UNLOCK_MODE, HLCS_STATE_ACTIVE)
+         .Substate(HLCS_STATE_LOCKING, HLCS_STATE_LOCK_MODE)
+         .Substate(HLCS_STATE_LOCKED, HLCS_STATE_LOCK_MODE)
+         .Substate(HLCS_STATE_LOCK_FAILED, HLCS_STATE_LOCK_MODE)
+         .Substate(HLCS_STATE_UNLOCKING, HLCS_STATE_UNLOCK_MODE)
+         .Substate(HLCS_STATE_UNLOCKED, HLCS_STATE_UNLOCK_MODE)
+         .Substate(HLCS_STATE_UNLOCK_FAILED, HLCS_STATE_UNLOCK_MODE)
+         .Initial(HLCS_STATE_ACTIVE, HLCS_STATE_LOCK_MODE)
+         .Initial(HLCS_STATE_LOCK_MODE, HLCS_STATE_LOCKING)
+         .Initial(HLCS_STATE_UNLOCK_MODE, HLCS_STATE_UNLOCKING)
+         .History(HLCS_STATE_ACTIVE, CMS_HSM_HISTORY_SHALLOW);
+
+    table.Transition(HLCS_STATE_ACTIVE, SIG_REQUEST_LOCKED, HLCS_STATE_LOCK_MODE)
+         .Transition(HLCS_STATE_ACTIVE, SIG_REQUEST_UNLOCKED, HLCS_STATE_UNLOCK_MODE)
+         .Transition(HLCS_STATE_ACTIVE, SIG_REQUEST_SELF_TEST, HLCS_STATE_SELF_TEST)
+         .Ignore(HLCS_STATE_ACTIVE, SIG_LOCK_DONE)
+         .Ignore(HLCS_STATE_ACTIVE, SIG_UNLOCK_DONE)
+         .Ignore(HLCS_STATE_ACTIVE, SIG_SELF_TEST_DONE)
+         .Ignore(HLCS_STATE_ACTIVE, SIG_LOCK_FAILED)
+         .Ignore(HLCS_STATE_ACTIVE, SIG_UNLOCK_FAILED)
+         .Ignore(HLCS_STATE_ACTIVE, SIG_RETRY_LOCK);
+
+    table.Ignore(HLCS_STATE_LOCK_MODE, SIG_REQUEST_LOCKED);
+
+    table.OnEntry(HLCS_STATE_LOCKING, HLCS_ACTION_START_LOCK)
+         .Transition(HLCS_STATE_LOCKING, SIG_LOCK_DONE, HLCS_STATE_LOCKED)
+         .Transition(HLCS_STATE_LOCKING, SIG_LOCK_FAILED, HLCS_STATE_LOCK_FAILED);
+
+    table.OnEntry(HLCS_STATE_LOCKED, HLCS_ACTION_ENTER_LOCKED);
+
+    //a failed operation leaves the lock state unknown, a new request
+    //of the same mode tries again. A self test returns to the mode's
+    //history, so it too tries again. A failed lock is also retried
+    //after a delay, a few times.
+    table.OnEntry(HLCS_STATE_LOCK_FAILED, HLCS_ACTION_ENTER_LOCK_FAILED)
+         .OnExit(HLCS_STATE_LOCK_FAILED, HLCS_ACTION_STOP_LOCK_RETRY)
+         .Transition(HLCS_STATE_LOCK_FAILED, SIG_REQUEST_LOCKED, HLCS_STATE_LOCKING)
+         .Transition(HLCS_STATE_LOCK_FAILED, SIG_RETRY_LOCK, HLCS_STATE_LOCKING);
+
+    table.Ignore(HLCS_STATE_UNLOCK_MODE, SIG_REQUEST_UNLOCKED);
+
+    table.OnEntry(HLCS_STATE_UNLOCKING, HLCS_ACTION_START_UNLOCK)
+         .Transition(HLCS_STATE_UNLOCKING, SIG_UNLOCK_DONE, HLCS_STATE_UNLOCKED)
+         .Transition(HLCS_STATE_UNLOCKING, SIG_UNLOCK_FAILED, HLCS_STATE_UNLOCK_FAILED);
+
+    table.OnEntry(HLCS_STATE_UNLOCKED, HLCS_ACTION_ENTER_UNLOCKED);
+
+    table.OnEntry(HLCS_STATE_UNLOCK_FAILED, HLCS_ACTION_ENTER_FAILED)
+         .Transition(HLCS_STATE_UNLOCK_FAILED, SIG_REQUEST_UNLOCKED, HLCS_STATE_UNLOCKING);
+
+    //while the driver is busy, requests are deferred, the latest lock
+    //or unlock request and any self test request are replayed once
+    //the lock is locked or unlocked. A self test in progress covers
+    //a new self test request.
+    table.Internal(HLCS_STATE_LOCKING, SIG_REQUEST_LOCKED, HLCS_ACTION_DEFER_LOCK)
+         .Internal(HLCS_STATE_LOCKING, SIG_REQUEST_UNLOCKED, HLCS_ACTION_DEFER_UNLOCK)
+         .Internal(HLCS_STATE_LOCKING, SIG_REQUEST_SELF_TEST, HLCS_ACTION_DEFER_SELF_TEST)
+         .Internal(HLCS_STATE_UNLOCKING, SIG_REQUEST_LOCKED, HLCS_ACTION_DEFER_LOCK)
+         .Internal(HLCS_STATE_UNLOCKING, SIG_REQUEST_UNLOCKED, HLCS_ACTION_DEFER_UNLOCK)
+         .Internal(HLCS_STATE_UNLOCKING, SIG_REQUEST_SELF_TEST, HLCS_ACTION_DEFER_SELF_TEST)
+         .Internal(HLCS_STATE_SELF_TEST, SIG_REQUEST_LOCKED, HLCS_ACTION_DEFER_LOCK)
+         .Internal(HLCS_STATE_SELF_TEST, SIG_REQUEST_UNLOCKED, HLCS_ACTION_DEFER_UNLOCK)
+         .Ignore(HLCS_STATE_SELF_TEST, SIG_REQUEST_SELF_TEST);
+
+    //a self test leaves the lock locked, so return to history by
+    //locking or unlocking again.
+    table.OnEntry(HLCS_STATE_SELF_TEST, HLCS_ACTION_START_SELF_TEST)
+         .Ignore(HLCS_STATE_SELF_TEST, SIG_LOCK_DONE)
+         .Ignore(HLCS_STATE_SELF_TEST, SIG_UNLOCK_DONE)
+         .Ignore(HLCS_STATE_SELF_TEST, SIG_LOCK_FAILED)
+         .Ignore(HLCS_STATE_SELF_TEST, SIG_UNLOCK_FAILED)
+         .Ignore(HLCS_STATE_SELF_TEST, SIG_RETRY_LOCK)
+         .TransitionToHistory(HLCS_STATE_SELF_TEST, SIG_SELF_TEST_DONE, HLCS_STATE_ACTIVE,
+                              HLCS_ACTION_NOTIFY_SELF_TEST_RESULT);
+
+    return table.Compile();
+}
+
+constexpr HLCS_Table StateTable = BuildStateTable();
+static_assert(StateTable.IsComplete(), "every HLCS signal must be handled in every HLCS state");
+
+} // namespace
+
+extern "C" const CmsHsmTableT HLCS_StateTable = StateTable.View();
@@ -0,0 +1,73 @@
+//
+// Internal to the HwLockCtrlService: the service's signals, states
+// and actions, and its hierarchical state table. The table itself is
+// generated and verified at compile time in hwLockCtrlServiceStateTable.cpp.
+//
+
+#ifndef HWLOCKCTRLSERVICESTATETABLE_H
+#define HWLOCKCTRLSERVICESTATETABLE_H
+
+#include "cmsHierarchicalStateMachine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum Signal
+{
+    SIG_REQUEST_LOCKED = CMS_SM_BEGIN_USER_SIGNALS,
+    SIG_REQUEST_UNLOCKED,
+    SIG_REQUEST_SELF_TEST,
+    SIG_LOCK_DONE,          //driver completions, posted from the driver's context
+    SIG_UNLOCK_DONE,
+    SIG_SELF_TEST_DONE,     //the event value is the HLCS_SelfTestResultT
+    SIG_LOCK_FAILED,        //the driver failed to lock, or unlock, the lock
+    SIG_UNLOCK_FAILED,
+    SIG_RETRY_LOCK,         //posted by the lock retry timer
+    SIG_REQUEST_THREAD_EXIT, //handled outside of the state machine, as are the signals below
+    SIG_OPERATION_TIMEOUT    //the driver operation in progress did not complete in time
+} SignalT;
+
+#define HLCS_SM_SIGNAL_COUNT (SIG_REQUEST_THREAD_EXIT - CMS_SM_BEGIN_USER_SIGNALS)
+
+typedef enum HLCS_State
+{
+    HLCS_STATE_ACTIVE,      //superstate of lock and unlock modes, with shallow history
+    HLCS_STATE_LOCK_MODE,   //superstate of locking, then locked
+    HLCS_STATE_LOCKING,     //driver lock operation in progress
+    HLCS_STATE_LOCKED,
+    HLCS_STATE_LOCK_FAILED, //the lock state is unknown until the next request
+    HLCS_STATE_UNLOCK_MODE, //superstate of unlocking, then unlocked
+    HLCS_STATE_UNLOCKING,   //driver unlock operation in progress
+    HLCS_STATE_UNLOCKED,
+    HLCS_STATE_UNLOCK_FAILED,
+    HLCS_STATE_SELF_TEST,   //driver self test in progress
+    HLCS_STATE_COUNT
+} HLCS_StateT;
+
+typedef enum HLCS_Action
+{
+    HLCS_ACTION_NONE = CMS_SM_NO_ACTION,
+    HLCS_ACTION_INIT_DRIVER,
+    HLCS_ACTION_START_LOCK,
+    HLCS_ACTION_START_UNLOCK,
+    HLCS_ACTION_START_SELF_TEST,
+    HLCS_ACTION_ENTER_LOCKED,
+    HLCS_ACTION_ENTER_UNLOCKED,
+    HLCS_ACTION_ENTER_FAILED,
+    HLCS_ACTION_ENTER_LOCK_FAILED,
+    HLCS_ACTION_STOP_LOCK_RETRY,
+    HLCS_ACTION_NOTIFY_SELF_TEST_RESULT,
+    HLCS_ACTION_DEFER_LOCK,
+    HLCS_ACTION_DEFER_UNLOCK,
+    HLCS_ACTION_DEFER_SELF_TEST,
+    HLCS_ACTION_COUNT
+} HLCS_ActionT;
+
+extern const CmsHsmTableT HLCS_StateTable;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //HWLOCKCTRLSERVICESTATETABLE_H
@@ -25,6 +25,17 @@ SOFTWARE.
 #include "CppUTest/TestHarness.h"
 #include "CppUTestExt/MockSupport.h"
 #include "hwLockCtrl.h"
+#include "mockHwLockCtrl.h"
+#include "fauxScheduler.h"
+#include "fauxSimulation.h"
+#include "fauxTimer.h"
+#include "fauxTrace.h"
+#include "servicesEventBus.h"
+#include <atomic>
+#include <chrono>
+#include <pthread.h>
+#include <thread>
+#include <vector>
 
 static constexpr const char* HW_LOCK_CTRL_MOCK = "HwLockCtrl";
 static constexpr const char* CB_MOCK = "TestCb";
@@ -63,6 +74,8 @@ TEST_GROUP(HwLockCtrlServiceTests)
 
     void teardown() final
     {
+        MockHwLockCtrl_DeferCompletions(false);
+        MockHwLockCtrl_CompletePending();
         HLCS_Destroy(); //ensure we are stopped/clean/destroyed.
         mock().clear();
     }
@@ -77,8 +90,8 @@ TEST_GROUP(HwLockCtrlServiceTests)
 
     void StartServiceToLocked()
     {
-        mock(HW_LOCK_CTRL_MOCK).expectOneCall("Init");
-        mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock");
+        mock(HW_LOCK_CTRL_MOCK).expectOneCall("Init").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+        mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
         mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_LOCKED));
         HLCS_Start(EXECUTION_OPTION_UNIT_TEST);
         GiveProcessingTime();
@@ -88,7 +101,7 @@ TEST_GROUP(HwLockCtrlServiceTests)
 
     void TestUnlock()
     {
-        mock(HW_LOCK_CTRL_MOCK).expectOneCall("Unlock");
+        mock(HW_LOCK_CTRL_MOCK).expectOneCall("Unlock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
         mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_UNLOCKED));
         HLCS_RequestUnlockedAsync();
         GiveProcessingTime();
@@ -98,8 +111,8 @@ TEST_GROUP(HwLockCtrlServiceTests)
 
     void StartServiceToUnlocked()
     {
-        mock(HW_LOCK_CTRL_MOCK).expectOneCall("Init");
-        mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock");
+        mock(HW_LOCK_CTRL_MOCK).expectOneCall("Init").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+        mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
         mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_LOCKED));
         HLCS_Start(EXECUTION_OPTION_UNIT_TEST);
         GiveProcessingTime();
@@ -145,14 +158,61 @@ TEST(HwLockCtrlServiceTests, given_unlocked_when_another_unlock_request_then_ser
     mock().checkExpectations();
 }
 
+TEST(HwLockCtrlServiceTests, given_startup_when_the_driver_fails_to_lock_then_state_is_unknown_until_a_lock_request_succeeds)
+{
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Init").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID).andReturnValue(0);
+    mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_UNKNOWN));
+    HLCS_Start(EXECUTION_OPTION_UNIT_TEST);
+    GiveProcessingTime();
+    mock().checkExpectations();
+    CHECK_TRUE(HLCS_LOCK_STATE_UNKNOWN == HLCS_GetState());
+
+    HLCS_StatusT status;
+    CHECK_TRUE(HLCS_GetStatusSnapshot(&status));
+    CHECK_TRUE(HLCS_LOCK_STATE_UNKNOWN == status.lockState);
+    CHECK_FALSE(status.operationInProgress);
+    UNSIGNED_LONGS_EQUAL(0, status.lockCount);
+    UNSIGNED_LONGS_EQUAL(1, status.driverFailures);
+
+    //a lock request, ignored once locked, tries again
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+    mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_LOCKED));
+    HLCS_RequestLockedAsync();
+    GiveProcessingTime();
+    mock().checkExpectations();
+    CHECK_TRUE(HLCS_GetStatusSnapshot(&status));
+    CHECK_TRUE(HLCS_LOCK_STATE_LOCKED == status.lockState);
+    UNSIGNED_LONGS_EQUAL(1, status.lockCount);
+    UNSIGNED_LONGS_EQUAL(1, status.driverFailures);
+}
+
+TEST(HwLockCtrlServiceTests, given_locked_when_the_driver_fails_to_unlock_then_state_is_unknown_and_not_counted)
+{
+    StartServiceToLocked();
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Unlock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID).andReturnValue(0);
+    mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_UNKNOWN));
+    HLCS_RequestUnlockedAsync();
+    GiveProcessingTime();
+    mock().checkExpectations();
+    CHECK_TRUE(HLCS_LOCK_STATE_UNKNOWN == HLCS_GetState());
+
+    HLCS_StatusT status;
+    CHECK_TRUE(HLCS_GetStatusSnapshot(&status));
+    UNSIGNED_LONGS_EQUAL(0, status.unlockCount);
+    UNSIGNED_LONGS_EQUAL(1, status.driverFailures);
+
+    TestUnlock();
+}
+
 TEST(HwLockCtrlServiceTests, given_locked_when_selftest_request_then_service_performs_selftest_emits_results_and_returns_to_locked)
 {
     StartServiceToLocked();
 
     auto passed = HW_LOCK_CTRL_SELF_TEST_PASSED;
-    mock(HW_LOCK_CTRL_MOCK).expectOneCall("SelfTest").withOutputParameterReturning("outResult", &passed, sizeof(passed));
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("SelfTest").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID).withOutputParameterReturning("outResult", &passed, sizeof(passed));
     mock(CB_MOCK).expectOneCall("SelfTestResultCallback").withIntParameter("result", static_cast<int>(HLCS_SELF_TEST_RESULT_PASS));
-    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock");
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
     mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_LOCKED));
     HLCS_RequestSelfTestAsync();
     GiveProcessingTime();
@@ -164,9 +224,9 @@ TEST(HwLockCtrlServiceTests, given_unlocked_when_selftest_request_then_service_p
     StartServiceToUnlocked();
 
     auto passed = HW_LOCK_CTRL_SELF_TEST_PASSED;
-    mock(HW_LOCK_CTRL_MOCK).expectOneCall("SelfTest").withOutputParameterReturning("outResult", &passed, sizeof(passed));
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("SelfTest").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID).withOutputParameterReturning("outResult", &passed, sizeof(passed));
     mock(CB_MOCK).expectOneCall("SelfTestResultCallback").withIntParameter("result", static_cast<int>(HLCS_SELF_TEST_RESULT_PASS));
-    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Unlock");
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Unlock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
     mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_UNLOCKED));
     HLCS_RequestSelfTestAsync();
     GiveProcessingTime();
@@ -178,9 +238,9 @@ TEST(HwLockCtrlServiceTests,given_locked_when_selftest_request_which_fails_then_
     StartServiceToLocked();
 
     auto passed = HW_LOCK_CTRL_SELF_TEST_FAILED_POWER;
-    mock(HW_LOCK_CTRL_MOCK).expectOneCall("SelfTest").withOutputParameterReturning("outResult", &passed, sizeof(passed));
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("SelfTest").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID).withOutputParameterReturning("outResult", &passed, sizeof(passed));
     mock(CB_MOCK).expectOneCall("SelfTestResultCallback").withIntParameter("result", static_cast<int>(HLCS_SELF_TEST_RESULT_FAIL));
-    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock");
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
     mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_LOCKED));
     HLCS_RequestSelfTestAsync();
     GiveProcessingTime();
@@ -192,15 +252,268 @@ TEST(HwLockCtrlServiceTests, given_unlocked_when_selftest_request_which_fails_th
     StartServiceToUnlocked();
 
     auto passed = HW_LOCK_CTRL_SELF_TEST_FAILED_MOTOR;
-    mock(HW_LOCK_CTRL_MOCK).expectOneCall("SelfTest").withOutputParameterReturning("outResult", &passed, sizeof(passed));
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("SelfTest").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID).withOutputParameterReturning("outResult", &passed, sizeof(passed));
     mock(CB_MOCK).expectOneCall("SelfTestResultCallback").withIntParameter("result", static_cast<int>(HLCS_SELF_TEST_RESULT_FAIL));
-    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Unlock");
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Unlock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
     mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_UNLOCKED));
     HLCS_RequestSelfTestAsync();
     GiveProcessingTime();
     mock().checkExpectations();
 }
 
+TEST(HwLockCtrlServiceTests, given_locked_when_selftest_and_unlock_requests_processed_as_a_batch_then_history_is_restored_before_unlocking)
+{
+    StartServiceToLocked();
+
+    auto passed = HW_LOCK_CTRL_SELF_TEST_PASSED;
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("SelfTest").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID).withOutputParameterReturning("outResult", &passed, sizeof(passed));
+    mock(CB_MOCK).expectOneCall("SelfTestResultCallback").withIntParameter("result", static_cast<int>(HLCS_SELF_TEST_RESULT_PASS));
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+    mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_LOCKED));
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Unlock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+    mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_UNLOCKED));
+    HLCS_RequestSelfTestAsync();
+    HLCS_RequestUnlockedAsync();
+
+    //self test and its completion, which returns to history, the lock
+    //completion, then the unlock request and its completion.
+    UNSIGNED_LONGS_EQUAL(5, HLCS_ProcessEventBatch(EXECUTION_OPTION_UNIT_TEST));
+    UNSIGNED_LONGS_EQUAL(0, HLCS_ProcessEventBatch(EXECUTION_OPTION_UNIT_TEST));
+    mock().checkExpectations();
+    CHECK_TRUE(HLCS_LOCK_STATE_UNLOCKED == HLCS_GetState());
+}
+
+TEST(HwLockCtrlServiceTests, given_locked_when_request_storm_then_requests_coalesce_to_the_latest_and_a_single_self_test)
+{
+    StartServiceToLocked();
+
+    //far more requests than the queue depth, none block or fail
+    for (int i = 0; i < 100; ++i)
+    {
+        HLCS_RequestUnlockedAsync();
+        HLCS_RequestSelfTestAsync();
+        HLCS_RequestLockedAsync();
+    }
+    HLCS_RequestUnlockedAsync();
+
+    auto passed = HW_LOCK_CTRL_SELF_TEST_PASSED;
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Unlock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+    mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_UNLOCKED));
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("SelfTest").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID).withOutputParameterReturning("outResult", &passed, sizeof(passed));
+    mock(CB_MOCK).expectOneCall("SelfTestResultCallback").withIntParameter("result", static_cast<int>(HLCS_SELF_TEST_RESULT_PASS));
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Unlock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+    mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_UNLOCKED));
+
+    //the latest unlock request, the self test, then the return to
+    //history, each followed by the driver's completion.
+    UNSIGNED_LONGS_EQUAL(5, HLCS_ProcessEventBatch(EXECUTION_OPTION_UNIT_TEST));
+    UNSIGNED_LONGS_EQUAL(0, HLCS_ProcessEventBatch(EXECUTION_OPTION_UNIT_TEST));
+    mock().checkExpectations();
+    CHECK_TRUE(HLCS_LOCK_STATE_UNLOCKED == HLCS_GetState());
+}
+
+TEST(HwLockCtrlServiceTests, given_unlock_in_progress_when_requests_arrive_then_they_are_deferred_until_the_driver_completes)
+{
+    StartServiceToLocked();
+    MockHwLockCtrl_DeferCompletions(true);
+
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Unlock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+    HLCS_RequestUnlockedAsync();
+    GiveProcessingTime();
+    mock().checkExpectations();
+    CHECK_TRUE(HLCS_LOCK_STATE_LOCKED == HLCS_GetState());
+
+    //the busy service keeps accepting requests, without driver calls,
+    //keeping only the latest lock request and a single self test.
+    HLCS_RequestLockedAsync();
+    HLCS_RequestSelfTestAsync();
+    HLCS_RequestUnlockedAsync();
+    HLCS_RequestLockedAsync();
+    HLCS_RequestSelfTestAsync();
+    GiveProcessingTime();
+    mock().checkExpectations();
+
+    //unlocked, then the deferred lock request starts locking
+    mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_UNLOCKED));
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+    UNSIGNED_LONGS_EQUAL(1, MockHwLockCtrl_CompletePending());
+    GiveProcessingTime();
+    mock().checkExpectations();
+    CHECK_TRUE(HLCS_LOCK_STATE_UNLOCKED == HLCS_GetState());
+
+    //locked, then the deferred self test starts
+    auto passed = HW_LOCK_CTRL_SELF_TEST_PASSED;
+    mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_LOCKED));
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("SelfTest").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID).withOutputParameterReturning("outResult", &passed, sizeof(passed));
+    UNSIGNED_LONGS_EQUAL(1, MockHwLockCtrl_CompletePending());
+    GiveProcessingTime();
+    mock().checkExpectations();
+
+    //the result, then the return to history locks again
+    mock(CB_MOCK).expectOneCall("SelfTestResultCallback").withIntParameter("result", static_cast<int>(HLCS_SELF_TEST_RESULT_PASS));
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+    UNSIGNED_LONGS_EQUAL(1, MockHwLockCtrl_CompletePending());
+    GiveProcessingTime();
+    mock().checkExpectations();
+
+    mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_LOCKED));
+    UNSIGNED_LONGS_EQUAL(1, MockHwLockCtrl_CompletePending());
+    GiveProcessingTime();
+    mock().checkExpectations();
+    CHECK_TRUE(HLCS_LOCK_STATE_LOCKED == HLCS_GetState());
+}
+
+TEST(HwLockCtrlServiceTests, given_lock_in_progress_when_unlock_is_deferred_and_lock_is_queued_then_the_last_request_wins)
+{
+    StartServiceToUnlocked();
+    MockHwLockCtrl_DeferCompletions(true);
+
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+    HLCS_RequestLockedAsync();
+    GiveProcessingTime();
+    mock().checkExpectations();
+
+    //the unlock request is deferred, the lock request stays queued
+    HLCS_RequestUnlockedAsync();
+    GiveProcessingTime();
+    HLCS_RequestLockedAsync();
+
+    //locked, the replayed unlock request must not replace the queued
+    //lock request: unlocking starts, and the queued request is deferred.
+    mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_LOCKED));
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Unlock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+    UNSIGNED_LONGS_EQUAL(1, MockHwLockCtrl_CompletePending());
+    GiveProcessingTime();
+    mock().checkExpectations();
+
+    mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_UNLOCKED));
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+    UNSIGNED_LONGS_EQUAL(1, MockHwLockCtrl_CompletePending());
+    GiveProcessingTime();
+    mock().checkExpectations();
+
+    mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_LOCKED));
+    UNSIGNED_LONGS_EQUAL(1, MockHwLockCtrl_CompletePending());
+    GiveProcessingTime();
+    mock().checkExpectations();
+    CHECK_TRUE(HLCS_LOCK_STATE_LOCKED == HLCS_GetState());
+}
+
+TEST(HwLockCtrlServiceTests, given_unlocked_when_a_self_test_runs_then_the_status_snapshot_follows_it)
+{
+    HLCS_StatusT status;
+    CHECK_FALSE(HLCS_GetStatusSnapshot(nullptr));
+    StartServiceToUnlocked();
+    CHECK_TRUE(HLCS_GetStatusSnapshot(&status));
+    CHECK_TRUE(HLCS_LOCK_STATE_UNLOCKED == status.lockState);
+    CHECK_TRUE(HLCS_LOCK_STATE_UNLOCKED == status.historyState);
+    CHECK_FALSE(status.operationInProgress);
+    UNSIGNED_LONGS_EQUAL(1, status.lockCount);
+    UNSIGNED_LONGS_EQUAL(1, status.unlockCount);
+    UNSIGNED_LONGS_EQUAL(0, status.selfTestCount);
+    UNSIGNED_LONGS_EQUAL(0, status.queueDepth);
+    UNSIGNED_LONGS_EQUAL(3, status.eventsProcessed);
+
+    MockHwLockCtrl_DeferCompletions(true);
+    auto failed = HW_LOCK_CTRL_SELF_TEST_FAILED_MOTOR;
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("SelfTest").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID).withOutputParameterReturning("outResult", &failed, sizeof(failed));
+    HLCS_RequestSelfTestAsync();
+    GiveProcessingTime();
+    mock().checkExpectations();
+    CHECK_TRUE(HLCS_GetStatusSnapshot(&status));
+    CHECK_TRUE(status.selfTestInProgress);
+    CHECK_TRUE(status.operationInProgress);
+    CHECK_TRUE(HLCS_LOCK_STATE_UNLOCKED == status.historyState);
+
+    //the result, then the return to history unlocks again
+    mock(CB_MOCK).expectOneCall("SelfTestResultCallback").withIntParameter("result", static_cast<int>(HLCS_SELF_TEST_RESULT_FAIL));
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Unlock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+    UNSIGNED_LONGS_EQUAL(1, MockHwLockCtrl_CompletePending());
+    GiveProcessingTime();
+    mock().checkExpectations();
+    CHECK_TRUE(HLCS_GetStatusSnapshot(&status));
+    CHECK_FALSE(status.selfTestInProgress);
+    CHECK_TRUE(status.operationInProgress);
+    CHECK_TRUE(HLCS_SELF_TEST_RESULT_FAIL == status.lastSelfTestResult);
+    UNSIGNED_LONGS_EQUAL(1, status.selfTestCount);
+    UNSIGNED_LONGS_EQUAL(1, status.selfTestFailures);
+
+    mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_UNLOCKED));
+    UNSIGNED_LONGS_EQUAL(1, MockHwLockCtrl_CompletePending());
+    GiveProcessingTime();
+    mock().checkExpectations();
+    CHECK_TRUE(HLCS_GetStatusSnapshot(&status));
+    CHECK_FALSE(status.operationInProgress);
+    UNSIGNED_LONGS_EQUAL(2, status.unlockCount);
+    UNSIGNED_LONGS_EQUAL(0, status.driverFailures);
+    UNSIGNED_LONGS_EQUAL(6, status.eventsProcessed);
+}
+
+TEST(HwLockCtrlServiceTests, given_bus_subscriber_when_self_test_then_results_and_state_changes_are_published_to_its_queue)
+{
+    QueueHandle_t queue = xQueueCreate(4, sizeof(SEB_EventT));
+    SEB_SubscriberT subscriber = SEB_AddSubscriber(queue);
+    CHECK_TRUE(SEB_Subscribe(subscriber, SEB_SIG_LOCK_STATE_CHANGED));
+    CHECK_TRUE(SEB_Subscribe(subscriber, SEB_SIG_SELF_TEST_RESULT));
+
+    StartServiceToUnlocked();
+    auto passed = HW_LOCK_CTRL_SELF_TEST_PASSED;
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("SelfTest").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID).withOutputParameterReturning("outResult", &passed, sizeof(passed));
+    mock(CB_MOCK).expectOneCall("SelfTestResultCallback").withIntParameter("result", static_cast<int>(HLCS_SELF_TEST_RESULT_PASS));
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Unlock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+    mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_UNLOCKED));
+    HLCS_RequestSelfTestAsync();
+    GiveProcessingTime();
+    mock().checkExpectations();
+
+    const SEB_EventT expected[] = {
+      { SEB_SIG_LOCK_STATE_CHANGED, HLCS_LOCK_STATE_LOCKED },
+      { SEB_SIG_LOCK_STATE_CHANGED, HLCS_LOCK_STATE_UNLOCKED },
+      { SEB_SIG_SELF_TEST_RESULT, HLCS_SELF_TEST_RESULT_PASS },
+      { SEB_SIG_LOCK_STATE_CHANGED, HLCS_LOCK_STATE_UNLOCKED }
+    };
+    for (const auto& expectedEvent : expected)
+    {
+        SEB_EventT event = { 0, 0 };
+        CHECK_TRUE(xQueueReceiveTimed(queue, &event, 0));
+        UNSIGNED_LONGS_EQUAL(expectedEvent.signal, event.signal);
+        LONGS_EQUAL(expectedEvent.value, event.value);
+    }
+
+    SEB_RemoveSubscriber(subscriber);
+    vQueueDelete(queue);
+}
+
+TEST(HwLockCtrlServiceTests, given_tracing_enabled_when_unlock_request_then_dispatch_transition_and_callback_are_traced)
+{
+    StartServiceToLocked();
+    vTraceClear();
+    vTraceEnable(true);
+    TestUnlock();
+    vTraceEnable(false);
+
+    std::vector<TraceRecordT> records(TRACE_RING_RECORDS);
+    records.resize(uxTraceCollect(records.data(), records.size()));
+    vTraceClear();
+
+    std::vector<uint16_t> types;
+    for (const auto& record : records)
+    {
+        types.push_back(record.type);
+    }
+    //the unlock request starts the driver, which posts its completion,
+    //then the completion enters the unlocked state.
+    std::vector<uint16_t> expected = { TRACE_EVENT_QUEUE_POST, TRACE_EVENT_QUEUE_RECEIVE, TRACE_EVENT_DISPATCH_BEGIN,
+                                       TRACE_EVENT_QUEUE_POST, TRACE_EVENT_STATE_TRANSITION, TRACE_EVENT_DISPATCH_END,
+                                       TRACE_EVENT_QUEUE_RECEIVE, TRACE_EVENT_DISPATCH_BEGIN, TRACE_EVENT_CALLBACK,
+                                       TRACE_EVENT_STATE_TRANSITION, TRACE_EVENT_DISPATCH_END };
+    CHECK_TRUE(expected == types);
+    CHECK_EQUAL(records[0].object, records[1].object);
+    CHECK_EQUAL(records[0].object, records[3].object);
+    CHECK_EQUAL(records[2].object, records[4].object);
+    CHECK_EQUAL(records[2].object, records[8].object);
+}
+
 TEST(HwLockCtrlServiceTests, rapid_create_start_destroy_handles_real_thread_correctly)
 {
     //just make sure we don't see a crash or other hang or
@@ -212,3 +525,457 @@ TEST(HwLockCtrlServiceTests, rapid_create_start_destroy_handles_real_thread_corr
     HLCS_Start(EXECUTION_OPTION_NORMAL);
     HLCS_Destroy();
 }
+
+TEST(HwLockCtrlServiceTests, given_shared_scheduler_when_started_then_requests_are_processed_by_the_worker_pool)
+{
+    CHECK_TRUE(xSchedulerStart(2, nullptr));
+    mock().ignoreOtherCalls();
+    HLCS_Start(EXECUTION_OPTION_SHARED_SCHEDULER);
+
+    //the lock completion is processed by a worker
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((HLCS_GetState() != HLCS_LOCK_STATE_LOCKED) && (std::chrono::steady_clock::now() < deadline))
+    {
+        std::this_thread::yield();
+    }
+    CHECK_TRUE(HLCS_LOCK_STATE_LOCKED == HLCS_GetState());
+
+    HLCS_RequestUnlockedAsync();
+    while ((HLCS_GetState() != HLCS_LOCK_STATE_UNLOCKED) && (std::chrono::steady_clock::now() < deadline))
+    {
+        std::this_thread::yield();
+    }
+    CHECK_TRUE(HLCS_LOCK_STATE_UNLOCKED == HLCS_GetState());
+
+    HLCS_Destroy();
+    HLCS_Init();
+    vSchedulerStop();
+}
+
+TEST(HwLockCtrlServiceTests, given_simulation_when_requests_are_posted_then_they_are_processed_on_the_simulation_thread)
+{
+    CHECK_TRUE(xSimulationStart(1));
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Init").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+    mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_LOCKED));
+    HLCS_Start(EXECUTION_OPTION_SHARED_SCHEDULER);
+
+    auto passed = HW_LOCK_CTRL_SELF_TEST_PASSED;
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Unlock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+    mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_UNLOCKED));
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("SelfTest").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID).withOutputParameterReturning("outResult", &passed, sizeof(passed));
+    mock(CB_MOCK).expectOneCall("SelfTestResultCallback").withIntParameter("result", static_cast<int>(HLCS_SELF_TEST_RESULT_PASS));
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Unlock").withUnsignedIntParameter("lockId", HW_LOCK_CTRL_DEFAULT_LOCK_ID);
+    mock(CB_MOCK).expectOneCall("LockStateCallback").withIntParameter("state", static_cast<int>(HLCS_LOCK_STATE_UNLOCKED));
+    HLCS_RequestUnlockedAsync();
+    HLCS_RequestSelfTestAsync();
+    CHECK_EQUAL(6u, uxSimulationRunUntilIdle(SIZE_MAX));
+    mock().checkExpectations();
+    CHECK_TRUE(HLCS_LOCK_STATE_UNLOCKED == HLCS_GetState());
+
+    HLCS_Destroy();
+    vSimulationStop();
+    HLCS_Init();
+}
+
+struct InstanceObserver
+{
+    std::atomic<size_t> lockedCount{0};
+    std::atomic<size_t> unlockedCount{0};
+    std::atomic<size_t> selfTestCount{0};
+    std::atomic<HLCS_Handle> lastHandle{nullptr};
+    std::atomic<HLCS_LockStateT> lastState{HLCS_LOCK_STATE_UNKNOWN};
+    std::atomic<bool> blocked{false}; //while true, state callbacks block, as a slow observer
+    char threadName[16] = {};         //of the last state callback, written before its count
+};
+
+static void TestInstanceStateCallback(void* context, HLCS_Handle handle, HLCS_LockStateT state)
+{
+    auto observer = static_cast<InstanceObserver*>(context);
+    observer->lastHandle = handle;
+    observer->lastState = state;
+    pthread_getname_np(pthread_self(), observer->threadName, sizeof(observer->threadName));
+    ++((state == HLCS_LOCK_STATE_LOCKED) ? observer->lockedCount : observer->unlockedCount);
+    while (observer->blocked)
+    {
+        std::this_thread::yield();
+    }
+}
+
+static void TestInstanceSelfTestCallback(void* context, HLCS_Handle handle, HLCS_SelfTestResultT result)
+{
+    (void)result;
+    auto observer = static_cast<InstanceObserver*>(context);
+    observer->lastHandle = handle;
+    ++observer->selfTestCount;
+}
+
+TEST_GROUP(HwLockCtrlServiceInstanceTests)
+{
+    InstanceObserver mObserver;
+    std::vector<HLCS_Handle> mInstances;
+
+    void teardown() final
+    {
+        mObserver.blocked = false;
+        MockHwLockCtrl_DeferCompletions(false);
+        MockHwLockCtrl_CompletePending();
+        for (auto handle : mInstances)
+        {
+            HLCS_Delete(handle);
+        }
+        vTimerServiceStop();
+        mock().clear();
+    }
+
+    HLCS_Handle Create(uint32_t lockId, HLCS_DeliveryT delivery = HLCS_DELIVERY_INLINE,
+                       QueueHandle_t notificationQueue = nullptr, uint32_t operationTimeoutMs = 0)
+    {
+        HLCS_ConfigT config = {};
+        config.lockId = lockId;
+        config.operationTimeoutMs = operationTimeoutMs;
+        config.delivery = delivery;
+        config.notificationQueue = notificationQueue;
+        config.changeStateCallback = TestInstanceStateCallback;
+        config.selfTestResultCallback = TestInstanceSelfTestCallback;
+        config.callbackContext = &mObserver;
+        HLCS_Handle handle = HLCS_Create(&config);
+        mInstances.push_back(handle);
+        return handle;
+    }
+};
+
+TEST(HwLockCtrlServiceInstanceTests, given_two_instances_then_each_drives_its_own_lock_id)
+{
+    HLCS_Handle first = Create(7);
+    HLCS_Handle second = Create(42);
+    CHECK_TRUE((first != nullptr) && (second != nullptr));
+    UNSIGNED_LONGS_EQUAL(0, reinterpret_cast<uintptr_t>(first) % 64);
+    UNSIGNED_LONGS_EQUAL(42, HLCS_InstanceGetLockId(second));
+
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Init").withUnsignedIntParameter("lockId", 7);
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock").withUnsignedIntParameter("lockId", 7);
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Init").withUnsignedIntParameter("lockId", 42);
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock").withUnsignedIntParameter("lockId", 42);
+    HLCS_InstanceStart(first, EXECUTION_OPTION_UNIT_TEST);
+    HLCS_InstanceStart(second, EXECUTION_OPTION_UNIT_TEST);
+    UNSIGNED_LONGS_EQUAL(1, HLCS_InstanceProcessEventBatch(first, EXECUTION_OPTION_UNIT_TEST));
+    UNSIGNED_LONGS_EQUAL(1, HLCS_InstanceProcessEventBatch(second, EXECUTION_OPTION_UNIT_TEST));
+    mock().checkExpectations();
+
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Unlock").withUnsignedIntParameter("lockId", 42);
+    HLCS_InstanceRequestUnlockedAsync(second);
+    CHECK_FALSE(HLCS_InstanceProcessOneEvent(first, EXECUTION_OPTION_UNIT_TEST));
+    UNSIGNED_LONGS_EQUAL(2, HLCS_InstanceProcessEventBatch(second, EXECUTION_OPTION_UNIT_TEST));
+    mock().checkExpectations();
+
+    CHECK_TRUE(HLCS_LOCK_STATE_LOCKED == HLCS_InstanceGetState(first));
+    CHECK_TRUE(HLCS_LOCK_STATE_UNLOCKED == HLCS_InstanceGetState(second));
+    CHECK_TRUE(second == mObserver.lastHandle);
+    UNSIGNED_LONGS_EQUAL(2, mObserver.lockedCount);
+    UNSIGNED_LONGS_EQUAL(1, mObserver.unlockedCount);
+
+    QueueStatsT stats;
+    CHECK_FALSE(HLCS_InstanceGetQueueStats(nullptr, &stats));
+    CHECK_TRUE(HLCS_InstanceGetQueueStats(second, &stats));
+    UNSIGNED_LONGS_EQUAL(3, stats.receives);
+    UNSIGNED_LONGS_EQUAL(0, stats.currentDepth);
+}
+
+TEST(HwLockCtrlServiceInstanceTests, given_virtual_clock_when_a_completion_never_arrives_then_the_operation_times_out_and_the_late_completion_is_dropped)
+{
+    CHECK_TRUE(xTimerServiceStart(TIMER_CLOCK_VIRTUAL));
+    HLCS_Handle handle = Create(7, HLCS_DELIVERY_INLINE, nullptr, 50);
+    MockHwLockCtrl_DeferCompletions(true);
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Init").withUnsignedIntParameter("lockId", 7);
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock").withUnsignedIntParameter("lockId", 7);
+    HLCS_InstanceStart(handle, EXECUTION_OPTION_UNIT_TEST);
+    mock().checkExpectations();
+
+    vTimerAdvanceTicks(49);
+    CHECK_FALSE(HLCS_InstanceProcessOneEvent(handle, EXECUTION_OPTION_UNIT_TEST));
+    vTimerAdvanceTicks(1);
+    UNSIGNED_LONGS_EQUAL(2, HLCS_InstanceProcessEventBatch(handle, EXECUTION_OPTION_UNIT_TEST));
+    CHECK_TRUE(HLCS_LOCK_STATE_UNKNOWN == HLCS_InstanceGetState(handle));
+    CHECK_TRUE(HLCS_LOCK_STATE_UNKNOWN == mObserver.lastState);
+
+    HLCS_StatusT status;
+    CHECK_TRUE(HLCS_InstanceGetStatusSnapshot(handle, &status));
+    CHECK_FALSE(status.operationInProgress);
+    UNSIGNED_LONGS_EQUAL(1, status.operationTimeouts);
+    UNSIGNED_LONGS_EQUAL(1, status.driverFailures);
+    UNSIGNED_LONGS_EQUAL(0, status.lockCount);
+
+    //the driver still owns the operation, a new one fails without it
+    HLCS_InstanceRequestLockedAsync(handle);
+    UNSIGNED_LONGS_EQUAL(2, HLCS_InstanceProcessEventBatch(handle, EXECUTION_OPTION_UNIT_TEST));
+    mock().checkExpectations();
+    CHECK_TRUE(HLCS_LOCK_STATE_UNKNOWN == HLCS_InstanceGetState(handle));
+
+    //the late completion is dropped, then the driver is free again
+    UNSIGNED_LONGS_EQUAL(1, MockHwLockCtrl_CompletePending());
+    CHECK_FALSE(HLCS_InstanceProcessOneEvent(handle, EXECUTION_OPTION_UNIT_TEST));
+    MockHwLockCtrl_DeferCompletions(false);
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock").withUnsignedIntParameter("lockId", 7);
+    HLCS_InstanceRequestLockedAsync(handle);
+    UNSIGNED_LONGS_EQUAL(2, HLCS_InstanceProcessEventBatch(handle, EXECUTION_OPTION_UNIT_TEST));
+    mock().checkExpectations();
+    CHECK_TRUE(HLCS_LOCK_STATE_LOCKED == HLCS_InstanceGetState(handle));
+
+    //a completed operation stops its timer
+    vTimerAdvanceTicks(100);
+    CHECK_FALSE(HLCS_InstanceProcessOneEvent(handle, EXECUTION_OPTION_UNIT_TEST));
+    CHECK_TRUE(HLCS_InstanceGetStatusSnapshot(handle, &status));
+    UNSIGNED_LONGS_EQUAL(1, status.operationTimeouts);
+    UNSIGNED_LONGS_EQUAL(1, status.lockCount);
+}
+
+TEST(HwLockCtrlServiceInstanceTests, given_virtual_clock_when_a_lock_fails_then_it_is_retried_after_a_delay_a_limited_number_of_times)
+{
+    CHECK_TRUE(xTimerServiceStart(TIMER_CLOCK_VIRTUAL));
+    HLCS_ConfigT config = {};
+    config.lockId = 7;
+    config.lockRetryDelayMs = 100;
+    config.changeStateCallback = TestInstanceStateCallback;
+    config.callbackContext = &mObserver;
+    HLCS_Handle handle = HLCS_Create(&config);
+    mInstances.push_back(handle);
+
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Init").withUnsignedIntParameter("lockId", 7);
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock").withUnsignedIntParameter("lockId", 7).andReturnValue(0);
+    HLCS_InstanceStart(handle, EXECUTION_OPTION_UNIT_TEST);
+    UNSIGNED_LONGS_EQUAL(1, HLCS_InstanceProcessEventBatch(handle, EXECUTION_OPTION_UNIT_TEST));
+    mock().checkExpectations();
+    CHECK_TRUE(HLCS_LOCK_STATE_UNKNOWN == HLCS_InstanceGetState(handle));
+
+    //the retry succeeds
+    vTimerAdvanceTicks(99);
+    CHECK_FALSE(HLCS_InstanceProcessOneEvent(handle, EXECUTION_OPTION_UNIT_TEST));
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Lock").withUnsignedIntParameter("lockId", 7);
+    vTimerAdvanceTicks(1);
+    UNSIGNED_LONGS_EQUAL(2, HLCS_InstanceProcessEventBatch(handle, EXECUTION_OPTION_UNIT_TEST));
+    mock().checkExpectations();
+    CHECK_TRUE(HLCS_LOCK_STATE_LOCKED == HLCS_InstanceGetState(handle));
+
+    //a lock failing every time is retried HLCS_LOCK_RETRY_LIMIT times
+    mock(HW_LOCK_CTRL_MOCK).expectOneCall("Unlock").withUnsignedIntParameter("lockId", 7);
+    mock(HW_LOCK_CTRL_MOCK).expectNCalls(1 + HLCS_LOCK_RETRY_LIMIT, "Lock").withUnsignedIntParameter("lockId", 7).andReturnValue(0);
+    HLCS_InstanceRequestUnlockedAsync(handle);
+    HLCS_InstanceProcessEventBatch(handle, EXECUTION_OPTION_UNIT_TEST);
+    HLCS_InstanceRequestLockedAsync(handle);
+    HLCS_InstanceProcessEventBatch(handle, EXECUTION_OPTION_UNIT_TEST);
+    for (int i = 0; i < (2 * HLCS_LOCK_RETRY_LIMIT); ++i)
+    {
+        vTimerAdvanceTicks(100);
+        HLCS_InstanceProcessEventBatch(handle, EXECUTION_OPTION_UNIT_TEST);
+    }
+    mock().checkExpectations();
+    CHECK_TRUE(HLCS_LOCK_STATE_UNKNOWN == HLCS_InstanceGetState(handle));
+
+    HLCS_StatusT status;
+    CHECK_TRUE(HLCS_InstanceGetStatusSnapshot(handle, &status));
+    UNSIGNED_LONGS_EQUAL(2 + HLCS_LOCK_RETRY_LIMIT, status.driverFailures);
+    UNSIGNED_LONGS_EQUAL(1, status.lockCount);
+}
+
+TEST(HwLockCtrlServiceInstanceTests, given_a_completion_which_never_arrives_when_deleted_then_delete_returns_within_the_timeout)
+{
+    HLCS_ConfigT config = {};
+    config.lockId = 7;
+    config.operationTimeoutMs = 20;
+    HLCS_Handle handle = HLCS_Create(&config);
+    MockHwLockCtrl_DeferCompletions(true);
+    mock(HW_LOCK_CTRL_MOCK).ignoreOtherCalls();
+    HLCS_InstanceStart(handle, EXECUTION_OPTION_UNIT_TEST);
+
+    auto start = std::chrono::steady_clock::now();
+    HLCS_Delete(handle);
+    CHECK_TRUE((std::chrono::steady_clock::now() - start) < std::chrono::seconds(1));
+
+    //the late completion of the abandoned operation is dropped
+    UNSIGNED_LONGS_EQUAL(1, MockHwLockCtrl_CompletePending());
+}
+
+TEST(HwLockCtrlServiceInstanceTests, given_a_bank_of_instances_sharing_one_worker_thread_then_all_requests_complete)
+{
+    static constexpr uint32_t LockCount = 256;
+    mock(HW_LOCK_CTRL_MOCK).ignoreOtherCalls();
+    CHECK_TRUE(xSchedulerStart(1, nullptr));
+    for (uint32_t lockId = 0; lockId < LockCount; ++lockId)
+    {
+        HLCS_InstanceStart(Create(lockId), EXECUTION_OPTION_SHARED_SCHEDULER);
+    }
+
+    for (auto handle : mInstances)
+    {
+        HLCS_InstanceRequestUnlockedAsync(handle);
+        HLCS_InstanceRequestSelfTestAsync(handle);
+    }
+
+    //each instance unlocks, self tests, then returns to unlocked.
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((mObserver.unlockedCount < (2 * LockCount)) && (std::chrono::steady_clock::now() < deadline))
+    {
+        std::this_thread::yield();
+    }
+    UNSIGNED_LONGS_EQUAL(LockCount, mObserver.lockedCount);
+    UNSIGNED_LONGS_EQUAL(2 * LockCount, mObserver.unlockedCount);
+    UNSIGNED_LONGS_EQUAL(LockCount, mObserver.selfTestCount);
+    for (auto handle : mInstances)
+    {
+        CHECK_TRUE(HLCS_LOCK_STATE_UNLOCKED == HLCS_InstanceGetState(handle));
+        HLCS_Delete(handle);
+    }
+    mInstances.clear();
+    vSchedulerStop();
+}
+
+TEST(HwLockCtrlServiceInstanceTests, given_dispatcher_delivery_when_the_observer_is_slow_then_the_service_is_not_delayed_and_changes_coalesce)
+{
+    mock(HW_LOCK_CTRL_MOCK).ignoreOtherCalls();
+    HLCS_Handle handle = Create(3, HLCS_DELIVERY_DISPATCHER);
+    mObserver.blocked = true;
+    HLCS_InstanceStart(handle, EXECUTION_OPTION_UNIT_TEST);
+    UNSIGNED_LONGS_EQUAL(1, HLCS_InstanceProcessEventBatch(handle, EXECUTION_OPTION_UNIT_TEST));
+
+    //the observer is now stuck in the 'locked' callback, on the dispatcher
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((mObserver.lockedCount == 0) && (std::chrono::steady_clock::now() < deadline))
+    {
+        std::this_thread::yield();
+    }
+    UNSIGNED_LONGS_EQUAL(1, mObserver.lockedCount);
+    STRCMP_EQUAL("HLCS notify", mObserver.threadName);
+
+    HLCS_InstanceRequestUnlockedAsync(handle);
+    UNSIGNED_LONGS_EQUAL(2, HLCS_InstanceProcessEventBatch(handle, EXECUTION_OPTION_UNIT_TEST));
+    HLCS_InstanceRequestLockedAsync(handle);
+    UNSIGNED_LONGS_EQUAL(2, HLCS_InstanceProcessEventBatch(handle, EXECUTION_OPTION_UNIT_TEST));
+    HLCS_InstanceRequestUnlockedAsync(handle);
+    UNSIGNED_LONGS_EQUAL(2, HLCS_InstanceProcessEventBatch(handle, EXECUTION_OPTION_UNIT_TEST));
+    CHECK_TRUE(HLCS_LOCK_STATE_UNLOCKED == HLCS_InstanceGetState(handle));
+    UNSIGNED_LONGS_EQUAL(1, mObserver.lockedCount);
+
+    //deleting delivers the pending notification: only the latest state
+    mObserver.blocked = false;
+    HLCS_Delete(handle);
+    mInstances.clear();
+    UNSIGNED_LONGS_EQUAL(1, mObserver.lockedCount);
+    UNSIGNED_LONGS_EQUAL(1, mObserver.unlockedCount);
+    CHECK_TRUE(HLCS_LOCK_STATE_UNLOCKED == mObserver.lastState);
+}
+
+TEST(HwLockCtrlServiceInstanceTests, given_queue_delivery_then_coalesced_notifications_are_delivered_by_the_caller)
+{
+    CHECK_TRUE(Create(4, HLCS_DELIVERY_QUEUE, nullptr) == nullptr);
+    mInstances.clear();
+
+    mock(HW_LOCK_CTRL_MOCK).ignoreOtherCalls();
+    QueueHandle_t queue = xQueueCreate(2, sizeof(HLCS_NotificationT));
+    HLCS_Handle handle = Create(4, HLCS_DELIVERY_QUEUE, queue);
+    CHECK_TRUE(handle != nullptr);
+    HLCS_InstanceStart(handle, EXECUTION_OPTION_UNIT_TEST);
+    HLCS_InstanceProcessEventBatch(handle, EXECUTION_OPTION_UNIT_TEST);
+    HLCS_InstanceRequestUnlockedAsync(handle);
+    HLCS_InstanceProcessEventBatch(handle, EXECUTION_OPTION_UNIT_TEST);
+    HLCS_InstanceRequestSelfTestAsync(handle);
+    HLCS_InstanceProcessEventBatch(handle, EXECUTION_OPTION_UNIT_TEST);
+    UNSIGNED_LONGS_EQUAL(0, mObserver.lockedCount + mObserver.unlockedCount + mObserver.selfTestCount);
+
+    //the latest state, unlocked, and the self test result
+    UNSIGNED_LONGS_EQUAL(2, uxQueueMessagesWaiting(queue));
+    while (uxQueueMessagesWaiting(queue) > 0)
+    {
+        HLCS_NotificationT notification;
+        CHECK_TRUE(xQueueReceive(queue, &notification));
+        CHECK_TRUE(handle == notification.handle);
+        CHECK_TRUE(HLCS_DeliverNotification(&notification));
+    }
+    CHECK_FALSE(HLCS_DeliverNotification(nullptr));
+
+    UNSIGNED_LONGS_EQUAL(0, mObserver.lockedCount);
+    UNSIGNED_LONGS_EQUAL(1, mObserver.unlockedCount);
+    UNSIGNED_LONGS_EQUAL(1, mObserver.selfTestCount);
+    CHECK_TRUE(HLCS_LOCK_STATE_UNLOCKED == mObserver.lastState);
+
+    HLCS_Delete(handle);
+    mInstances.clear();
+    vQueueDelete(queue);
+}
+
+TEST(HwLockCtrlServiceInstanceTests, given_readers_polling_the_status_while_requests_are_processed_then_no_snapshot_is_torn)
+{
+    static constexpr size_t ReaderCount = 3;
+    static constexpr size_t RequestCount = 2000;
+    mock(HW_LOCK_CTRL_MOCK).ignoreOtherCalls();
+    HLCS_Handle handle = Create(9);
+    HLCS_InstanceStart(handle, EXECUTION_OPTION_NORMAL);
+
+    std::atomic<bool> done{false};
+    std::atomic<size_t> snapshots{0};
+    std::atomic<size_t> inconsistent{0};
+    std::vector<std::thread> readers;
+    for (size_t r = 0; r < ReaderCount; ++r)
+    {
+        readers.emplace_back([&]() {
+            HLCS_StatusT previous = {};
+            while (!done)
+            {
+                HLCS_StatusT status;
+                HLCS_InstanceGetStatusSnapshot(handle, &status);
+
+                //fields written together are always seen together
+                bool consistent = (status.eventsProcessed >= previous.eventsProcessed) &&
+                                  ((status.lockCount + status.unlockCount) >= (previous.lockCount + previous.unlockCount)) &&
+                                  (status.selfTestFailures <= status.selfTestCount) &&
+                                  (!status.selfTestInProgress || status.operationInProgress) &&
+                                  (status.operationInProgress || (status.lockState == status.historyState));
+                inconsistent += consistent ? 0 : 1;
+                ++snapshots;
+                previous = status;
+            }
+        });
+    }
+
+    for (size_t i = 0; i < RequestCount; ++i)
+    {
+        if ((i % 16) == 15)
+        {
+            HLCS_InstanceRequestSelfTestAsync(handle);
+        }
+        else if ((i % 2) == 0)
+        {
+            HLCS_InstanceRequestUnlockedAsync(handle);
+        }
+        else
+        {
+            HLCS_InstanceRequestLockedAsync(handle);
+        }
+    }
+    HLCS_InstanceRequestLockedAsync(handle);
+
+    //settled once every event received has been processed, and published
+    HLCS_StatusT status = {};
+    QueueStatsT stats = {};
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        HLCS_InstanceGetStatusSnapshot(handle, &status);
+        HLCS_InstanceGetQueueStats(handle, &stats);
+        if ((stats.currentDepth == 0) && (stats.receives == status.eventsProcessed) && !status.operationInProgress)
+        {
+            break;
+        }
+        std::this_thread::yield();
+    }
+    done = true;
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+
+    CHECK_TRUE(snapshots > 0);
+    UNSIGNED_LONGS_EQUAL(0, inconsistent);
+    CHECK_TRUE(HLCS_LOCK_STATE_LOCKED == status.lockState);
+    UNSIGNED_LONGS_EQUAL(mObserver.lockedCount, status.lockCount);
+}
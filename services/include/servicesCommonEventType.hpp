@@ -1,6 +1,7 @@
 #ifndef ACTIVEOBJECTUNITTESTINGDEMO_SERVICESCOMMONEVENTTYPE_HPP
 #define ACTIVEOBJECTUNITTESTINGDEMO_SERVICESCOMMONEVENTTYPE_HPP
 
+#include <cstdint>
 #include "cmsBaseEvent.hpp"
 
 namespace cms
@@ -0,0 +1,168 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @brief the LockBankService (LBS) controls a bank of thousands of hardware
+ *        locks, each grouped into a zone, as one active object. A single
+ *        request, such as "lock all locks in zone 3", updates the pending
+ *        requests of every selected lock, which the service then carries out
+ *        through the hwLockCtrl driver, following the same behavior as the
+ *        HwLockCtrlService: a self test always returns a lock to its prior
+ *        locked or unlocked state.
+ *
+ *        Per lock state is kept as a structure of arrays of bytes, so the
+ *        bulk selection of locks, and the filtering of requests which would
+ *        not change a lock, are simple loops the compiler vectorizes.
+ *
+ * @note: this file represents the public facing C API for this active object
+ */
+
+#ifndef ACTIVEOBJECTDEMO_LOCKBANKSERVICE_H
+#define ACTIVEOBJECTDEMO_LOCKBANKSERVICE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "cmsExecutionOption.h"
+#include "hwLockCtrlService.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LBS_MAX_LOCKS 65536
+#define LBS_MAX_ZONES 64
+#define LBS_ZONE_ALL 0xFF
+
+typedef void (*LBS_ChangeStateCallback)(void* context, uint32_t lockId, HLCS_LockStateT state);
+typedef void (*LBS_SelfTestResultCallback)(void* context, uint32_t lockId, HLCS_SelfTestResultT result);
+
+typedef struct LBS_Config
+{
+    size_t lockCount;       //locks 0 to lockCount - 1, up to LBS_MAX_LOCKS
+    const uint8_t* zones;   //zone of each lock, below LBS_MAX_ZONES. NULL: all in zone 0
+    size_t driverBudget;    //driver calls per event, 0 selects a default. A large
+                            //request continues with a further event, so others
+                            //sharing a scheduler worker are not starved
+    LBS_ChangeStateCallback changeStateCallback;         //optional
+    LBS_SelfTestResultCallback selfTestResultCallback;   //optional
+    void* callbackContext;
+} LBS_ConfigT;
+
+typedef struct LBS_Counts
+{
+    size_t locked;
+    size_t unlocked;
+    size_t unknown;
+} LBS_CountsT;
+
+/**
+ * @brief LBS_Init() - initialize the module and associated RTOS components.
+ *        The config is copied. The module will be idle and not actually started.
+ * @return false: bad arguments or out of memory.
+ */
+bool LBS_Init(const LBS_ConfigT* config);
+
+/**
+ * @brief LBS_Destroy() - stop the module and release all resources.
+ */
+void LBS_Destroy();
+
+/**
+ * @brief LBS_Start() - start behavior: initialize and lock every lock.
+ * @param option as with HLCS_Start().
+ */
+void LBS_Start(ExecutionOptionT option);
+
+/**
+ * @brief asynchronous requests for all locks of a zone, or LBS_ZONE_ALL.
+ *        Each is a single event. A later lock or unlock request replaces
+ *        an earlier one still pending for the same lock.
+ */
+void LBS_RequestLockedAsync(uint8_t zone);
+void LBS_RequestUnlockedAsync(uint8_t zone);
+void LBS_RequestSelfTestAsync(uint8_t zone);
+
+/**
+ * @brief LBS_GetState() - thread safe, the current state of one lock.
+ */
+HLCS_LockStateT LBS_GetState(uint32_t lockId);
+
+/**
+ * @brief LBS_GetCounts() - thread safe, the number of locks of a zone, or
+ *        LBS_ZONE_ALL, in each state. While requests are in progress the
+ *        counts of different states may be from slightly different moments.
+ * @return false: bad arguments.
+ */
+bool LBS_GetCounts(uint8_t zone, LBS_CountsT* counts);
+
+/**
+ * @brief LBS_GetPendingCount() - locks with requests not yet carried out.
+ *        Only accurate in the service's context, or while it is idle.
+ */
+size_t LBS_GetPendingCount();
+
+/****************************************************************************/
+/*****  Backdoor functionality provided for unit testing access only ********/
+/****************************************************************************/
+
+/**
+ * @brief LBS_ProcessOneEvent() - as HLCS_ProcessOneEvent().
+ */
+bool LBS_ProcessOneEvent(ExecutionOptionT option);
+
+/****************************************************************************/
+/*****  Multiple instances, one per bank of locks                   *********/
+/****************************************************************************/
+
+typedef struct LBS_Instance* LBS_Handle;
+
+/**
+ * @brief LBS_Create() - create an idle service instance, as LBS_Init().
+ *        The instance, its per lock arrays and its zone counts live in
+ *        one cache line aligned allocation. The LBS_* functions above
+ *        act on a default instance, created by LBS_Init().
+ * @return NULL: bad arguments or out of memory.
+ */
+LBS_Handle LBS_Create(const LBS_ConfigT* config);
+
+/**
+ * @brief LBS_Delete() - stop and release the instance, as LBS_Destroy().
+ */
+void LBS_Delete(LBS_Handle handle);
+
+void LBS_InstanceStart(LBS_Handle handle, ExecutionOptionT option);
+void LBS_InstanceRequestLockedAsync(LBS_Handle handle, uint8_t zone);
+void LBS_InstanceRequestUnlockedAsync(LBS_Handle handle, uint8_t zone);
+void LBS_InstanceRequestSelfTestAsync(LBS_Handle handle, uint8_t zone);
+HLCS_LockStateT LBS_InstanceGetState(LBS_Handle handle, uint32_t lockId);
+bool LBS_InstanceGetCounts(LBS_Handle handle, uint8_t zone, LBS_CountsT* counts);
+size_t LBS_InstanceGetPendingCount(LBS_Handle handle);
+bool LBS_InstanceProcessOneEvent(LBS_Handle handle, ExecutionOptionT option);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //ACTIVEOBJECTDEMO_LOCKBANKSERVICE_H
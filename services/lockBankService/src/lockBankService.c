@@ -0,0 +1,622 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <stdatomic.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lockBankService.h"
+#include "hwLockCtrl.h"
+#include "fauxQueue.h"
+#include "fauxThread.h"
+#include "fauxScheduler.h"
+#include "fauxTrace.h"
+
+#define LBS_CACHE_LINE_SIZE 64
+
+typedef enum LBS_Signal
+{
+    LBS_SIG_REQUEST_LOCKED,
+    LBS_SIG_REQUEST_UNLOCKED,
+    LBS_SIG_REQUEST_SELF_TEST,
+    LBS_SIG_CONTINUE,        //posted by the service to itself, more pending requests remain
+    LBS_SIG_REQUEST_THREAD_EXIT
+} LBS_SignalT;
+
+typedef struct LBS_EventType
+{
+    uint32_t signal;
+    uint32_t zone;
+} LBS_EventTypeT;
+
+//pending request bits, one byte per lock
+#define LBS_PENDING_LOCK      0x01u
+#define LBS_PENDING_UNLOCK    0x02u
+#define LBS_PENDING_SELF_TEST 0x04u
+
+/**
+ * @brief LBS_Instance - all state of one bank of locks. The per lock
+ *        arrays follow the structure, in the same allocation. The fields
+ *        written by the service, and read by other threads, start on
+ *        their own cache line, apart from those fixed once created.
+ */
+struct LBS_Instance
+{
+    //fixed once created, read by requesting threads
+    _Alignas(LBS_CACHE_LINE_SIZE) QueueHandle_t eventQueue;
+    LBS_ConfigT config;
+
+    //per lock state, a structure of arrays, each padded to whole cache lines.
+    //states is written with relaxed atomic stores, read by any thread, all
+    //other arrays are only accessed by the service.
+    uint8_t* states;    //HLCS_LockStateT
+    uint8_t* history;   //the state a self test returns to
+    uint8_t* zones;
+    uint8_t* pending;   //LBS_PENDING_* bits
+    size_t zoneSizes[LBS_MAX_ZONES];
+
+    //written by the service, read by any thread, for LBS_InstanceGetCounts()
+    _Alignas(LBS_CACHE_LINE_SIZE) atomic_size_t lockedCounts[LBS_MAX_ZONES];
+    atomic_size_t unlockedCounts[LBS_MAX_ZONES];
+    atomic_size_t pendingLocks; //locks with any pending bit set
+    atomic_bool exitThread;
+
+    //only accessed by the thread or worker executing the service
+    _Alignas(LBS_CACHE_LINE_SIZE) TaskHandle_t thread;
+    ScheduledObjectHandle_t scheduledObject;
+    size_t cursor;              //next lock scanned for pending requests
+    bool continuePosted;
+    size_t deferredRequests;    //requests applied since the last drain
+};
+
+typedef struct LBS_Instance LBS_InstanceT;
+
+//internal prototypes
+static void LBS_Initialize(LBS_InstanceT* me);
+static void LBS_PushEvent(LBS_InstanceT* me, LBS_SignalT sig, uint8_t zone);
+static bool LBS_ProcessReceivedEvent(LBS_InstanceT* me, const LBS_EventTypeT* event);
+static void LBS_UpdatePending(LBS_InstanceT* me, uint8_t zone, uint8_t setBit, uint8_t clearBit, uint8_t satisfiedState);
+static size_t LBS_CountPending(const LBS_InstanceT* me);
+static size_t LBS_FindPending(const LBS_InstanceT* me, size_t from);
+static void LBS_Drain(LBS_InstanceT* me);
+static size_t LBS_CarryOut(LBS_InstanceT* me, size_t lock);
+static void LBS_Enter(LBS_InstanceT* me, size_t lock, HLCS_LockStateT state);
+static void LBS_SetState(LBS_InstanceT* me, size_t lock, HLCS_LockStateT state);
+static void LBS_Task(void* parameters);
+static bool LBS_Dispatch(void* context);
+
+//constants
+static const size_t QueueDepth = 16;
+static const TickType_t PushEventTimeout = pdMS_TO_TICKS(100);
+static const size_t TaskStackDepth = 4096;
+static const size_t DefaultDriverBudget = 256;
+static const size_t ArrayAlignment = LBS_CACHE_LINE_SIZE;
+static const uint8_t NoState = 0xFF; //matches no lock, so every selected lock is affected
+
+//module static variables
+static LBS_InstanceT* s_default = NULL;
+
+bool LBS_Init(const LBS_ConfigT* config)
+{
+    //ensure Init is being called appropriately
+    assert(s_default == NULL);
+
+    s_default = LBS_Create(config);
+    return s_default != NULL;
+}
+
+void LBS_Destroy()
+{
+    LBS_Delete(s_default);
+    s_default = NULL;
+}
+
+void LBS_Start(ExecutionOptionT option)
+{
+    assert(s_default != NULL);
+    LBS_InstanceStart(s_default, option);
+}
+
+void LBS_RequestLockedAsync(uint8_t zone)
+{
+    LBS_InstanceRequestLockedAsync(s_default, zone);
+}
+
+void LBS_RequestUnlockedAsync(uint8_t zone)
+{
+    LBS_InstanceRequestUnlockedAsync(s_default, zone);
+}
+
+void LBS_RequestSelfTestAsync(uint8_t zone)
+{
+    LBS_InstanceRequestSelfTestAsync(s_default, zone);
+}
+
+HLCS_LockStateT LBS_GetState(uint32_t lockId)
+{
+    return LBS_InstanceGetState(s_default, lockId);
+}
+
+bool LBS_GetCounts(uint8_t zone, LBS_CountsT* counts)
+{
+    return LBS_InstanceGetCounts(s_default, zone, counts);
+}
+
+size_t LBS_GetPendingCount()
+{
+    return LBS_InstanceGetPendingCount(s_default);
+}
+
+bool LBS_ProcessOneEvent(ExecutionOptionT option)
+{
+    return LBS_InstanceProcessOneEvent(s_default, option);
+}
+
+LBS_Handle LBS_Create(const LBS_ConfigT* config)
+{
+    if ((config == NULL) || (config->lockCount == 0) || (config->lockCount > LBS_MAX_LOCKS))
+    {
+        return NULL;
+    }
+
+    size_t count = config->lockCount;
+    for (size_t i = 0; (config->zones != NULL) && (i < count); ++i)
+    {
+        if (config->zones[i] >= LBS_MAX_ZONES)
+        {
+            return NULL;
+        }
+    }
+
+    //sizeof() is a multiple of the alignment, as aligned_alloc() requires,
+    //so each array following the instance starts on a cache line.
+    size_t stride = ((count + ArrayAlignment - 1) / ArrayAlignment) * ArrayAlignment;
+    size_t size = sizeof(LBS_InstanceT) + (stride * 4);
+    LBS_InstanceT* me = aligned_alloc(_Alignof(LBS_InstanceT), size);
+    if (me == NULL)
+    {
+        return NULL;
+    }
+    memset(me, 0, size);
+
+    uint8_t* arrays = (uint8_t*)(me + 1);
+    me->states = arrays;
+    me->history = arrays + stride;
+    me->zones = arrays + (stride * 2);
+    me->pending = arrays + (stride * 3);
+    if (config->zones != NULL)
+    {
+        memcpy(me->zones, config->zones, count);
+    }
+
+    me->config = *config;
+    me->config.zones = NULL; //copied above
+    if (me->config.driverBudget == 0)
+    {
+        me->config.driverBudget = DefaultDriverBudget;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        ++me->zoneSizes[me->zones[i]];
+    }
+
+    me->eventQueue = xQueueCreate(QueueDepth, sizeof(LBS_EventTypeT));
+    if (me->eventQueue == NULL)
+    {
+        free(me);
+        return NULL;
+    }
+    vQueueEnableStats(me->eventQueue, true);
+    vTraceSetObjectName(me->eventQueue, "LBS queue");
+    vTraceSetObjectName(me, "LBS");
+
+    //thread is created in Start()
+    return me;
+}
+
+void LBS_Delete(LBS_Handle handle)
+{
+    LBS_InstanceT* me = handle;
+    if (me == NULL)
+    {
+        return;
+    }
+
+    if (me->scheduledObject != NULL)
+    {
+        vSchedulerUnregister(me->scheduledObject);
+        me->scheduledObject = NULL;
+    }
+
+    me->exitThread = true;
+    LBS_EventTypeT event = { .signal = LBS_SIG_REQUEST_THREAD_EXIT, .zone = 0 };
+    bool ok = xQueueSendToFront(me->eventQueue, &event);
+    assert(ok);
+    (void)ok;
+    vTaskDelete(me->thread);
+    vQueueDelete(me->eventQueue);
+    free(me);
+}
+
+void LBS_InstanceStart(LBS_Handle handle, ExecutionOptionT option)
+{
+    LBS_InstanceT* me = handle;
+    assert(me != NULL);
+    assert(me->thread == NULL);
+    assert(me->scheduledObject == NULL);
+
+    if (EXECUTION_OPTION_NORMAL == option)
+    {
+        bool ok = xTaskCreateWithParameters(LBS_Task, "LBS", TaskStackDepth, me, NULL, &me->thread);
+        assert(ok == true);
+        (void)ok;
+    }
+    else if (EXECUTION_OPTION_SHARED_SCHEDULER == option)
+    {
+        assert(xSchedulerIsRunning());
+        LBS_Initialize(me);
+        me->scheduledObject = xSchedulerRegister(me->eventQueue, LBS_Dispatch, me);
+        assert(me->scheduledObject != NULL);
+    }
+    else
+    {
+        LBS_Initialize(me);
+    }
+}
+
+void LBS_InstanceRequestLockedAsync(LBS_Handle handle, uint8_t zone)
+{
+    LBS_PushEvent(handle, LBS_SIG_REQUEST_LOCKED, zone);
+}
+
+void LBS_InstanceRequestUnlockedAsync(LBS_Handle handle, uint8_t zone)
+{
+    LBS_PushEvent(handle, LBS_SIG_REQUEST_UNLOCKED, zone);
+}
+
+void LBS_InstanceRequestSelfTestAsync(LBS_Handle handle, uint8_t zone)
+{
+    LBS_PushEvent(handle, LBS_SIG_REQUEST_SELF_TEST, zone);
+}
+
+HLCS_LockStateT LBS_InstanceGetState(LBS_Handle handle, uint32_t lockId)
+{
+    if ((handle == NULL) || (lockId >= handle->config.lockCount))
+    {
+        return HLCS_LOCK_STATE_UNKNOWN;
+    }
+
+    return (HLCS_LockStateT)__atomic_load_n(&handle->states[lockId], __ATOMIC_RELAXED);
+}
+
+bool LBS_InstanceGetCounts(LBS_Handle handle, uint8_t zone, LBS_CountsT* counts)
+{
+    if ((handle == NULL) || (counts == NULL) || ((zone >= LBS_MAX_ZONES) && (zone != LBS_ZONE_ALL)))
+    {
+        return false;
+    }
+
+    size_t first = (zone == LBS_ZONE_ALL) ? 0 : zone;
+    size_t last = (zone == LBS_ZONE_ALL) ? LBS_MAX_ZONES : (size_t)zone + 1;
+    size_t total = 0;
+    counts->locked = 0;
+    counts->unlocked = 0;
+    for (size_t i = first; i < last; ++i)
+    {
+        total += handle->zoneSizes[i];
+        counts->locked += atomic_load_explicit(&handle->lockedCounts[i], memory_order_relaxed);
+        counts->unlocked += atomic_load_explicit(&handle->unlockedCounts[i], memory_order_relaxed);
+    }
+    size_t known = counts->locked + counts->unlocked;
+    counts->unknown = (total > known) ? (total - known) : 0;
+    return true;
+}
+
+size_t LBS_InstanceGetPendingCount(LBS_Handle handle)
+{
+    return (handle != NULL) ? atomic_load_explicit(&handle->pendingLocks, memory_order_relaxed) : 0;
+}
+
+bool LBS_InstanceProcessOneEvent(LBS_Handle handle, ExecutionOptionT option)
+{
+    LBS_InstanceT* me = handle;
+
+    //only the internal thread waits for work.
+    TickType_t ticksToWait = (EXECUTION_OPTION_NORMAL == option) ? portMAX_DELAY : 0;
+
+    LBS_EventTypeT event;
+    bool ok = xQueueReceiveTimed(me->eventQueue, &event, ticksToWait);
+    if (!ok)
+    {
+        return false;
+    }
+
+    return LBS_ProcessReceivedEvent(me, &event);
+}
+
+bool LBS_ProcessReceivedEvent(LBS_InstanceT* me, const LBS_EventTypeT* event)
+{
+    vTraceRecord(TRACE_EVENT_DISPATCH_BEGIN, me, event->signal, event->zone, 0);
+    switch (event->signal)
+    {
+    case LBS_SIG_REQUEST_LOCKED:
+        LBS_UpdatePending(me, (uint8_t)event->zone, LBS_PENDING_LOCK, LBS_PENDING_UNLOCK, HLCS_LOCK_STATE_LOCKED);
+        break;
+    case LBS_SIG_REQUEST_UNLOCKED:
+        LBS_UpdatePending(me, (uint8_t)event->zone, LBS_PENDING_UNLOCK, LBS_PENDING_LOCK, HLCS_LOCK_STATE_UNLOCKED);
+        break;
+    case LBS_SIG_REQUEST_SELF_TEST:
+        LBS_UpdatePending(me, (uint8_t)event->zone, LBS_PENDING_SELF_TEST, 0, NoState);
+        break;
+    case LBS_SIG_CONTINUE:
+        me->continuePosted = false;
+        break;
+    case LBS_SIG_REQUEST_THREAD_EXIT: //purposeful fallthrough
+    default:
+        me->exitThread = true;
+        return false;
+    }
+
+    //requests already queued are applied first, so a burst of requests
+    //coalesces before any driver calls. A steady stream of requests
+    //still drains every QueueDepth requests.
+    if ((event->signal == LBS_SIG_CONTINUE) || (uxQueueMessagesWaiting(me->eventQueue) == 0) ||
+        (++me->deferredRequests >= QueueDepth))
+    {
+        me->deferredRequests = 0;
+        LBS_Drain(me);
+    }
+    vTraceRecord(TRACE_EVENT_DISPATCH_END, me, event->signal, (uint32_t)LBS_InstanceGetPendingCount(me), 0);
+    return true;
+}
+
+void LBS_PushEvent(LBS_InstanceT* me, LBS_SignalT sig, uint8_t zone)
+{
+    assert(me != NULL);
+    LBS_EventTypeT event =
+      {
+        .signal = sig,
+        .zone = zone
+      };
+    //a full queue applies backpressure to the caller for a
+    //short while, rather than immediately failing.
+    bool ok = xQueueSendToBackTimed(me->eventQueue, &event, PushEventTimeout);
+    assert(ok);
+    (void)ok;
+}
+
+void LBS_Initialize(LBS_InstanceT* me)
+{
+    //as the HwLockCtrlService's initial transition, for every lock:
+    //initialize the driver, then lock.
+    for (size_t i = 0; i < me->config.lockCount; ++i)
+    {
+        HwLockCtrlInitById((HwLockIdT)i);
+    }
+
+    LBS_UpdatePending(me, LBS_ZONE_ALL, LBS_PENDING_LOCK, LBS_PENDING_UNLOCK, HLCS_LOCK_STATE_LOCKED);
+    LBS_Drain(me);
+}
+
+/**
+ * @brief LBS_UpdatePending() - apply a request to the selected locks.
+ *        setBit is requested of each selected lock not already in
+ *        satisfiedState, clearBit of every selected lock is cleared.
+ *        Branch free, so the loop vectorizes.
+ */
+void LBS_UpdatePending(LBS_InstanceT* me, uint8_t zone, uint8_t setBit, uint8_t clearBit, uint8_t satisfiedState)
+{
+    const uint8_t* restrict zones = me->zones;
+    const uint8_t* restrict states = me->states;
+    uint8_t* restrict pending = me->pending;
+    const size_t count = me->config.lockCount;
+    const uint8_t all = (zone == LBS_ZONE_ALL) ? 0xFF : 0;
+    const uint8_t notSet = (uint8_t)~clearBit;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint8_t selected = (uint8_t)(all | (uint8_t)-(uint8_t)(zones[i] == zone));
+        uint8_t needed = (uint8_t)-(uint8_t)(states[i] != satisfiedState);
+        uint8_t kept = pending[i] & (uint8_t)(notSet | (uint8_t)~selected);
+        pending[i] = kept | (selected & needed & setBit);
+    }
+
+    atomic_store_explicit(&me->pendingLocks, LBS_CountPending(me), memory_order_relaxed);
+    me->cursor = 0;
+}
+
+size_t LBS_CountPending(const LBS_InstanceT* me)
+{
+    const uint8_t* restrict pending = me->pending;
+    const size_t count = me->config.lockCount;
+    size_t pendingLocks = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        pendingLocks += (pending[i] != 0);
+    }
+    return pendingLocks;
+}
+
+/**
+ * @brief LBS_FindPending() - the first lock at or after 'from' with
+ *        pending requests, skipping eight idle locks per comparison.
+ * @return lockCount if none.
+ */
+size_t LBS_FindPending(const LBS_InstanceT* me, size_t from)
+{
+    const uint8_t* pending = me->pending;
+    const size_t count = me->config.lockCount;
+    size_t i = from;
+    while ((i + sizeof(uint64_t)) <= count)
+    {
+        uint64_t word;
+        memcpy(&word, &pending[i], sizeof(word));
+        if (word != 0)
+        {
+            break;
+        }
+        i += sizeof(uint64_t);
+    }
+
+    while ((i < count) && (pending[i] == 0))
+    {
+        ++i;
+    }
+    return i;
+}
+
+/**
+ * @brief LBS_Drain() - carry out pending requests, in lock order, until
+ *        none remain or the driver budget is spent. Any remainder is
+ *        continued by a further event, behind events already queued.
+ */
+void LBS_Drain(LBS_InstanceT* me)
+{
+    size_t calls = 0;
+    size_t pendingLocks = LBS_InstanceGetPendingCount(me);
+    while ((pendingLocks > 0) && (calls < me->config.driverBudget))
+    {
+        size_t lock = LBS_FindPending(me, me->cursor);
+        if (lock == me->config.lockCount)
+        {
+            //requests only set bits, then restart the scan at lock 0.
+            lock = LBS_FindPending(me, 0);
+            assert(lock < me->config.lockCount);
+        }
+
+        calls += LBS_CarryOut(me, lock);
+        atomic_store_explicit(&me->pendingLocks, --pendingLocks, memory_order_relaxed);
+        me->cursor = lock + 1;
+    }
+
+    if ((pendingLocks > 0) && !me->continuePosted)
+    {
+        //when the queue is full, the next event continues instead.
+        LBS_EventTypeT event = { .signal = LBS_SIG_CONTINUE, .zone = 0 };
+        me->continuePosted = xQueueSendToBack(me->eventQueue, &event);
+    }
+}
+
+/**
+ * @brief LBS_CarryOut() - carry out the pending requests of one lock,
+ *        a lock or unlock request first, then a self test.
+ * @return the number of driver calls made.
+ */
+size_t LBS_CarryOut(LBS_InstanceT* me, size_t lock)
+{
+    uint8_t pending = me->pending[lock];
+    me->pending[lock] = 0;
+    size_t calls = 0;
+
+    if ((pending & LBS_PENDING_LOCK) && (me->states[lock] != HLCS_LOCK_STATE_LOCKED))
+    {
+        LBS_Enter(me, lock, HLCS_LOCK_STATE_LOCKED);
+        ++calls;
+    }
+    else if ((pending & LBS_PENDING_UNLOCK) && (me->states[lock] != HLCS_LOCK_STATE_UNLOCKED))
+    {
+        LBS_Enter(me, lock, HLCS_LOCK_STATE_UNLOCKED);
+        ++calls;
+    }
+
+    if (pending & LBS_PENDING_SELF_TEST)
+    {
+        me->history[lock] = me->states[lock];
+
+        HwLockCtrlSelfTestResultT result = HW_LOCK_CTRL_SELF_TEST_FAILED_POWER;
+        bool ok = HwLockCtrlSelfTestById((HwLockIdT)lock, &result);
+        HLCS_SelfTestResultT selfTestResult = (ok && (result == HW_LOCK_CTRL_SELF_TEST_PASSED)) ?
+                                              HLCS_SELF_TEST_RESULT_PASS : HLCS_SELF_TEST_RESULT_FAIL;
+        if (me->config.selfTestResultCallback)
+        {
+            me->config.selfTestResultCallback(me->config.callbackContext, (uint32_t)lock, selfTestResult);
+        }
+
+        //a self test leaves the lock locked, return to history
+        //by re-entering the prior state, as the HwLockCtrlService.
+        LBS_Enter(me, lock, (HLCS_LockStateT)me->history[lock]);
+        calls += 2;
+    }
+
+    return calls;
+}
+
+void LBS_Enter(LBS_InstanceT* me, size_t lock, HLCS_LockStateT state)
+{
+    if (state == HLCS_LOCK_STATE_UNLOCKED)
+    {
+        HwLockCtrlUnlockById((HwLockIdT)lock);
+    }
+    else
+    {
+        HwLockCtrlLockById((HwLockIdT)lock);
+        state = HLCS_LOCK_STATE_LOCKED;
+    }
+
+    LBS_SetState(me, lock, state);
+    if (me->config.changeStateCallback)
+    {
+        me->config.changeStateCallback(me->config.callbackContext, (uint32_t)lock, state);
+    }
+}
+
+void LBS_SetState(LBS_InstanceT* me, size_t lock, HLCS_LockStateT state)
+{
+    uint8_t zone = me->zones[lock];
+    uint8_t previous = me->states[lock];
+    if (previous == HLCS_LOCK_STATE_LOCKED)
+    {
+        atomic_fetch_sub_explicit(&me->lockedCounts[zone], 1, memory_order_relaxed);
+    }
+    else if (previous == HLCS_LOCK_STATE_UNLOCKED)
+    {
+        atomic_fetch_sub_explicit(&me->unlockedCounts[zone], 1, memory_order_relaxed);
+    }
+
+    if (state == HLCS_LOCK_STATE_LOCKED)
+    {
+        atomic_fetch_add_explicit(&me->lockedCounts[zone], 1, memory_order_relaxed);
+    }
+    else if (state == HLCS_LOCK_STATE_UNLOCKED)
+    {
+        atomic_fetch_add_explicit(&me->unlockedCounts[zone], 1, memory_order_relaxed);
+    }
+
+    __atomic_store_n(&me->states[lock], (uint8_t)state, __ATOMIC_RELAXED);
+}
+
+bool LBS_Dispatch(void* context)
+{
+    return LBS_InstanceProcessOneEvent(context, EXECUTION_OPTION_SHARED_SCHEDULER);
+}
+
+void LBS_Task(void* parameters)
+{
+    LBS_InstanceT* me = parameters;
+    LBS_Initialize(me);
+    while (!me->exitThread)
+    {
+        LBS_InstanceProcessOneEvent(me, EXECUTION_OPTION_NORMAL);
+    }
+}
@@ -0,0 +1,293 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "lockBankService.h"
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+#include "hwLockCtrl.h"
+#include <vector>
+
+static constexpr const char* HW_LOCK_CTRL_MOCK = "HwLockCtrl";
+static constexpr const char* CB_MOCK = "TestCb";
+
+static void TestLockStateCallback(void* context, uint32_t lockId, HLCS_LockStateT state)
+{
+    (void)context;
+    mock(CB_MOCK).actualCall("LockStateCallback").withUnsignedIntParameter("lockId", lockId).withIntParameter("state", static_cast<int>(state));
+}
+
+static void TestSelfTestResultCallback(void* context, uint32_t lockId, HLCS_SelfTestResultT result)
+{
+    (void)context;
+    mock(CB_MOCK).actualCall("SelfTestResultCallback").withUnsignedIntParameter("lockId", lockId).withIntParameter("result", static_cast<int>(result));
+}
+
+/**
+ * @brief as the HwLockCtrlServiceTests, tests the behavior of the bank
+ *        via the unit testing back door to its event queue. A small bank
+ *        of four locks, two in each of zones 0 and 1.
+ */
+TEST_GROUP(LockBankServiceTests)
+{
+    const uint8_t mZones[4] = {0, 1, 0, 1};
+
+    void setup() final
+    {
+        LBS_ConfigT config = {};
+        config.lockCount = 4;
+        config.zones = mZones;
+        config.changeStateCallback = TestLockStateCallback;
+        config.selfTestResultCallback = TestSelfTestResultCallback;
+        CHECK_TRUE(LBS_Init(&config));
+    }
+
+    void teardown() final
+    {
+        LBS_Destroy(); //ensure we are stopped/clean/destroyed.
+        mock().clear();
+    }
+
+    void GiveProcessingTime()
+    {
+        //use our unit testing backdoor to service
+        //the active object's internal queue
+        while (LBS_ProcessOneEvent(EXECUTION_OPTION_UNIT_TEST))
+        {
+        }
+    }
+
+    void ExpectTransition(uint32_t lockId, HLCS_LockStateT state)
+    {
+        const char* call = (state == HLCS_LOCK_STATE_LOCKED) ? "Lock" : "Unlock";
+        mock(HW_LOCK_CTRL_MOCK).expectOneCall(call).withUnsignedIntParameter("lockId", lockId);
+        mock(CB_MOCK).expectOneCall("LockStateCallback").withUnsignedIntParameter("lockId", lockId).withIntParameter("state", static_cast<int>(state));
+    }
+
+    void StartBankToLocked()
+    {
+        for (uint32_t lockId = 0; lockId < 4; ++lockId)
+        {
+            mock(HW_LOCK_CTRL_MOCK).expectOneCall("Init").withUnsignedIntParameter("lockId", lockId);
+        }
+        for (uint32_t lockId = 0; lockId < 4; ++lockId)
+        {
+            ExpectTransition(lockId, HLCS_LOCK_STATE_LOCKED);
+        }
+        LBS_Start(EXECUTION_OPTION_UNIT_TEST);
+        mock().checkExpectations();
+    }
+
+    void CheckCounts(uint8_t zone, size_t locked, size_t unlocked)
+    {
+        LBS_CountsT counts = {};
+        CHECK_TRUE(LBS_GetCounts(zone, &counts));
+        CHECK_EQUAL(locked, counts.locked);
+        CHECK_EQUAL(unlocked, counts.unlocked);
+        CHECK_EQUAL(0U, counts.unknown);
+    }
+};
+
+TEST(LockBankServiceTests, init_rejects_bad_configs)
+{
+    LBS_Destroy();
+
+    LBS_ConfigT config = {};
+    CHECK_FALSE(LBS_Init(&config));
+    config.lockCount = LBS_MAX_LOCKS + 1;
+    CHECK_FALSE(LBS_Init(&config));
+    const uint8_t badZone[1] = {LBS_MAX_ZONES};
+    config.lockCount = 1;
+    config.zones = badZone;
+    CHECK_FALSE(LBS_Init(&config));
+    CHECK_FALSE(LBS_Init(nullptr));
+}
+
+TEST(LockBankServiceTests, given_init_when_started_then_every_lock_is_initialized_and_locked)
+{
+    LBS_CountsT counts = {};
+    CHECK_TRUE(LBS_GetCounts(LBS_ZONE_ALL, &counts));
+    CHECK_EQUAL(4U, counts.unknown);
+
+    StartBankToLocked();
+    CheckCounts(LBS_ZONE_ALL, 4, 0);
+    CHECK_EQUAL(0U, LBS_GetPendingCount());
+    for (uint32_t lockId = 0; lockId < 4; ++lockId)
+    {
+        CHECK_EQUAL(HLCS_LOCK_STATE_LOCKED, LBS_GetState(lockId));
+    }
+    CHECK_EQUAL(HLCS_LOCK_STATE_UNKNOWN, LBS_GetState(4));
+}
+
+TEST(LockBankServiceTests, given_locked_when_zone_unlock_requested_then_only_that_zone_unlocks)
+{
+    StartBankToLocked();
+
+    ExpectTransition(1, HLCS_LOCK_STATE_UNLOCKED);
+    ExpectTransition(3, HLCS_LOCK_STATE_UNLOCKED);
+    LBS_RequestUnlockedAsync(1);
+    GiveProcessingTime();
+    mock().checkExpectations();
+
+    CHECK_EQUAL(HLCS_LOCK_STATE_LOCKED, LBS_GetState(0));
+    CHECK_EQUAL(HLCS_LOCK_STATE_UNLOCKED, LBS_GetState(1));
+    CheckCounts(0, 2, 0);
+    CheckCounts(1, 0, 2);
+    CheckCounts(LBS_ZONE_ALL, 2, 2);
+}
+
+TEST(LockBankServiceTests, given_zone_unlocked_when_lock_all_requested_then_only_unlocked_locks_are_driven)
+{
+    StartBankToLocked();
+    ExpectTransition(1, HLCS_LOCK_STATE_UNLOCKED);
+    ExpectTransition(3, HLCS_LOCK_STATE_UNLOCKED);
+    LBS_RequestUnlockedAsync(1);
+    GiveProcessingTime();
+    mock().checkExpectations();
+
+    //locks 0 and 2 are already locked, and are left alone
+    ExpectTransition(1, HLCS_LOCK_STATE_LOCKED);
+    ExpectTransition(3, HLCS_LOCK_STATE_LOCKED);
+    LBS_RequestLockedAsync(LBS_ZONE_ALL);
+    GiveProcessingTime();
+    mock().checkExpectations();
+    CheckCounts(LBS_ZONE_ALL, 4, 0);
+}
+
+TEST(LockBankServiceTests, given_locked_when_unlock_then_lock_requested_then_last_request_wins)
+{
+    StartBankToLocked();
+
+    //both requests are applied before any driver calls, which leaves
+    //nothing to do, as every lock is already locked.
+    LBS_RequestUnlockedAsync(LBS_ZONE_ALL);
+    LBS_RequestLockedAsync(LBS_ZONE_ALL);
+    GiveProcessingTime();
+    mock().checkExpectations();
+    CheckCounts(LBS_ZONE_ALL, 4, 0);
+}
+
+TEST(LockBankServiceTests, given_mixed_states_when_selftest_requested_then_each_lock_returns_to_its_prior_state)
+{
+    StartBankToLocked();
+    ExpectTransition(1, HLCS_LOCK_STATE_UNLOCKED);
+    ExpectTransition(3, HLCS_LOCK_STATE_UNLOCKED);
+    LBS_RequestUnlockedAsync(1);
+    GiveProcessingTime();
+    mock().checkExpectations();
+
+    static HwLockCtrlSelfTestResultT passed = HW_LOCK_CTRL_SELF_TEST_PASSED;
+    static HwLockCtrlSelfTestResultT failed = HW_LOCK_CTRL_SELF_TEST_FAILED_MOTOR;
+    for (uint32_t lockId = 0; lockId < 4; ++lockId)
+    {
+        HwLockCtrlSelfTestResultT* result = (lockId == 2) ? &failed : &passed;
+        mock(HW_LOCK_CTRL_MOCK).expectOneCall("SelfTest").withUnsignedIntParameter("lockId", lockId).withOutputParameterReturning("outResult", result, sizeof(*result));
+        HLCS_SelfTestResultT expected = (lockId == 2) ? HLCS_SELF_TEST_RESULT_FAIL : HLCS_SELF_TEST_RESULT_PASS;
+        mock(CB_MOCK).expectOneCall("SelfTestResultCallback").withUnsignedIntParameter("lockId", lockId).withIntParameter("result", static_cast<int>(expected));
+        ExpectTransition(lockId, (mZones[lockId] == 1) ? HLCS_LOCK_STATE_UNLOCKED : HLCS_LOCK_STATE_LOCKED);
+    }
+    LBS_RequestSelfTestAsync(LBS_ZONE_ALL);
+    GiveProcessingTime();
+    mock().checkExpectations();
+    CheckCounts(0, 2, 0);
+    CheckCounts(1, 0, 2);
+}
+
+TEST(LockBankServiceTests, large_bank_with_a_small_driver_budget_continues_over_several_events)
+{
+    LBS_Destroy();
+
+    static constexpr size_t LockCount = 1000;
+    std::vector<uint8_t> zones(LockCount);
+    for (size_t i = 0; i < LockCount; ++i)
+    {
+        zones[i] = static_cast<uint8_t>(i % LBS_MAX_ZONES);
+    }
+    LBS_ConfigT config = {};
+    config.lockCount = LockCount;
+    config.zones = zones.data();
+    config.driverBudget = 100;
+    CHECK_TRUE(LBS_Init(&config));
+
+    mock(HW_LOCK_CTRL_MOCK).ignoreOtherCalls();
+    LBS_Start(EXECUTION_OPTION_UNIT_TEST);
+    CHECK_EQUAL(LockCount - 100, LBS_GetPendingCount());
+
+    size_t events = 0;
+    while (LBS_ProcessOneEvent(EXECUTION_OPTION_UNIT_TEST))
+    {
+        ++events;
+    }
+    CHECK_EQUAL(9U, events);
+    CHECK_EQUAL(0U, LBS_GetPendingCount());
+    CheckCounts(LBS_ZONE_ALL, LockCount, 0);
+
+    LBS_RequestUnlockedAsync(5);
+    GiveProcessingTime();
+    size_t zoneSize = (LockCount / LBS_MAX_ZONES) + ((5 < (LockCount % LBS_MAX_ZONES)) ? 1 : 0);
+    CheckCounts(5, 0, zoneSize);
+    CheckCounts(LBS_ZONE_ALL, LockCount - zoneSize, zoneSize);
+    for (size_t i = 0; i < LockCount; ++i)
+    {
+        HLCS_LockStateT expected = (zones[i] == 5) ? HLCS_LOCK_STATE_UNLOCKED : HLCS_LOCK_STATE_LOCKED;
+        CHECK_EQUAL(expected, LBS_GetState(static_cast<uint32_t>(i)));
+    }
+}
+
+TEST(LockBankServiceTests, created_instances_are_cache_line_aligned_and_independent)
+{
+    const uint8_t zones[2] = {0, 1};
+    LBS_ConfigT config = {};
+    config.lockCount = 2;
+    config.zones = zones;
+    LBS_Handle first = LBS_Create(&config);
+    LBS_Handle second = LBS_Create(&config);
+    CHECK_TRUE(first != nullptr);
+    CHECK_TRUE(second != nullptr);
+    CHECK_EQUAL(0U, reinterpret_cast<uintptr_t>(first) % 64);
+    CHECK_EQUAL(0U, reinterpret_cast<uintptr_t>(second) % 64);
+    POINTERS_EQUAL(nullptr, LBS_Create(nullptr));
+
+    mock(HW_LOCK_CTRL_MOCK).ignoreOtherCalls();
+    LBS_InstanceStart(first, EXECUTION_OPTION_UNIT_TEST);
+    LBS_InstanceStart(second, EXECUTION_OPTION_UNIT_TEST);
+
+    LBS_InstanceRequestUnlockedAsync(first, 1);
+    while (LBS_InstanceProcessOneEvent(first, EXECUTION_OPTION_UNIT_TEST))
+    {
+    }
+    CHECK_FALSE(LBS_InstanceProcessOneEvent(second, EXECUTION_OPTION_UNIT_TEST));
+
+    CHECK_EQUAL(HLCS_LOCK_STATE_UNLOCKED, LBS_InstanceGetState(first, 1));
+    CHECK_EQUAL(HLCS_LOCK_STATE_LOCKED, LBS_InstanceGetState(second, 1));
+    LBS_CountsT counts = {};
+    CHECK_TRUE(LBS_InstanceGetCounts(second, LBS_ZONE_ALL, &counts));
+    CHECK_EQUAL(2U, counts.locked);
+
+    //the default instance is untouched
+    CHECK_TRUE(LBS_GetCounts(LBS_ZONE_ALL, &counts));
+    CHECK_EQUAL(4U, counts.unknown);
+
+    LBS_Delete(first);
+    LBS_Delete(second);
+    CHECK_EQUAL(HLCS_LOCK_STATE_UNKNOWN, LBS_InstanceGetState(nullptr, 0));
+}
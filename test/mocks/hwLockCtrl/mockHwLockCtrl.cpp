@@ -23,30 +23,116 @@ SOFTWARE.
 */
 
 #include "hwLockCtrl.h"
+#include "mockHwLockCtrl.h"
 #include "CppUTestExt/MockSupport.h"
+#include <vector>
 
 static constexpr const char* MOCK_NAME = "HwLockCtrl";
 
+struct PendingCompletion
+{
+    HwLockCtrlCompletionCallback callback;
+    void* context;
+    HwLockCtrlCompletionT completion;
+};
+
+static bool s_deferCompletions = false;
+static std::vector<PendingCompletion> s_pendingCompletions;
+
+void MockHwLockCtrl_DeferCompletions(bool defer)
+{
+    s_deferCompletions = defer;
+}
+
+size_t MockHwLockCtrl_CompletePending()
+{
+    std::vector<PendingCompletion> pending;
+    pending.swap(s_pendingCompletions);
+    for (const auto& entry : pending)
+    {
+        entry.callback(entry.context, &entry.completion);
+    }
+    return pending.size();
+}
+
+static void Complete(HwLockCtrlCompletionCallback callback, void* context, const HwLockCtrlCompletionT& completion)
+{
+    if (s_deferCompletions)
+    {
+        s_pendingCompletions.push_back({ callback, context, completion });
+    }
+    else
+    {
+        callback(context, &completion);
+    }
+}
+
 bool HwLockCtrlInit()
 {
-    mock(MOCK_NAME).actualCall("Init");
-    return static_cast<bool>(mock(MOCK_NAME).returnIntValueOrDefault(true)); //use IntValue due to bug in CppUTest bool handling.
+    return HwLockCtrlInitById(HW_LOCK_CTRL_DEFAULT_LOCK_ID);
 }
 
 bool HwLockCtrlLock()
 {
-    mock(MOCK_NAME).actualCall("Lock");
-    return static_cast<bool>(mock(MOCK_NAME).returnIntValueOrDefault(true));
+    return HwLockCtrlLockById(HW_LOCK_CTRL_DEFAULT_LOCK_ID);
 }
 
 bool HwLockCtrlUnlock()
 {
-    mock(MOCK_NAME).actualCall("Unlock");
-    return static_cast<bool>(mock(MOCK_NAME).returnIntValueOrDefault(true));
+    return HwLockCtrlUnlockById(HW_LOCK_CTRL_DEFAULT_LOCK_ID);
 }
 
 bool HwLockCtrlSelfTest(HwLockCtrlSelfTestResultT* outResult)
 {
-    mock(MOCK_NAME).actualCall("SelfTest").withOutputParameter("outResult", outResult);
+    return HwLockCtrlSelfTestById(HW_LOCK_CTRL_DEFAULT_LOCK_ID, outResult);
+}
+
+bool HwLockCtrlInitById(HwLockIdT lockId)
+{
+    mock(MOCK_NAME).actualCall("Init").withUnsignedIntParameter("lockId", lockId);
+    return static_cast<bool>(mock(MOCK_NAME).returnIntValueOrDefault(true)); //use IntValue due to bug in CppUTest bool handling.
+}
+
+bool HwLockCtrlLockById(HwLockIdT lockId)
+{
+    mock(MOCK_NAME).actualCall("Lock").withUnsignedIntParameter("lockId", lockId);
+    return static_cast<bool>(mock(MOCK_NAME).returnIntValueOrDefault(true));
+}
+
+bool HwLockCtrlUnlockById(HwLockIdT lockId)
+{
+    mock(MOCK_NAME).actualCall("Unlock").withUnsignedIntParameter("lockId", lockId);
+    return static_cast<bool>(mock(MOCK_NAME).returnIntValueOrDefault(true));
+}
+
+bool HwLockCtrlSelfTestById(HwLockIdT lockId, HwLockCtrlSelfTestResultT* outResult)
+{
+    mock(MOCK_NAME).actualCall("SelfTest").withUnsignedIntParameter("lockId", lockId).withOutputParameter("outResult", outResult);
     return static_cast<bool>(mock(MOCK_NAME).returnIntValueOrDefault(true));
 }
+
+//the asynchronous operations are recorded as their synchronous
+//counterparts, so expectations do not depend on which is used.
+bool HwLockCtrlLockAsync(HwLockIdT lockId, HwLockCtrlCompletionCallback callback, void* context)
+{
+    HwLockCtrlCompletionT completion = { lockId, HW_LOCK_CTRL_OPERATION_LOCK, false, HW_LOCK_CTRL_SELF_TEST_PASSED };
+    completion.ok = HwLockCtrlLockById(lockId);
+    Complete(callback, context, completion);
+    return true;
+}
+
+bool HwLockCtrlUnlockAsync(HwLockIdT lockId, HwLockCtrlCompletionCallback callback, void* context)
+{
+    HwLockCtrlCompletionT completion = { lockId, HW_LOCK_CTRL_OPERATION_UNLOCK, false, HW_LOCK_CTRL_SELF_TEST_PASSED };
+    completion.ok = HwLockCtrlUnlockById(lockId);
+    Complete(callback, context, completion);
+    return true;
+}
+
+bool HwLockCtrlSelfTestAsync(HwLockIdT lockId, HwLockCtrlCompletionCallback callback, void* context)
+{
+    HwLockCtrlCompletionT completion = { lockId, HW_LOCK_CTRL_OPERATION_SELF_TEST, false, HW_LOCK_CTRL_SELF_TEST_FAILED_POWER };
+    completion.ok = HwLockCtrlSelfTestById(lockId, &completion.selfTestResult);
+    Complete(callback, context, completion);
+    return true;
+}
@@ -0,0 +1,46 @@
+/*
+MIT License
+
+Copyright (c) <2021> <Matthew Eshleman - https://covemountainsoftware.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @brief test controls of the mock hwLockCtrl driver. By default the
+ *        mock completes each asynchronous operation at once, from the
+ *        caller's context. Deferred, completions are held until the test
+ *        releases them, as slow hardware would.
+ */
+#ifndef ACTIVEOBJECTUNITTESTINGDEMO_MOCKHWLOCKCTRL_H
+#define ACTIVEOBJECTUNITTESTINGDEMO_MOCKHWLOCKCTRL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+void MockHwLockCtrl_DeferCompletions(bool defer);
+
+/**
+ * @brief MockHwLockCtrl_CompletePending() - call the callbacks of all
+ *        held completions, oldest first.
+ * @return the number of completions released.
+ */
+size_t MockHwLockCtrl_CompletePending();
+
+#endif //ACTIVEOBJECTUNITTESTINGDEMO_MOCKHWLOCKCTRL_H